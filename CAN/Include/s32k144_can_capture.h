@@ -0,0 +1,140 @@
+/**
+ * @file s32k144_can_capture.h
+ * @brief Bus monitor recording every received frame with its hardware timestamp.
+ *
+ * The capture installs an Rx hook that copies each frame as its message buffer image (CS word,
+ * identifier, payload words) into a circular word buffer, without passing the Rx ring. Meant for a
+ * controller in LISTEN_ONLY_MODE, which accepts every identifier and never disturbs the bus; the Rx
+ * FIFO with eDMA draining (rx_dma) gives the most headroom on a fully loaded bus. The 16-bit
+ * free-running timer is extended with marker records written when it wraps. A frame timestamp below
+ * the previous one shows a wrap; over idle gaps CAN_Capture_MainFunction samples the timer, so
+ * timestamps stay unambiguous as long as it runs at least twice per timer period (65.5 ms at 1 Mbit/s).
+ *
+ * Stream format, read out with CAN_Capture_Read: a sequence of records of 32-bit big endian words,
+ * payload bytes therefore in bus order.
+ *   word 0: CS word as received (EDL, BRS, ESI, SRR, IDE, RTR, DLC, TIMESTAMP) with the record type
+ *           CAN_CAPTURE_REC_* in the CODE field, bits 27-24
+ *   word 1: frame record: identifier, right aligned, IDE of word 0 tells the format
+ *           wrap record: timer wraps since CAN_Capture_Init, the upper half of the following timestamps
+ *           lost record: frames dropped on a full buffer right before the next record
+ *   words 2..: frame record only, ceil(length / 4) payload words, none for a remote frame
+ *
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef S32K144_CAN_CAPTURE_H
+#define S32K144_CAN_CAPTURE_H
+
+/*******************************************************************************
+ * Inclusion
+ ******************************************************************************/
+
+#include "s32k144_can_driver.h"
+
+/*******************************************************************************
+* Definitions
+******************************************************************************/
+
+#define CAN_CAPTURE_REC_FRAME     (0x0U)  /* Received frame */
+#define CAN_CAPTURE_REC_WRAP      (0x1U)  /* Free-running timer wrapped */
+#define CAN_CAPTURE_REC_LOST      (0x2U)  /* Frames dropped on a full buffer */
+
+#define CAN_CAPTURE_MIN_WORDS     (32U)   /* Smallest buffer: a 64 byte frame record plus both markers */
+#define CAN_CAPTURE_WRAP_GUARD    (1024U) /* Bit times a received frame may wait for the Rx ISR */
+
+typedef struct
+{
+    CAN_Handle_type *can_handle;
+    uint32_t *buffer;
+    uint32_t mask;              /* Buffer words - 1 */
+    volatile uint32_t head;     /* Words written, advanced by the Rx ISR */
+    volatile uint32_t tail;     /* Words read, advanced by CAN_Capture_Read */
+    uint32_t wraps;             /* Timer wraps since CAN_Capture_Init */
+    uint32_t lost_pending;      /* Dropped frames not yet reported by a lost record */
+    uint16_t last_timestamp;    /* Latest frame timestamp or timer sample, wraps show as a step below it */
+    uint8_t wrap_pending;       /* Wrap record not yet written */
+    uint32_t frames;            /* Frames stored */
+    uint32_t dropped;           /* Frames lost to a full buffer */
+    uint32_t high_water;        /* Most buffer words in use, to size the buffer for a bus */
+} CAN_Capture_type;
+
+/* Host or target side reader state of a capture stream */
+typedef struct
+{
+    uint32_t wraps;             /* From the last wrap record */
+    uint32_t lost;              /* Sum of the lost records */
+} CAN_CaptureDecoder_type;
+
+typedef struct
+{
+    uint32_t timestamp;         /* Nominal bit times, wraps << 16 | 16-bit timer value */
+    uint32_t cs;                /* CS word, record type cleared */
+    CAN_Frame_type frame;
+} CAN_CaptureFrame_type;
+
+/*******************************************************************************
+* API
+******************************************************************************/
+
+/**
+ * @brief Starts recording every frame received by a controller.
+ *
+ * Installs the capture Rx hook (replacing any other hooks): frames no longer enter the Rx ring.
+ *
+ * @param[out] capture Capture state, must stay valid while the hook is installed.
+ * @param[in] can_handle Initialised controller, normally in LISTEN_ONLY_MODE.
+ * @param[in] buffer Record storage, e.g. a large array in SRAM_U.
+ * @param[in] num_words Buffer size, a power of two of at least CAN_CAPTURE_MIN_WORDS.
+ * @return Std_CAN_Status CAN_E_OK if successful, CAN_E_NOT_OK if the buffer size is not usable.
+ */
+Std_CAN_Status CAN_Capture_Init(CAN_Capture_type* capture, CAN_Handle_type* can_handle, uint32_t* buffer, uint32_t num_words);
+
+/**
+ * @brief Stops recording, received frames go to the Rx ring again. Records still buffered can be read.
+ *
+ * @param[in] capture Capture state.
+ */
+void CAN_Capture_DeInit(CAN_Capture_type* capture);
+
+/**
+ * @brief Counts timer wraps while no frame arrives.
+ *
+ * Call it periodically from task context, at least twice per timer period of 65536 nominal bit times,
+ * e.g. every 10 ms. Within CAN_CAPTURE_WRAP_GUARD bit times after a wrap a sample is skipped, as a frame
+ * received just before the wrap may still wait for the Rx ISR.
+ *
+ * @param[in] capture Capture state.
+ */
+void CAN_Capture_MainFunction(CAN_Capture_type* capture);
+
+/**
+ * @brief Moves whole records from the capture buffer to a stream, oldest first.
+ *
+ * Single consumer: call it from one context only. Running concurrently with the Rx ISR is safe.
+ *
+ * @param[in] capture Capture state.
+ * @param[out] stream Destination bytes, e.g. a UART, USB or flash page buffer.
+ * @param[in] size Bytes available in stream.
+ * @return uint32_t Bytes written, a multiple of 4.
+ */
+uint32_t CAN_Capture_Read(CAN_Capture_type* capture, uint8_t* stream, uint32_t size);
+
+/**
+ * @brief Decodes the next frame record of a stream, applying the marker records before it.
+ *
+ * @param[in,out] decoder Reader state, zeroed at the start of the stream.
+ * @param[in] stream Stream bytes produced by CAN_Capture_Read.
+ * @param[in] size Bytes in stream.
+ * @param[in,out] offset Position in stream, advanced past every record consumed.
+ * @param[out] frame Decoded frame.
+ * @return Std_CAN_Status CAN_E_OK if a frame was decoded, CAN_E_NOT_OK if no complete frame record
+ *         is left (the remaining bytes start at offset).
+ */
+Std_CAN_Status CAN_Capture_Decode(CAN_CaptureDecoder_type* decoder, const uint8_t* stream, uint32_t size,
+                                  uint32_t* offset, CAN_CaptureFrame_type* frame);
+
+#endif /* S32K144_CAN_CAPTURE_H */
@@ -0,0 +1,151 @@
+/**
+ * @file s32k144_can_codec.h
+ * @brief Signal packing and unpacking compiled from a DBC-like message description table.
+ *
+ * CAN_Codec_Compile turns each signal into a word index, shift, mask and access kind once, so
+ * unpacking reads every payload word a single time and extracts each signal with one or two
+ * shifts on 32 bit message buffer words instead of walking its bytes.
+ *
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef S32K144_CAN_CODEC_H
+#define S32K144_CAN_CODEC_H
+
+/*******************************************************************************
+ * Inclusion
+ ******************************************************************************/
+
+#include "s32k144_can_driver.h"
+
+/*******************************************************************************
+* Definitions
+******************************************************************************/
+
+#ifndef CAN_CODEC_MAX_SIGNALS
+#define CAN_CODEC_MAX_SIGNALS (64U) /* Signals of one message */
+#endif
+
+#define CAN_CODEC_MAX_WORDS   (CAN_MAX_PAYLOAD_BYTES / 4U)
+
+/* Byte order of a signal, as @1 / @0 in a DBC file */
+typedef enum
+{
+    CAN_SIGNAL_INTEL,    /* Little endian, start_bit is the LSB */
+    CAN_SIGNAL_MOTOROLA  /* Big endian, start_bit is the MSB in DBC (sawtooth) numbering */
+} CAN_SIGNAL_ORDER_type;
+
+typedef struct
+{
+    uint16_t start_bit;  /* Bit k of payload byte b is 8 * b + k */
+    uint8_t length;      /* 1-32 bits */
+    uint8_t byte_order;  /* CAN_SIGNAL_ORDER_type */
+    uint8_t is_signed;   /* Two's complement raw value */
+    float factor;        /* physical = raw * factor + offset */
+    float offset;
+} CAN_SignalDesc_type;
+
+typedef struct
+{
+    uint32_t id;
+    uint8_t length;                       /* Payload bytes */
+    const CAN_SignalDesc_type *signals;
+    uint8_t num_signals;                  /* At most CAN_CODEC_MAX_SIGNALS */
+} CAN_MessageDesc_type;
+
+/* One compiled signal: (window >> shift) & mask, the window being one or two big or little endian words */
+typedef struct
+{
+    uint8_t word;        /* First payload word of the window */
+    uint8_t shift;
+    uint8_t kind;        /* Access kind, private to s32k144_can_codec.c */
+    uint8_t is_signed;   /* Two's complement raw value */
+    uint8_t sign_shift;  /* 32 - length for signed signals, 0 otherwise (also for signed 32 bit signals) */
+    uint32_t mask;
+    float factor;
+    float offset;
+    float inv_factor;    /* 1 / factor for packing */
+} CAN_SignalPlan_type;
+
+typedef struct
+{
+    CAN_SignalPlan_type signals[CAN_CODEC_MAX_SIGNALS];
+    uint8_t num_signals;
+    uint8_t num_words;   /* Payload words read or written */
+    uint8_t has_intel;   /* Little endian windows are needed */
+} CAN_CodecPlan_type;
+
+/*******************************************************************************
+* API
+******************************************************************************/
+
+/**
+ * @brief Checks a message description and computes the access plan of every signal.
+ *
+ * @param[in] message Message description, referenced only during the call.
+ * @param[out] plan Compiled message.
+ * @return Std_CAN_Status CAN_E_OK if successful, CAN_E_NOT_OK if a signal lies outside the payload,
+ *         is longer than 32 bits, has a zero factor or there are too many signals.
+ */
+Std_CAN_Status CAN_Codec_Compile(const CAN_MessageDesc_type* message, CAN_CodecPlan_type* plan);
+
+/**
+ * @brief Converts payload bytes into message buffer words (byte 0 in bits 31-24).
+ *
+ * @param[in] data Payload, e.g. CAN_Frame_type.data.
+ * @param[in] length Payload bytes, the last word is zero filled.
+ * @param[out] words (length + 3) / 4 words.
+ */
+void CAN_Codec_LoadWords(const uint8_t* data, uint8_t length, uint32_t* words);
+
+/**
+ * @brief Converts message buffer words back into payload bytes, e.g. for CAN_Transmit.
+ *
+ * @param[in] words Payload words.
+ * @param[in] length Payload bytes.
+ * @param[out] data Payload, a multiple of 4 bytes is written.
+ */
+void CAN_Codec_StoreWords(const uint32_t* words, uint8_t length, uint8_t* data);
+
+/**
+ * @brief Extracts the raw value of every signal.
+ *
+ * @param[in] plan Compiled message.
+ * @param[in] words Payload words in message buffer layout, e.g. CAN_MsgView_type.words or CAN_Codec_LoadWords output.
+ * @param[out] raw num_signals raw values, signed signals sign-extended to 32 bits.
+ */
+void CAN_Codec_UnpackRaw(const CAN_CodecPlan_type* plan, const volatile uint32_t* words, uint32_t* raw);
+
+/**
+ * @brief Extracts the physical value (raw * factor + offset) of every signal.
+ *
+ * @param[in] plan Compiled message.
+ * @param[in] words Payload words in message buffer layout.
+ * @param[out] values num_signals physical values.
+ */
+void CAN_Codec_Unpack(const CAN_CodecPlan_type* plan, const volatile uint32_t* words, float* values);
+
+/**
+ * @brief Inserts the raw value of every signal; bits outside the signals are kept.
+ *
+ * @param[in] plan Compiled message.
+ * @param[in] raw num_signals raw values, truncated to the signal length.
+ * @param[in][out] words Payload words in message buffer layout.
+ */
+void CAN_Codec_PackRaw(const CAN_CodecPlan_type* plan, const uint32_t* raw, uint32_t* words);
+
+/**
+ * @brief Inserts the physical value of every signal, rounded to the nearest raw value and saturated
+ *        to the signal range; bits outside the signals are kept.
+ *
+ * @param[in] plan Compiled message.
+ * @param[in] values num_signals physical values.
+ * @param[in][out] words Payload words in message buffer layout.
+ */
+void CAN_Codec_Pack(const CAN_CodecPlan_type* plan, const float* values, uint32_t* words);
+
+#endif /* S32K144_CAN_CODEC_H */
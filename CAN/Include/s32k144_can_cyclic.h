@@ -0,0 +1,121 @@
+/**
+ * @file s32k144_can_cyclic.h
+ * @brief Table driven transmission of periodic frames with spread release offsets.
+ *
+ * Every message is released at offset + n x period on the free-running microsecond time passed to
+ * CAN_Cyclic_MainFunction, carrying the payload last given to CAN_Cyclic_Update. Messages with
+ * CAN_CYCLIC_AUTO_OFFSET get the offset on the tick grid that keeps the most loaded tick of the
+ * hyperperiod lowest, so messages whose periods line up are not released in the same tick.
+ * Releases go through CAN_TransmitLatest: an instance still waiting in the Tx queue takes the new
+ * payload instead of a second frame being queued behind it.
+ *
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef S32K144_CAN_CYCLIC_H
+#define S32K144_CAN_CYCLIC_H
+
+/*******************************************************************************
+ * Inclusion
+ ******************************************************************************/
+
+#include "s32k144_can_driver.h"
+
+/*******************************************************************************
+* Definitions
+******************************************************************************/
+
+#ifndef CAN_CYCLIC_MAX_MESSAGES
+#define CAN_CYCLIC_MAX_MESSAGES (32U)   /* Messages per CAN_Cyclic_type */
+#endif
+
+#ifndef CAN_CYCLIC_MAX_SLOTS
+#define CAN_CYCLIC_MAX_SLOTS    (1000U) /* Ticks of the longest hyperperiod the offset spreading plans */
+#endif
+
+#define CAN_CYCLIC_AUTO_OFFSET  (0xFFFFFFFFU)
+
+typedef struct
+{
+    uint32_t id;             /* Standard identifier */
+    uint8_t dlc;
+    uint8_t priority;        /* Tx local priority 0-7, see CAN_Frame_type */
+    uint32_t period_us;      /* Multiple of the tick */
+    uint32_t offset_us;      /* First release after CAN_Cyclic_Init, below period_us, or CAN_CYCLIC_AUTO_OFFSET */
+} CAN_CyclicMsgConfig_type;
+
+typedef struct
+{
+    const CAN_CyclicMsgConfig_type *config;
+    uint32_t offset_us;      /* Offset in use, chosen by CAN_Cyclic_Init for CAN_CYCLIC_AUTO_OFFSET */
+    uint32_t next_us;        /* Next release time */
+    uint8_t data[CAN_MAX_PAYLOAD_BYTES]; /* Latest payload */
+    uint32_t releases;       /* Frames handed to the driver, merges included */
+    uint32_t replaced;       /* Releases merged into the previous instance still queued: it missed its period */
+    uint32_t skipped;        /* Releases lost because CAN_Cyclic_MainFunction ran a whole period late */
+    uint32_t rejected;       /* Releases refused by a full Tx queue */
+} CAN_CyclicMsg_type;
+
+typedef struct
+{
+    CAN_Handle_type *can_handle;
+    const CAN_CyclicMsgConfig_type *messages;
+    uint8_t num_messages;    /* At most CAN_CYCLIC_MAX_MESSAGES */
+    uint32_t tick_us;        /* Offset grid of the spreading, e.g. 1000 */
+} CAN_Cyclic_Config_type;
+
+typedef struct
+{
+    CAN_Handle_type *can_handle;
+    CAN_CyclicMsg_type messages[CAN_CYCLIC_MAX_MESSAGES];
+    uint8_t num_messages;
+    uint16_t peak_slot_bits; /* Nominal bits released in the most loaded tick of the planned hyperperiod */
+} CAN_Cyclic_type;
+
+/*******************************************************************************
+* API
+******************************************************************************/
+
+/**
+ * @brief Checks the message table, spreads the automatic offsets and schedules the first releases.
+ *
+ * The spreading places messages by increasing period, each at the offset whose ticks over the
+ * hyperperiod carry the fewest nominal bits so far (fixed offsets are placed first). Payloads
+ * start zeroed.
+ *
+ * @param[out] cyclic Scheduler state.
+ * @param[in] config Controller, message table and tick. The table is referenced, not copied.
+ * @param[in] now_us Free-running microsecond time, the offsets count from it.
+ * @return Std_CAN_Status CAN_E_OK if successful, CAN_E_NOT_OK if a period is not a multiple of the
+ *         tick, an offset is not below its period, the hyperperiod exceeds CAN_CYCLIC_MAX_SLOTS ticks
+ *         or there are too many messages.
+ */
+Std_CAN_Status CAN_Cyclic_Init(CAN_Cyclic_type* cyclic, const CAN_Cyclic_Config_type* config, uint32_t now_us);
+
+/**
+ * @brief Sets the payload of the next releases of a message.
+ *
+ * Call it from the context that runs CAN_Cyclic_MainFunction, or with it held off.
+ *
+ * @param[in] cyclic Scheduler state.
+ * @param[in] msg Message index.
+ * @param[in] data Payload, CAN_DlcToLength(dlc) bytes.
+ * @return Std_CAN_Status CAN_E_OK if successful, CAN_E_NOT_OK if msg is out of range.
+ */
+Std_CAN_Status CAN_Cyclic_Update(CAN_Cyclic_type* cyclic, uint8_t msg, const uint8_t* data);
+
+/**
+ * @brief Releases every message that is due.
+ *
+ * Call it at least once per tick; the release jitter is the call period plus the wait for the bus.
+ *
+ * @param[in] cyclic Scheduler state.
+ * @param[in] now_us Free-running microsecond time, wrapping at 2^32.
+ */
+void CAN_Cyclic_MainFunction(CAN_Cyclic_type* cyclic, uint32_t now_us);
+
+#endif /* S32K144_CAN_CYCLIC_H */
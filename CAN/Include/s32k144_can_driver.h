@@ -1,3 +1,6 @@
+#ifndef S32K144_CAN_DRIVER_H
+#define S32K144_CAN_DRIVER_H
+
 #include "S32K144.h"
 
 #define fCANCLK (8000000U)
@@ -6,6 +9,167 @@
 #define CAN_WMBn_CS_STD_ID_SHIFT (18U)
 
 #define MSG_BUF_SIZE  (4U) /* Msg Buffer Size. (CAN 2.0AB: 2 hdr +  2 data= 4 words) */
+
+#define CAN_INSTANCE_COUNT    (3U)  /* CAN0, CAN1, CAN2 */
+#define CAN0_MB_COUNT         (32U) /* Message buffers (4 words each at 8 bytes payload) of CAN0 */
+#define CAN1_MB_COUNT         (16U) /* Message buffers of CAN1 */
+#define CAN2_MB_COUNT         (16U) /* Message buffers of CAN2 */
+#define CAN_MAX_PAYLOAD_BYTES (64U) /* Largest CAN FD payload */
+
+#define CAN_FD_PADDING_BYTE   (0x00U) /* Fills the payload up to the DLC length */
+
+#define CAN_MAX_MSG_BUFF      (32U)  /* MBs covered by IMASK1/IFLAG1 */
+#define CAN_MB_REGION_WORDS   (128U) /* One 512-byte RAM block per FDCTRL[MBDSRn] field */
+#ifdef CAN_FDCTRL_MBDSR1_MASK
+#define CAN_MB_REGION_COUNT   (2U)
+#else
+#define CAN_MB_REGION_COUNT   (1U)   /* S32K144: the whole MB RAM is one block sized by MBDSR0 */
+#endif
+
+/* Rx FIFO eDMA requests (DMAMUX CHCFG[SOURCE]) */
+#define CAN0_DMA_REQUEST      (54U)
+#define CAN1_DMA_REQUEST      (55U)
+#define CAN2_DMA_REQUEST      (56U)
+#define CAN_DMA_CHANNEL_COUNT (16U)
+#define CAN_DMA_MAX_FRAMES    (0x7FFFU) /* TCD CITER/BITER range */
+
+#ifdef CAN_SIM
+/* Host build: CAN0-2, eDMA and DMAMUX are RAM models on the virtual bus of s32k144_can_sim.c */
+extern CAN_Type CAN_Sim_regs[CAN_INSTANCE_COUNT];
+extern DMA_Type CAN_Sim_dma;
+extern DMAMUX_Type CAN_Sim_dmamux;
+#undef CAN0
+#undef CAN1
+#undef CAN2
+#undef DMA
+#undef DMAMUX
+#define CAN0 (&CAN_Sim_regs[0])
+#define CAN1 (&CAN_Sim_regs[1])
+#define CAN2 (&CAN_Sim_regs[2])
+#define DMA    (&CAN_Sim_dma)
+#define DMAMUX (&CAN_Sim_dmamux)
+
+/* Called by the driver where the hardware would change a register on its own */
+void CAN_Sim_Poll(CAN_Type* can_instance);
+void CAN_Sim_ClearFlags(CAN_Type* can_instance, uint32_t mask);
+uint32_t CAN_Sim_CriticalEnter(void);
+void CAN_Sim_CriticalExit(uint32_t primask);
+
+/* Payload copy kernels of the driver, timed by CAN_Sim_CopyBenchmark */
+void CAN_Sim_WritePayload(volatile uint32_t* mb_data, const uint8_t* data, uint8_t num_words);
+void CAN_Sim_ReadPayload(const volatile uint32_t* mb_data, uint8_t* data, uint8_t num_words);
+#endif
+
+/* Critical section around the Tx queues. A gateway forwards from the Rx ISR of one controller into the
+   queue of another, so masking the MB interrupts of a single controller does not keep it out: PRIMASK does */
+#ifdef CAN_SIM
+#define CAN_CRITICAL_ENTER()       CAN_Sim_CriticalEnter()
+#define CAN_CRITICAL_EXIT(primask) CAN_Sim_CriticalExit(primask)
+#elif defined(__GNUC__) || defined(__ICCARM__)
+static inline uint32_t CAN_CriticalEnter(void)
+{
+    uint32_t primask;
+    __asm volatile ("mrs %0, primask\n\tcpsid i" : "=r" (primask) :: "memory");
+    return primask;
+}
+
+static inline void CAN_CriticalExit(uint32_t primask)
+{
+    __asm volatile ("msr primask, %0" :: "r" (primask) : "memory");
+}
+#define CAN_CRITICAL_ENTER()       CAN_CriticalEnter()
+#define CAN_CRITICAL_EXIT(primask) CAN_CriticalExit(primask)
+#else
+#error "CAN_CRITICAL_ENTER/CAN_CRITICAL_EXIT need PRIMASK access for this compiler"
+#endif
+
+#ifndef CAN_RX_RING_SIZE
+#define CAN_RX_RING_SIZE      (16U) /* Rx frames buffered per controller, must be a power of two */
+#endif
+
+#ifndef CAN_TX_QUEUE_SIZE
+#define CAN_TX_QUEUE_SIZE     (16U) /* Tx frames queued per controller, at most 255 */
+#endif
+
+#ifndef CAN_TX_LIMIT_MAX_CLASSES
+#define CAN_TX_LIMIT_MAX_CLASSES (4U) /* Tx rate limit classes per controller */
+#endif
+#define CAN_TX_LIMIT_MAX_BURST   (4000000U) /* Deepest Tx rate limit bucket in bit times */
+
+#ifdef CAN_STATS_ENABLE
+#ifndef CAN_STATS_MAX_IDS
+#define CAN_STATS_MAX_IDS     (16U) /* Identifiers with own counters per controller, later ones count as untracked */
+#endif
+#define CAN_STATS_LATENCY_BUCKETS (8U)          /* Bucket 0: < 128 bit times, then doubling, last: >= 8192 */
+#define CAN_STATS_ID_EXT_FLAG     (0x80000000U) /* Set in CAN_IdStats_type::id for extended identifiers */
+#endif
+
+/* Bit timing limits (CBT/FDCBT field ranges) */
+#define CAN_MAX_PRESCALER        (1024U)
+#define CAN_MIN_NOMINAL_TQ       (8U)
+#define CAN_MAX_NOMINAL_TQ       (129U)     /* 1 + 64 + 32 + 32 */
+#define CAN_MIN_DATA_TQ          (5U)
+#define CAN_MAX_DATA_TQ          (48U)      /* 1 + 31 + 8 + 8 */
+#define CAN_TDC_MIN_BIT_RATE     (1000000U) /* Data rates above this use transceiver delay compensation */
+#define CAN_TDC_MAX_PRESCALER    (2U)
+#define CAN_TDC_MAX_OFFSET       (31U)
+
+/* Compile time bit timing: bit rate and sample point (0.1 %) of a segment set */
+#define CAN_TIMING_BIT_RATE(clock_hz, prescaler, prop_seg, phase_seg1, phase_seg2) \
+    ((clock_hz) / ((prescaler) * (1U + (prop_seg) + (phase_seg1) + (phase_seg2))))
+#define CAN_TIMING_SAMPLE_POINT(prop_seg, phase_seg1, phase_seg2) \
+    ((1000U * (1U + (prop_seg) + (phase_seg1))) / (1U + (prop_seg) + (phase_seg1) + (phase_seg2)))
+#define CAN_BIT_TIMING_INIT(prescaler, prop_seg, phase_seg1, phase_seg2, rjw, \
+                            d_prop_seg, d_phase_seg1, d_phase_seg2, d_rjw, tdc_offset) \
+    { { (prescaler), (prop_seg), (phase_seg1), (phase_seg2), (rjw) },         \
+      { (prescaler), (d_prop_seg), (d_phase_seg1), (d_phase_seg2), (d_rjw) }, \
+      (tdc_offset), 0U, 0U }
+
+/* Message buffer CS word */
+#define CAN_MB_CS_EDL_MASK       (0x80000000U)
+#define CAN_MB_CS_BRS_MASK       (0x40000000U)
+#define CAN_MB_CS_ESI_MASK       (0x20000000U)
+#define CAN_MB_CS_CODE_MASK      (0x0F000000U)
+#define CAN_MB_CS_CODE_SHIFT     (24U)
+#define CAN_MB_CS_SRR_MASK       (0x00400000U)
+#define CAN_MB_CS_IDE_MASK       (0x00200000U)
+#define CAN_MB_CS_RTR_MASK       (0x00100000U)
+#define CAN_MB_CS_DLC_MASK       (0x000F0000U)
+#define CAN_MB_CS_DLC_SHIFT      (16U)
+#define CAN_MB_CS_TIMESTAMP_MASK (0x0000FFFFU)
+
+/* Message buffer ID word */
+#define CAN_MB_ID_PRIO_SHIFT     (29U)          /* Local priority, used with MCR[LPRIO_EN] */
+#define CAN_MB_ID_STD_MASK       (0x1FFC0000U)
+#define CAN_MB_ID_EXT_MASK       (0x1FFFFFFFU)
+
+/* Legacy Rx FIFO */
+#define CAN_RX_FIFO_MB_COUNT           (6U)          /* MB0-5 are taken by the FIFO engine */
+#define CAN_RX_FIFO_FILTER_PER_RFFN    (8U)          /* ID filter elements per CTRL2[RFFN] step */
+#define CAN_RX_FIFO_ID_IDE_MASK        (0x40000000U) /* Format A filter element fields */
+#define CAN_RX_FIFO_ID_STD_MASK        (0x3FF80000U)
+#define CAN_RX_FIFO_ID_STD_SHIFT       (19U)
+#define CAN_RX_FIFO_ID_EXT_MASK        (0x3FFFFFFEU)
+#define CAN_RX_FIFO_ID_EXT_SHIFT       (1U)
+#define CAN_IFLAG1_BUF5I_MASK          (0x00000020U) /* Frames available in Rx FIFO */
+#define CAN_IFLAG1_BUF6I_MASK          (0x00000040U) /* Rx FIFO warning (5 frames stored) */
+#define CAN_IFLAG1_BUF7I_MASK          (0x00000080U) /* Rx FIFO overflow */
+#define CAN_IFLAG1_RX_FIFO_MASK        (CAN_IFLAG1_BUF5I_MASK | CAN_IFLAG1_BUF6I_MASK | CAN_IFLAG1_BUF7I_MASK)
+
+/* Message buffer codes */
+#define CAN_MB_CODE_RX_EMPTY     (0x4U)
+#define CAN_MB_CODE_RX_OVERRUN   (0x6U)
+#define CAN_MB_CODE_TX_INACTIVE  (0x8U)
+#define CAN_MB_CODE_TX_DATA      (0xCU)
+#define CAN_MB_CODE_TX_ABORT     (0x9U)
+#define CAN_MB_CODE_TX_RANSWER   (0xAU)         /* Remote answer: a matching remote request is answered by hardware */
+
+/* CAN_Frame_type flags. IDE and RTR select the transmitted format, all of them are reported on reception */
+#define CAN_FRAME_FLAG_IDE       (0x01U)        /* Extended 29-bit identifier */
+#define CAN_FRAME_FLAG_RTR       (0x02U)        /* Remote frame: CAN 2.0 format, DLC without payload */
+#define CAN_FRAME_FLAG_EDL       (0x04U)        /* CAN FD frame, Tx format follows the controller */
+#define CAN_FRAME_FLAG_BRS       (0x08U)        /* Data phase at the data bit rate, Tx follows the controller */
+#define CAN_FRAME_FLAG_ESI       (0x10U)        /* Transmitter was error passive */
 typedef enum
 {
     CAN_E_OK,    /* Successful */
@@ -42,14 +206,47 @@ typedef enum
     DISBALE_BRS
 } CAN_BIT_RATE_SW_type;
 
+/* Segments of one bit phase, in time quanta */
+typedef struct
+{
+    uint16_t prescaler;  /* CAN clock cycles per time quantum (1..1024) */
+    uint8_t prop_seg;
+    uint8_t phase_seg1;
+    uint8_t phase_seg2;
+    uint8_t rjw;
+} CAN_Phase_Timing_type;
+
+/* Register-ready timing of both phases. Can be written as a constant with CAN_BIT_TIMING_INIT */
+typedef struct
+{
+    CAN_Phase_Timing_type nominal;
+    CAN_Phase_Timing_type data;
+    uint8_t tdc_offset;         /* FDCTRL[TDCOFF] in CAN clock cycles, 0 keeps TDC disabled */
+    uint32_t nominal_error_ppm; /* Bit rate error of the nominal phase */
+    uint32_t data_error_ppm;    /* Bit rate error of the data phase */
+} CAN_Bit_Timing_Result_type;
+
 typedef struct
 {
     uint32_t nominal_bit_Rate;
     uint32_t data_bit_rate;
-    uint8_t time_quanta;
-    uint8_t samp_point;
+    uint8_t time_quanta;      /* Nominal time quanta per bit, 0 lets the solver choose */
+    uint8_t samp_point;       /* Nominal sample point in percent, 0 selects 80 % */
+    uint8_t data_samp_point;  /* Data phase sample point in percent, 0 selects 75 % */
+    const CAN_Bit_Timing_Result_type *fixed_timing; /* Used as is when not NULL, skipping the solver */
 } CAN_Bit_Timing_type;
 
+/* Solver limits of one phase, in time quanta */
+typedef struct
+{
+    uint8_t min_prop_seg;
+    uint8_t max_prop_seg;
+    uint8_t max_phase_seg1;
+    uint8_t min_phase_seg2;
+    uint8_t max_phase_seg2;
+    uint8_t max_rjw;
+} CAN_Phase_Limit_type;
+
 typedef enum
 {
     PAYLOAD_8_BYTES,
@@ -64,6 +261,125 @@ typedef enum
     STARDADARD_ID
 } CAN_ID_TYPE_type;
 
+typedef enum
+{
+    DISABLE_RX_FIFO,
+    ENABLE_RX_FIFO
+} CAN_RX_FIFO_type;
+
+typedef enum
+{
+    DISABLE_RX_ZERO_COPY, /* Rx ISR copies frames into the Rx ring */
+    ENABLE_RX_ZERO_COPY   /* Rx MBs stay in place for CAN_PeekMsgBuff, their interrupts are masked */
+} CAN_RX_ZERO_COPY_type;
+
+typedef enum
+{
+    DISABLE_RX_DMA,
+    ENABLE_RX_DMA         /* Rx FIFO frames are moved by eDMA (MCR[DMA]), the CPU is woken per watermark */
+} CAN_RX_DMA_type;
+
+/* Rx FIFO output as copied by eDMA: CS, ID and two payload words (byte 0 in bits 31-24) */
+typedef struct
+{
+    uint32_t cs;
+    uint32_t id;
+    uint32_t data[2];
+} CAN_DmaFrame_type;
+
+/* Fault confinement state (ESR1[FLTCONF]) */
+typedef enum
+{
+    ERROR_ACTIVE,
+    ERROR_PASSIVE,
+    BUS_OFF
+} CAN_ERROR_STATE_type;
+
+typedef enum
+{
+    STANDARD_RECOVERY, /* Controller rejoins after 128 occurrences of 11 recessive bits (ISO 11898-1) */
+    FAST_RECOVERY      /* Error counters cleared in freeze mode by CAN_ErrorMainFunction, rejoins after 11 recessive bits */
+} CAN_BUSOFF_RECOVERY_type;
+
+typedef enum
+{
+    KEEP_TX_QUEUE,     /* Pending frames are sent after the recovery */
+    FLUSH_TX_QUEUE     /* Pending frames are dropped at bus off */
+} CAN_BUSOFF_TX_type;
+
+typedef enum
+{
+    TX_LIMIT_DEFER,    /* Refused with CAN_E_NOT_OK: the sender keeps the frame and retries later */
+    TX_LIMIT_DROP      /* Discarded but reported as CAN_E_OK: the sender is never held up */
+} CAN_TX_LIMIT_POLICY_type;
+
+typedef struct CAN_Handle CAN_Handle_type;
+
+/* Called on every fault confinement state change, esr1 as last read. From the error interrupt, or from
+   CAN_ErrorMainFunction when a fast bus off recovery completes */
+typedef void (*CAN_ErrorCallback_type)(CAN_Handle_type* can_handle, uint8_t error_state, uint32_t esr1);
+
+typedef struct
+{
+    uint8_t state;          /* CAN_ERROR_STATE_type */
+    uint8_t tx_error_count; /* ECR[TXERRCNT] */
+    uint8_t rx_error_count; /* ECR[RXERRCNT] */
+    uint32_t error_frames;  /* ESR1[ERRINT] and ESR1[ERRINT_FAST] events */
+    uint32_t bus_off_count;
+    uint32_t last_errors;   /* ESR1 error bits (STFERR..BIT1ERR and their FAST twins) of the last error */
+} CAN_ErrorStatus_type;
+
+/* Pretended Networking filter combination (CTRL1_PN[FCS]) */
+typedef enum
+{
+    PN_ID_ONLY,                /* Wake on the first frame whose ID matches */
+    PN_ID_AND_PAYLOAD,         /* Wake on the first frame whose ID, DLC and payload match */
+    PN_ID_ONLY_NMATCH,         /* Wake after num_matches frames with matching ID */
+    PN_ID_AND_PAYLOAD_NMATCH   /* Wake after num_matches frames with matching ID, DLC and payload */
+} CAN_PN_FILTER_type;
+
+/* Pretended Networking comparison of the ID and of the payload (CTRL1_PN[IDFS] / [PLFS]) */
+typedef enum
+{
+    PN_MATCH_EXACT,            /* (value & mask) == (value1 & mask), mask given as value2 */
+    PN_MATCH_GREATER_EQUAL,    /* value >= value1 */
+    PN_MATCH_SMALLER_EQUAL,    /* value <= value1 */
+    PN_MATCH_RANGE             /* value1 <= value <= value2 */
+} CAN_PN_MATCH_type;
+
+/* Wake-up filter applied by CAN0 while the MCU is in Stop mode */
+typedef struct
+{
+    uint8_t filter;            /* CAN_PN_FILTER_type */
+    uint8_t id_match;          /* CAN_PN_MATCH_type */
+    uint8_t payload_match;     /* CAN_PN_MATCH_type, used by the _AND_PAYLOAD filters */
+    uint8_t id_type;           /* CAN_ID_TYPE_type of the wake-up frames */
+    uint8_t num_matches;       /* Matching frames needed by the _NMATCH filters, 1-255 */
+    uint16_t match_timeout;    /* Also wake after 64 x match_timeout bit times without a match, 0: never */
+    uint32_t id1;              /* Identifier, or lower bound */
+    uint32_t id2;              /* Identifier mask for PN_MATCH_EXACT, upper bound for PN_MATCH_RANGE */
+    uint8_t dlc_low;           /* Payload filters only accept DLC in [dlc_low, dlc_high] */
+    uint8_t dlc_high;
+    uint8_t payload1[8];       /* Payload, or lower bound, byte 0 most significant */
+    uint8_t payload2[8];       /* Payload mask for PN_MATCH_EXACT, upper bound for PN_MATCH_RANGE */
+} CAN_PN_Config_type;
+
+/* Message buffers the application needs at each payload size, indexed by CAN_PAYLOAD_type */
+typedef struct
+{
+    uint8_t num_rx[4];
+    uint8_t num_tx[4];
+} CAN_MsgBuffLayout_type;
+
+/* Placement of the message buffers in the MB RAM */
+typedef struct
+{
+    uint8_t region_payload[CAN_MB_REGION_COUNT]; /* CAN_PAYLOAD_type written to FDCTRL[MBDSRn] */
+    uint8_t mb_words[CAN_MAX_MSG_BUFF];          /* Words of each MB (2 header words + payload) */
+    uint16_t mb_base[CAN_MAX_MSG_BUFF];          /* First RAMn word of each MB */
+    uint32_t payload_mb_mask[4];                 /* MBs holding at least each CAN_PAYLOAD_type */
+} CAN_MsgBuffMap_type;
+
 typedef struct {
     CAN_Type *can_instance;
     uint8_t operate_mode;
@@ -75,8 +391,619 @@ typedef struct {
     uint32_t rx_identifier;
     uint8_t payload;
     uint8_t id_type;
+    uint8_t rx_fifo;            /* CAN_RX_FIFO_type, CAN 2.0 only. Rx FIFO replaces the Rx MBs, remaining MBs transmit */
+    uint8_t rx_fifo_filter_num; /* CTRL2[RFFN]: 8 * (rx_fifo_filter_num + 1) ID filter elements */
+    const CAN_MsgBuffLayout_type *mb_layout; /* NULL: every MB sized by payload, lower half Rx. Not with rx_fifo */
+    uint8_t busoff_recovery;    /* CAN_BUSOFF_RECOVERY_type */
+    uint8_t busoff_tx;          /* CAN_BUSOFF_TX_type */
+    CAN_ErrorCallback_type error_callback; /* NULL: state changes are only recorded */
+    uint8_t rx_zero_copy;       /* CAN_RX_ZERO_COPY_type */
+    uint8_t rx_dma;             /* CAN_RX_DMA_type, needs ENABLE_RX_FIFO and not zero copy */
+    uint8_t rx_dma_channel;     /* eDMA channel, its DMAn_IRQHandler must call CAN_DmaIRQHandler */
+    uint16_t rx_dma_watermark;  /* Frames per CPU wake-up */
+    CAN_DmaFrame_type *rx_dma_buffer; /* Circular buffer of 2 x rx_dma_watermark frames */
+    const CAN_PN_Config_type *pn_config; /* Wake-up filter of PRETENDED_NETWORK_MODE, CAN0 only */
 } CAN_Config_type;
 
-Std_CAN_Status CAN_Init(CAN_Config_type* can_config);
-void CAN_transmit_msg(CAN_Type* CAN_instance,uint32_t id, uint8_t* data_buff);
-void CAN_receive_msg(CAN_Type* CAN_instance, uint8_t *rx_buff, uint16_t length_buff);
+/* Settings CAN_Reconfigure changes at runtime. The frame format, MB layout and filters stay as set up */
+typedef struct {
+    uint8_t operate_mode;       /* NORMAL_MODE, LOOP_BACK_MODE or LISTEN_ONLY_MODE */
+    CAN_Bit_Timing_type *bit_rate_config; /* NULL keeps the bit timing. fixed_timing skips the solver */
+    uint8_t bit_rate_sw;        /* ENABLE_BRS or DISBALE_BRS, ignored in CAN 2.0 mode */
+} CAN_Reconfig_type;
+
+typedef struct
+{
+    uint32_t id;                           /* Standard or extended identifier */
+    uint8_t data[CAN_MAX_PAYLOAD_BYTES];   /* Payload, word aligned for the word-wise MB copy */
+    uint16_t timestamp;                    /* Free-running timer value at reception */
+    uint8_t dlc;                           /* Data length code */
+    uint8_t priority;                      /* Tx local priority 0-7, 0 first. Ranks above the ID inside the controller */
+    uint8_t flags;                         /* CAN_FRAME_FLAG_* */
+} CAN_Frame_type;
+
+/* Locked Rx message buffer handed out by CAN_PeekMsgBuff, valid until CAN_ReleaseMsgBuff */
+typedef struct
+{
+    const volatile uint32_t* words; /* Payload words in the MB RAM, byte 0 in bits 31-24 */
+    uint32_t id;                    /* Standard or extended identifier */
+    uint32_t cs;                    /* CS word read when locking */
+    uint16_t timestamp;             /* Free-running timer value at reception */
+    uint8_t dlc;
+    uint8_t length;                 /* Payload bytes, CAN_DlcToLength(dlc), 0 for a remote frame */
+    uint8_t idx_mb;                 /* Locked message buffer, 0 for the Rx FIFO output */
+} CAN_MsgView_type;
+
+/* Payload byte idx of a message view, read in place */
+#define CAN_VIEW_BYTE(view, idx) ((uint8_t)((view)->words[(idx) >> 2] >> (24U - (8U * ((idx) & 3U)))))
+
+/* Called from the Rx ISR for every received frame before it enters the Rx ring, the view is only
+   valid during the call. Returning CAN_E_OK consumes the frame, CAN_E_NOT_OK lets it into the ring */
+typedef Std_CAN_Status (*CAN_RxHook_type)(CAN_Handle_type* can_handle, const CAN_MsgView_type* view);
+
+/* Called from the Tx ISR when a frame queued with a non-zero tag was sent */
+typedef void (*CAN_TxDoneHook_type)(CAN_Handle_type* can_handle, uint32_t tag);
+
+/* Single producer (Rx ISR) / single consumer (application) frame ring */
+typedef struct
+{
+    CAN_Frame_type frames[CAN_RX_RING_SIZE];
+    volatile uint16_t head; /* Written by the ISR only */
+    volatile uint16_t tail; /* Written by the consumer only */
+} CAN_RxRing_type;
+
+/* Software Tx queue ordered like the bus arbitration, changed with the Tx interrupts masked or from the ISR */
+typedef struct
+{
+    CAN_Frame_type frames[CAN_TX_QUEUE_SIZE];
+    uint32_t key[CAN_TX_QUEUE_SIZE];        /* MB ID word (PRIO and ID) of each slot, lowest is sent first */
+    uint32_t order[CAN_TX_QUEUE_SIZE];      /* Enqueue order of each slot, equal keys leave first in first out */
+    uint32_t tag[CAN_TX_QUEUE_SIZE];        /* Tag handed to the Tx done hook, 0 for none */
+    uint8_t heap[CAN_TX_QUEUE_SIZE];        /* Occupied slots as a binary min-heap on (key, order) */
+    uint8_t free_slots[CAN_TX_QUEUE_SIZE];  /* Stack of unused slots */
+    volatile uint8_t count;
+    uint32_t next_order;
+} CAN_TxQueue_type;
+
+typedef struct
+{
+    volatile uint32_t rx_frames;   /* Frames moved into the Rx ring */
+    volatile uint32_t rx_overflow; /* Frames dropped because the Rx ring was full */
+    volatile uint32_t tx_frames;   /* Frames loaded into a Tx message buffer */
+    volatile uint32_t tx_replaced; /* Queued frames whose payload CAN_TransmitLatest overwrote */
+} CAN_Statistics_type;
+
+/* Token bucket limiting the bus share of the frames whose identifier matches */
+typedef struct
+{
+    uint32_t match;          /* Identifier bits of the class */
+    uint32_t mask;           /* Identifier bits compared, e.g. 0x7FF for a single standard identifier */
+    uint8_t flags;           /* CAN_FRAME_FLAG_IDE for a class of extended identifiers */
+    uint8_t policy;          /* CAN_TX_LIMIT_POLICY_type of the frames above the limit */
+    uint16_t load_permille;  /* Long term bus share, 1 to 1000 of the nominal bit times */
+    uint32_t burst_bits;     /* Bucket depth: bit times sent back to back, at least the longest frame of the class */
+} CAN_TxLimit_type;
+
+typedef struct
+{
+    uint32_t passed;         /* Frames within the limit */
+    uint32_t deferred;       /* Frames refused under TX_LIMIT_DEFER */
+    uint32_t dropped;        /* Frames discarded under TX_LIMIT_DROP */
+} CAN_TxLimitStats_type;
+
+typedef struct
+{
+    CAN_TxLimit_type limit;
+    uint32_t credit;         /* Tokens in 1/1000 bit time, at most 1000 x burst_bits */
+    CAN_TxLimitStats_type stats;
+} CAN_TxLimitClass_type;
+
+#ifdef CAN_STATS_ENABLE
+/* Counters of one identifier seen by the controller */
+typedef struct
+{
+    uint32_t id;                                          /* Identifier, CAN_STATS_ID_EXT_FLAG for extended */
+    uint32_t tx_frames;                                   /* Frames sent */
+    uint32_t rx_frames;                                   /* Frames received */
+    uint32_t tx_latency_hist[CAN_STATS_LATENCY_BUCKETS];  /* Queued to start of identifier on the bus, in bit times */
+    uint16_t tx_latency_max;
+} CAN_IdStats_type;
+
+/* Counters of one message buffer */
+typedef struct
+{
+    uint32_t tx_frames;
+    uint32_t rx_frames;
+    uint32_t rx_overrun; /* Frames read with CODE = OVERRUN: an earlier frame was overwritten */
+} CAN_MsgBuffStats_type;
+
+/* Statistics since CAN_Init or CAN_ResetStats, copied out by CAN_GetStatsSnapshot */
+typedef struct
+{
+    CAN_IdStats_type ids[CAN_STATS_MAX_IDS];     /* In order of first appearance */
+    uint8_t num_ids;
+    uint32_t untracked_frames;                   /* Frames of identifiers beyond CAN_STATS_MAX_IDS */
+    CAN_MsgBuffStats_type mbs[CAN_MAX_MSG_BUFF]; /* The Rx FIFO counts as MB 0 */
+    uint8_t tx_queue_high_water;                 /* Most frames waiting in the Tx queue at once */
+    uint64_t bus_bits;                           /* Nominal bit times of the frames sent and received */
+    uint64_t bus_ticks;                          /* Nominal bit times elapsed (free-running TIMER) */
+    uint16_t bus_load_permille;                  /* bus_bits / bus_ticks, set by CAN_GetStatsSnapshot */
+} CAN_StatsSnapshot_type;
+
+typedef struct
+{
+    CAN_StatsSnapshot_type live;
+    uint16_t tx_queued_at[CAN_MAX_MSG_BUFF]; /* TIMER when the frame loaded in each Tx MB was queued */
+    uint16_t last_timer;                     /* TIMER at the last bus_ticks update */
+    uint16_t data_bit_q8;                    /* Data phase bit time in nominal bit times, 8 fraction bits */
+} CAN_StatsState_type;
+#endif
+
+/* Driver context of one controller. Every API takes the handle initialised by CAN_Init */
+struct CAN_Handle
+{
+    CAN_Type *can_instance;   /* CAN0, CAN1, CAN2 or a RAM image of CAN_Type */
+    uint8_t msg_buff_size;    /* Words of the largest Tx message buffer (2 header words + payload) */
+    uint8_t num_msg_buff;     /* Message buffers in use (MCR[MAXMB] + 1) */
+    uint32_t rx_mb_mask;      /* IFLAG1/IMASK1 bits of the Rx message buffers */
+    uint32_t tx_mb_mask;      /* IFLAG1/IMASK1 bits of the Tx message buffers */
+    uint32_t tx_free_map;     /* Tx message buffers currently inactive */
+    uint32_t tx_cs_flags;     /* EDL/BRS bits added to every Tx CS word */
+    uint8_t tx_id_flags;      /* CAN_FRAME_FLAG_IDE for an EXTENDED_ID controller, identifier format of CAN_Transmit */
+    uint32_t remote_mb_mask;  /* Tx message buffers taken by CAN_SetRemoteAnswer */
+    uint32_t tx_abort_map;    /* Tx message buffers with an abort request pending */
+    uint32_t tx_mb_order[CAN_MAX_MSG_BUFF]; /* Enqueue order of the frame loaded in each Tx message buffer */
+    uint32_t tx_mb_key[CAN_MAX_MSG_BUFF];   /* ID word (PRIO and ID) of the frame loaded in each Tx message buffer */
+    uint32_t tx_mb_tag[CAN_MAX_MSG_BUFF];   /* Tx done hook tag of the frame loaded in each Tx message buffer */
+    uint8_t rx_fifo;          /* CAN_RX_FIFO_type */
+    uint8_t rx_fifo_filter_num; /* CTRL2[RFFN] when rx_fifo is enabled */
+    uint32_t rx_peek_mask;    /* IFLAG1 bits left to CAN_PeekMsgBuff, 0 without zero copy */
+    uint8_t rx_dma;           /* CAN_RX_DMA_type */
+    uint8_t rx_dma_channel;
+    uint16_t rx_dma_frames;   /* Frames in rx_dma_buffer, the eDMA major loop */
+    uint16_t rx_dma_read;     /* Next rx_dma_buffer frame to move into the Rx ring */
+    CAN_DmaFrame_type *rx_dma_buffer;
+    CAN_MsgBuffMap_type mb_map;
+    CAN_RxRing_type rx_ring;
+    CAN_TxQueue_type tx_queue;
+    CAN_Statistics_type stats;
+    CAN_TxLimitClass_type tx_limit[CAN_TX_LIMIT_MAX_CLASSES]; /* Set by CAN_SetTxLimits, first matching class applies */
+    uint8_t num_tx_limits;    /* 0: transmission is not rate limited */
+    uint16_t tx_limit_timer;  /* TIMER at the last bucket refill */
+    uint8_t busoff_recovery;  /* CAN_BUSOFF_RECOVERY_type */
+    uint8_t busoff_tx;        /* CAN_BUSOFF_TX_type */
+    volatile uint8_t busoff_step; /* Fast recovery started by CAN_ErrorIRQHandler, finished by CAN_ErrorMainFunction */
+    CAN_ErrorCallback_type error_callback;
+    CAN_ErrorStatus_type error_status; /* Written by CAN_ErrorIRQHandler */
+    uint32_t pn_wake_status;  /* WU_MTC of the last Pretended Networking wake-up: WUMF (match), WTOF (timeout), MCOUNTER */
+    CAN_RxHook_type rx_hook;  /* NULL: every frame goes to the Rx ring */
+    CAN_TxDoneHook_type tx_done_hook;
+    void *hook_context;       /* Owner of the hooks, e.g. a gateway */
+#ifdef CAN_STATS_ENABLE
+    CAN_StatsState_type stats_state;
+#endif
+};
+
+Std_CAN_Status CAN_Init(CAN_Handle_type* can_handle, CAN_Config_type* can_config);
+
+/**
+ * @brief Changes the operation mode, bit timing and bit rate switch of a running controller.
+ *
+ * The new timing is solved before the controller stops, then only CTRL1[LPB, LOM], CBT, FDCBT and
+ * FDCTRL[FDRATE, TDCEN, TDCOFF] are written in freeze mode. Message buffers, pending transmissions,
+ * the Rx FIFO, hooks and error counters are kept; frames already loaded in a Tx MB keep the
+ * BRS bit they were loaded with. Freeze mode is entered once the frame on the bus is complete.
+ * Between NORMAL_MODE and LOOP_BACK_MODE the filters are kept. Into or out of LISTEN_ONLY_MODE the
+ * mode bits, CTRL2[EACEN] and the Rx masks are written as CAN_Init does: a monitor accepts every
+ * identifier, and leaving it restores the default masks, so filters set by CAN_Filter_Apply must be
+ * applied again. The MB roles stay those of CAN_Init: a controller initialised in LISTEN_ONLY_MODE has
+ * no Tx MB. With CAN_STATS_ENABLE the statistics restart.
+ *
+ * @param[in] can_handle Controller handle initialised by CAN_Init.
+ * @param[in] reconfig New mode, bit timing and bit rate switch.
+ * @return Std_CAN_Status CAN_E_OK if successful, CAN_E_NOT_OK if the mode is not supported or no
+ *         legal timing exists. Nothing is changed then.
+ */
+Std_CAN_Status CAN_Reconfigure(CAN_Handle_type* can_handle, const CAN_Reconfig_type* reconfig);
+void CAN_transmit_msg(CAN_Handle_type* can_handle, uint32_t id, uint8_t* data_buff);
+void CAN_receive_msg(CAN_Handle_type* can_handle, uint8_t *rx_buff, uint16_t length_buff);
+
+/**
+ * @brief Returns where CAN_Init placed the message buffers and their payload sizes.
+ *
+ * With CAN_Config_type::mb_layout set, CAN_Init picks the FDCTRL[MBDSRn] size of every RAM
+ * block that fits the requested mailboxes and gives the most mailboxes in total. Rx roles are
+ * in rx_mb_mask, every other placed MB transmits.
+ *
+ * @param[in] can_handle Controller handle initialised by CAN_Init.
+ * @return const CAN_MsgBuffMap_type* Message buffer map of the controller.
+ */
+const CAN_MsgBuffMap_type* CAN_GetMsgBuffMap(const CAN_Handle_type* can_handle);
+
+/**
+ * @brief Searches prescaler, PROPSEG, PSEG1, PSEG2 and RJW for the nominal and data phases.
+ *
+ * Integer only. The returned timing has the lowest summed bit rate error, then the closest
+ * sample points. For data rates above 1 Mbit/s the transceiver delay compensation offset is
+ * set to the data sample point.
+ *
+ * @param[in] clock_hz CAN protocol engine clock.
+ * @param[in] bit_rate_config Target bit rates and sample points.
+ * @param[in] can_mode CAN20 (nominal phase only) or CANFD.
+ * @param[out] result Best legal timing with its error.
+ * @return Std_CAN_Status CAN_E_OK if a legal timing exists, otherwise CAN_E_NOT_OK.
+ */
+Std_CAN_Status CAN_ComputeBitTiming(uint32_t clock_hz, const CAN_Bit_Timing_type* bit_rate_config, uint8_t can_mode, CAN_Bit_Timing_Result_type* result);
+
+/**
+ * @brief Writes CBT, and FDCBT plus FDCTRL[TDCEN, TDCOFF] when CAN FD is enabled. Freeze mode only.
+ *
+ * @param[in] can_instance CAN0, CAN1, CAN2 or a RAM image of CAN_Type.
+ * @param[in] timing Timing from CAN_ComputeBitTiming or CAN_BIT_TIMING_INIT.
+ */
+void CAN_ApplyBitTiming(CAN_Type* can_instance, const CAN_Bit_Timing_Result_type* timing);
+
+/**
+ * @brief Requests freeze mode (MCR[FRZ], MCR[HALT]) and waits for MCR[FRZACK].
+ *
+ * Filter masks, bit timing and mode bits of CTRL1/CTRL2/MCR are only writable in freeze mode.
+ *
+ * @param[in] can_handle Controller handle initialised by CAN_Init.
+ */
+void CAN_EnterFreezeMode(CAN_Handle_type* can_handle);
+
+/**
+ * @brief Leaves freeze mode and waits until the controller is synchronised to the bus.
+ *
+ * @param[in] can_handle Controller handle initialised by CAN_Init.
+ */
+void CAN_ExitFreezeMode(CAN_Handle_type* can_handle);
+
+/**
+ * @brief Returns the smallest DLC code whose payload holds length bytes.
+ *
+ * @param[in] length Payload length in bytes (0..64).
+ * @return uint8_t DLC code (0..15).
+ */
+uint8_t CAN_LengthToDlc(uint8_t length);
+
+/**
+ * @brief Returns the payload length of a DLC code, 8 bytes at most in CAN 2.0 mode.
+ *
+ * @param[in] can_handle Controller handle initialised by CAN_Init.
+ * @param[in] dlc DLC code (0..15).
+ * @return uint8_t Payload length in bytes.
+ */
+uint8_t CAN_DlcToLength(const CAN_Handle_type* can_handle, uint8_t dlc);
+
+/**
+ * @brief Queues length bytes for transmission with the nearest DLC and returns immediately.
+ *
+ * Bytes between length and the DLC size are filled with CAN_FD_PADDING_BYTE. Only the payload
+ * words covered by the DLC are written to the message buffer.
+ *
+ * @param[in] can_handle Controller handle initialised by CAN_Init.
+ * @param[in] id Identifier, standard or extended after the id_type given to CAN_Init.
+ * @param[in] data Payload.
+ * @param[in] length Payload length, at most 8 in CAN 2.0 mode and the largest Tx MB payload in CAN FD mode.
+ * @return Std_CAN_Status CAN_E_OK if queued, CAN_E_NOT_OK if no Tx MB holds length bytes or the Tx queue is full.
+ */
+Std_CAN_Status CAN_Transmit(CAN_Handle_type* can_handle, uint32_t id, const uint8_t* data, uint8_t length);
+
+/**
+ * @brief Takes one received frame from the Rx ring without blocking and returns its payload length.
+ *
+ * @param[in] can_handle Controller handle initialised by CAN_Init.
+ * @param[out] id Received identifier.
+ * @param[out] data Payload buffer.
+ * @param[in][out] length Capacity of data on input, copied payload length on output (0 for a remote frame).
+ * @return Std_CAN_Status CAN_E_OK if a frame was returned, CAN_E_NOT_OK if the ring is empty.
+ */
+Std_CAN_Status CAN_Receive(CAN_Handle_type* can_handle, uint32_t* id, uint8_t* data, uint8_t* length);
+
+/**
+ * @brief Takes one received frame from the controller Rx ring without blocking.
+ *
+ * @param[in] can_handle Controller handle initialised by CAN_Init.
+ * @param[out] frame Received frame.
+ * @return Std_CAN_Status CAN_E_OK if a frame was returned, CAN_E_NOT_OK if the ring is empty.
+ */
+Std_CAN_Status CAN_TryReceive(CAN_Handle_type* can_handle, CAN_Frame_type* frame);
+
+/**
+ * @brief Takes up to max_frames received frames from the controller Rx ring without blocking.
+ *
+ * @param[in] can_handle Controller handle initialised by CAN_Init.
+ * @param[out] frames Array receiving the frames.
+ * @param[in] max_frames Capacity of frames.
+ * @return uint16_t Number of frames returned.
+ */
+uint16_t CAN_ReceiveBatch(CAN_Handle_type* can_handle, CAN_Frame_type* frames, uint16_t max_frames);
+
+/**
+ * @brief Locks the lowest full Rx message buffer (or the Rx FIFO output) and describes it in place.
+ *
+ * Needs ENABLE_RX_ZERO_COPY. Reading the CS word locks the MB, so the controller does not overwrite
+ * it until CAN_ReleaseMsgBuff. Only one MB is locked at a time: peek and release without another
+ * peek in between.
+ *
+ * @param[in] can_handle Controller handle initialised by CAN_Init.
+ * @param[out] view Identifier, DLC, timestamp and read-only payload words of the locked MB.
+ * @return Std_CAN_Status CAN_E_OK if a frame is locked, CAN_E_NOT_OK if none is pending.
+ */
+Std_CAN_Status CAN_PeekMsgBuff(CAN_Handle_type* can_handle, CAN_MsgView_type* view);
+
+/**
+ * @brief Acknowledges the frame of a peeked message buffer, then unlocks it by reading TIMER.
+ *
+ * Any CS read of another MB in between, e.g. by an interrupt handler, also unlocks the MB. The
+ * view is then checked against the CS word: if a new frame overwrote it, the flag is kept so
+ * the next peek returns the new frame, and the view data must be discarded.
+ *
+ * @param[in] can_handle Controller handle initialised by CAN_Init.
+ * @param[in] view View returned by CAN_PeekMsgBuff.
+ * @return Std_CAN_Status CAN_E_OK if the view stayed valid, CAN_E_NOT_OK if the frame was overwritten.
+ */
+Std_CAN_Status CAN_ReleaseMsgBuff(CAN_Handle_type* can_handle, const CAN_MsgView_type* view);
+
+/**
+ * @brief Queues a frame for transmission and returns immediately.
+ *
+ * Queued frames are ordered by local priority, then identifier, then enqueue order, and the
+ * Tx message buffers always hold the highest ranked ones: when none is free, the lowest ranked
+ * loaded frame is aborted (MCR[AEN]) and queued again. A frame thus waits at most for the
+ * frame on the bus, the abort and the higher ranked frames of this controller.
+ *
+ * @param[in] can_handle Controller handle initialised by CAN_Init.
+ * @param[in] frame Frame to send. CAN_FRAME_FLAG_IDE selects the extended identifier format and
+ *            CAN_FRAME_FLAG_RTR a remote frame requesting dlc.
+ * @return Std_CAN_Status CAN_E_OK if queued, CAN_E_NOT_OK if no Tx MB holds the DLC or the Tx queue is full.
+ */
+Std_CAN_Status CAN_TransmitAsync(CAN_Handle_type* can_handle, const CAN_Frame_type* frame);
+
+/**
+ * @brief Queues a frame like CAN_TransmitAsync, unless a frame with the same priority, identifier
+ *        and format is still waiting in the Tx queue: that frame then takes the new DLC and payload in place.
+ *
+ * Meant for periodic frames carrying the latest signal values, so an old value never waits in
+ * the queue next to a newer one. A frame already loaded into a Tx message buffer is left to
+ * finish and the new frame is queued behind it.
+ *
+ * @param[in] can_handle Controller handle initialised by CAN_Init.
+ * @param[in] frame Frame to send.
+ * @return Std_CAN_Status CAN_E_OK if queued or merged (stats.tx_replaced counts merges),
+ *         CAN_E_NOT_OK if no Tx MB holds the DLC or the Tx queue is full.
+ */
+Std_CAN_Status CAN_TransmitLatest(CAN_Handle_type* can_handle, const CAN_Frame_type* frame);
+
+/**
+ * @brief Sends a received frame, typically from an Rx hook, copying its payload words straight
+ *        from the Rx message buffer into a Tx message buffer.
+ *
+ * With the Tx queue empty and a fitting Tx message buffer free, the words go from MB to MB without
+ * a byte copy; otherwise the frame is queued like CAN_TransmitAsync. Safe to call from the
+ * interrupt handler of another controller: the destination Tx queue is only changed inside
+ * CAN_CRITICAL_ENTER/CAN_CRITICAL_EXIT (PRIMASK), the same critical section CAN_TransmitAsync,
+ * CAN_TransmitLatest and the Tx interrupt of can_handle use.
+ *
+ * @param[in] can_handle Destination controller handle initialised by CAN_Init.
+ * @param[in] view Received frame, e.g. the view passed to an Rx hook.
+ * @param[in] id Identifier to send the frame with, in the format (IDE) and type (RTR) of the view.
+ * @param[in] tag Passed to the Tx done hook of can_handle once the frame is sent, 0 for none.
+ * @return Std_CAN_Status CAN_E_OK if loaded or queued, CAN_E_NOT_OK if the Tx queue is full or the
+ *         payload does not fit the destination (e.g. a CAN FD frame towards a CAN 2.0 controller).
+ */
+Std_CAN_Status CAN_ForwardMsgBuff(CAN_Handle_type* can_handle, const CAN_MsgView_type* view, uint32_t id, uint32_t tag);
+
+/**
+ * @brief Installs the hooks through which another module, e.g. a gateway, sees the received and sent frames.
+ *
+ * Frames of message buffers left to CAN_PeekMsgBuff (ENABLE_RX_ZERO_COPY) do not reach the Rx hook.
+ *
+ * @param[in] can_handle Controller handle initialised by CAN_Init.
+ * @param[in] rx_hook Rx hook, NULL to deliver every frame to the Rx ring.
+ * @param[in] tx_done_hook Tx done hook, NULL for none.
+ * @param[in] context Stored in can_handle->hook_context for the hooks.
+ */
+void CAN_SetHooks(CAN_Handle_type* can_handle, CAN_RxHook_type rx_hook, CAN_TxDoneHook_type tx_done_hook, void* context);
+
+/**
+ * @brief Lets the controller answer remote requests for an identifier with a data frame, without
+ *        any CPU involvement.
+ *
+ * The first call takes a free Tx message buffer holding the DLC out of the Tx pool and programs it
+ * as remote answer (CODE RANSWER); later calls for the same identifier and format update its DLC
+ * and payload. While any remote answer is set up, CTRL2[RRS] is clear: the controller no longer
+ * stores remote requests, the ones no answer matches are discarded. Changing CTRL2[RRS] passes
+ * through freeze mode.
+ *
+ * @param[in] can_handle Controller handle initialised by CAN_Init.
+ * @param[in] frame Answer: identifier, CAN_FRAME_FLAG_IDE, DLC and payload. CAN 2.0 format.
+ * @return Std_CAN_Status CAN_E_OK if set up, CAN_E_NOT_OK if the DLC exceeds 8 or no fitting Tx
+ *         message buffer is free.
+ */
+Std_CAN_Status CAN_SetRemoteAnswer(CAN_Handle_type* can_handle, const CAN_Frame_type* frame);
+
+/**
+ * @brief Stops answering remote requests for an identifier and gives its message buffer back to the Tx pool.
+ *
+ * When the last remote answer is gone, remote requests are stored and received again (CTRL2[RRS]).
+ *
+ * @param[in] can_handle Controller handle initialised by CAN_Init.
+ * @param[in] id Identifier of the remote answer.
+ * @param[in] flags CAN_FRAME_FLAG_IDE for an extended identifier.
+ * @return Std_CAN_Status CAN_E_OK if removed, CAN_E_NOT_OK if no remote answer has this identifier.
+ */
+Std_CAN_Status CAN_ClearRemoteAnswer(CAN_Handle_type* can_handle, uint32_t id, uint8_t flags);
+
+/**
+ * @brief Caps the bus load of identifier classes with token buckets checked when a frame is queued.
+ *
+ * The buckets fill with load_permille / 1000 token per nominal bit time of the free-running TIMER,
+ * up to burst_bits; a frame takes its nominal length in bit times (CAN 2.0 format, stuff bits
+ * excluded, a BRS data phase counted at the nominal rate). Frames matching no class, frames merged
+ * by CAN_TransmitLatest and remote answers are not limited. A frame above its limit is deferred or
+ * dropped after the class policy and counted; CAN_transmit_msg waits for a deferred frame's tokens.
+ * The buckets are refilled on every check, Tx interrupt and CAN_TxLimitMainFunction call. TIMER wraps
+ * every 65536 nominal bit times (131 ms at 500 kbit/s): with limits set, CAN_TxLimitMainFunction must
+ * run at least once per TIMER period, otherwise an idle class loses the credit of the whole gap and its
+ * next frame is deferred or dropped. Buckets start full.
+ *
+ * @param[in] can_handle Controller handle initialised by CAN_Init.
+ * @param[in] limits Classes, copied. NULL with num_limits 0 removes every limit.
+ * @param[in] num_limits At most CAN_TX_LIMIT_MAX_CLASSES.
+ * @return Std_CAN_Status CAN_E_OK if set, CAN_E_NOT_OK if there are too many classes, a load is
+ *         outside 1-1000 or a burst is 0 or above CAN_TX_LIMIT_MAX_BURST. Nothing is changed then.
+ */
+Std_CAN_Status CAN_SetTxLimits(CAN_Handle_type* can_handle, const CAN_TxLimit_type* limits, uint8_t num_limits);
+
+/**
+ * @brief Copies the counters of a Tx rate limit class.
+ *
+ * @param[in] can_handle Controller handle initialised by CAN_Init.
+ * @param[in] idx_limit Class index in the table given to CAN_SetTxLimits.
+ * @param[out] stats Counters since CAN_SetTxLimits.
+ * @return Std_CAN_Status CAN_E_OK if copied, CAN_E_NOT_OK if the class does not exist.
+ */
+Std_CAN_Status CAN_GetTxLimitStats(CAN_Handle_type* can_handle, uint8_t idx_limit, CAN_TxLimitStats_type* stats);
+
+/**
+ * @brief Refills the Tx rate limit buckets from TIMER, so that idle gaps longer than one TIMER period
+ *        are credited in full.
+ *
+ * Call it periodically from task context while limits are set, more often than the TIMER period of
+ * 65536 nominal bit times, e.g. every 10 ms. Does nothing without limits.
+ *
+ * @param[in] can_handle Controller handle initialised by CAN_Init.
+ */
+void CAN_TxLimitMainFunction(CAN_Handle_type* can_handle);
+
+/**
+ * @brief Drains the Rx FIFO and every flagged Rx message buffer into the controller Rx ring and refills
+ *        released Tx message buffers from the Tx queue.
+ *
+ * Called from the CANx_ORed_*_MB_IRQHandler vectors for the handles bound to CAN0, CAN1 and CAN2;
+ * the NVIC lines must be enabled by the application. Host builds on a RAM image call it directly.
+ *
+ * @param[in] can_handle Controller handle initialised by CAN_Init.
+ */
+void CAN_IRQHandler(CAN_Handle_type* can_handle);
+
+/**
+ * @brief Moves the frames the eDMA wrote since the last call from the DMA buffer into the Rx ring.
+ *
+ * The eDMA channel interrupts at half and end of its major loop, i.e. every rx_dma_watermark frames.
+ * Call this from the DMAn_IRQHandler of the configured channel. Frames below the watermark wait
+ * for the next interrupt; the consumer must keep up within rx_dma_watermark frames.
+ *
+ * @param[in] can_handle Controller handle initialised by CAN_Init with ENABLE_RX_DMA.
+ */
+void CAN_DmaIRQHandler(CAN_Handle_type* can_handle);
+
+/**
+ * @brief Tracks error active, error passive and bus off from the ESR1 interrupts and recovers from bus off.
+ *
+ * At bus off the Tx queue is kept or flushed as configured. With FAST_RECOVERY the handler only
+ * requests freeze mode, without waiting for it; CAN_ErrorMainFunction then clears the error counters
+ * so the controller rejoins after 11 recessive bits instead of 128 x 11. Otherwise the hardware
+ * recovery is left running and ESR1[BOFFDONEINT] reports its end. The error callback is called on
+ * every state change.
+ *
+ * Called from the CANx_ORed_IRQHandler and CANx_Error_IRQHandler vectors for the handles bound to
+ * CAN0, CAN1 and CAN2; the NVIC lines must be enabled by the application.
+ *
+ * @param[in] can_handle Controller handle initialised by CAN_Init.
+ */
+void CAN_ErrorIRQHandler(CAN_Handle_type* can_handle);
+
+/**
+ * @brief Completes a fast bus off recovery started by CAN_ErrorIRQHandler, without busy waiting.
+ *
+ * Once the controller acknowledged freeze mode the error counters are cleared and freeze mode is
+ * left; the next call after the controller resynchronised reports the new state to the error callback.
+ * Call it periodically from task context, e.g. every 1 ms, when FAST_RECOVERY is configured.
+ *
+ * @param[in] can_handle Controller handle initialised by CAN_Init.
+ */
+void CAN_ErrorMainFunction(CAN_Handle_type* can_handle);
+
+/**
+ * @brief Reads the fault confinement state and error counters.
+ *
+ * Leaving error passive raises no interrupt, so the state is refreshed from ESR1 here. Reading
+ * ESR1 clears its error bits.
+ *
+ * @param[in] can_handle Controller handle initialised by CAN_Init.
+ * @param[out] status Current state, counters and error history.
+ */
+void CAN_GetErrorStatus(CAN_Handle_type* can_handle, CAN_ErrorStatus_type* status);
+
+/**
+ * @brief Programs the Pretended Networking wake-up filter of CAN0 and enables MCR[PNET_EN].
+ *
+ * Called by CAN_Init for PRETENDED_NETWORK_MODE, or later to change the filter. Runs in freeze mode.
+ * The controller keeps normal operation until the MCU enters Stop mode.
+ *
+ * @param[in] can_handle Handle of CAN0 initialised by CAN_Init.
+ * @param[in] pn_config Wake-up filter.
+ * @return Std_CAN_Status CAN_E_OK if programmed, CAN_E_NOT_OK if the controller has no Pretended Networking
+ *         or the filter is invalid.
+ */
+Std_CAN_Status CAN_ConfigPretendedNetwork(CAN_Handle_type* can_handle, const CAN_PN_Config_type* pn_config);
+
+/**
+ * @brief Prepares CAN0 for Stop mode with the wake-up filter active.
+ *
+ * Clears the wake-up flags and the match counter of the previous wake-up. On CAN_E_OK the application
+ * enters Stop mode (SMC); the controller then filters the bus with the PN filter only and raises the
+ * CAN0 wake-up interrupt on a match or on the match timeout.
+ *
+ * @param[in] can_handle Handle of CAN0 with Pretended Networking configured.
+ * @return Std_CAN_Status CAN_E_OK if Stop mode may be entered, CAN_E_NOT_OK if Pretended Networking
+ *         is not enabled or frames are still waiting to be sent.
+ */
+Std_CAN_Status CAN_EnterPretendedNetwork(CAN_Handle_type* can_handle);
+
+/**
+ * @brief Records the wake-up reason and moves the matching frames kept in the wake-up message buffers
+ *        into the Rx ring.
+ *
+ * Called from CAN0_Wake_Up_IRQHandler. Up to 4 frames are kept; later matches only count in MCOUNTER.
+ *
+ * @param[in] can_handle Handle of CAN0 with Pretended Networking configured.
+ */
+void CAN_PnWakeUpIRQHandler(CAN_Handle_type* can_handle);
+
+#ifdef CAN_STATS_ENABLE
+/**
+ * @brief Copies the per-ID and per-MB counters and computes the bus load since the last reset.
+ *
+ * Bus load counts the frames this controller sent or received without stuff bits, so it is a
+ * lower bound. bus_ticks follows TIMER, which wraps every 65536 bit times (131 ms at 500 kbit/s): a
+ * gap without frames, snapshots or CAN_StatsMainFunction calls that long loses whole periods, which
+ * raises the load computed (never above 1000). Interrupts are masked during the copy.
+ *
+ * @param[in] can_handle Controller handle initialised by CAN_Init.
+ * @param[out] snapshot Copy of the statistics.
+ */
+void CAN_GetStatsSnapshot(CAN_Handle_type* can_handle, CAN_StatsSnapshot_type* snapshot);
+
+/**
+ * @brief Adds the elapsed TIMER ticks to the bus load window, so that idle gaps are counted in full.
+ *
+ * Call it periodically from task context, more often than the TIMER period of 65536 nominal bit times,
+ * e.g. every 10 ms. Cheaper than CAN_GetStatsSnapshot, which copies every counter.
+ *
+ * @param[in] can_handle Controller handle initialised by CAN_Init.
+ */
+void CAN_StatsMainFunction(CAN_Handle_type* can_handle);
+
+/**
+ * @brief Clears the statistics and restarts the bus load window.
+ *
+ * @param[in] can_handle Controller handle initialised by CAN_Init.
+ */
+void CAN_ResetStats(CAN_Handle_type* can_handle);
+#endif
+
+#endif /* S32K144_CAN_DRIVER_H */
@@ -0,0 +1,100 @@
+/**
+ * @file s32k144_can_filter.h
+ * @brief Acceptance filter compiler for the FlexCAN Rx message buffers and Rx FIFO ID table.
+ *
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef S32K144_CAN_FILTER_H
+#define S32K144_CAN_FILTER_H
+
+/*******************************************************************************
+ * Inclusion
+ ******************************************************************************/
+
+#include "s32k144_can_driver.h"
+
+/*******************************************************************************
+* Definitions
+******************************************************************************/
+
+#define CAN_FILTER_MAX_ENTRIES (64U)  /* IDs/ranges accepted by one compile */
+#define CAN_FILTER_MAX_SLOTS   (128U) /* Rx FIFO table holds up to 128 elements (RFFN = 15) */
+
+#define CAN_FILTER_ID(id)           { (id), (id) }     /* Accept a single ID */
+#define CAN_FILTER_RANGE(low, high) { (low), (high) }  /* Accept every ID in [low, high] */
+
+typedef struct
+{
+    uint32_t id_low;
+    uint32_t id_high; /* Equal to id_low for a single ID */
+} CAN_FilterEntry_type;
+
+/* One hardware filter: accepts every ID where (ID & mask) == id */
+typedef struct
+{
+    uint32_t id;
+    uint32_t mask;
+} CAN_FilterSlot_type;
+
+typedef struct
+{
+    CAN_FilterSlot_type slots[CAN_FILTER_MAX_SLOTS];
+    uint8_t num_slots;           /* Filters in use */
+    uint8_t num_individual;      /* slots[0, num_individual) own an RXIMR, the rest share global_mask */
+    uint8_t id_type;             /* CAN_ID_TYPE_type of every slot */
+    uint32_t global_mask;        /* RXMGMASK / RXFGMASK value (ID bits, right aligned) */
+    uint32_t false_positive_ids; /* IDs accepted by hardware that no entry asked for */
+} CAN_FilterTable_type;
+
+/*******************************************************************************
+* API
+******************************************************************************/
+
+/**
+ * @brief Returns how many individually masked and globally masked filters a controller offers.
+ *
+ * Rx message buffers each own an RXIMR. In Rx FIFO mode the first 8 + 2 * RFFN ID table
+ * elements own an RXIMR and the remaining ones share RXFGMASK.
+ *
+ * @param[in] can_handle Controller handle initialised by CAN_Init.
+ * @param[out] num_individual Filters with their own mask.
+ * @param[out] num_shared Filters sharing the global mask.
+ */
+void CAN_Filter_GetCapacity(const CAN_Handle_type* can_handle, uint8_t* num_individual, uint8_t* num_shared);
+
+/**
+ * @brief Computes the filters covering a list of IDs and ID ranges with the fewest unwanted IDs.
+ *
+ * Every range is split into aligned ID/mask blocks, then the neighbouring blocks whose merge
+ * accepts the fewest extra IDs are merged until the blocks fit the filter budget. Blocks that
+ * do not get an individual mask are widened to a common global mask.
+ *
+ * @param[in] entries IDs and ID ranges to accept.
+ * @param[in] num_entries Number of entries (at most CAN_FILTER_MAX_ENTRIES).
+ * @param[in] id_type STARDADARD_ID (11 bit) or EXTENDED_ID (29 bit).
+ * @param[in] num_individual Filters with their own mask.
+ * @param[in] num_shared Filters sharing the global mask.
+ * @param[out] table Computed filters and the number of unwanted IDs they still accept.
+ * @return Std_CAN_Status CAN_E_OK if successful, otherwise CAN_E_NOT_OK.
+ */
+Std_CAN_Status CAN_Filter_Compile(const CAN_FilterEntry_type* entries, uint8_t num_entries, uint8_t id_type,
+                                  uint8_t num_individual, uint8_t num_shared, CAN_FilterTable_type* table);
+
+/**
+ * @brief Writes a compiled filter table to the Rx message buffers or the Rx FIFO ID table.
+ *
+ * Enters freeze mode, enables individual masking (MCR[IRMQ]) and leaves freeze mode again.
+ * Rx message buffers without a filter are deactivated.
+ *
+ * @param[in] can_handle Controller handle initialised by CAN_Init.
+ * @param[in] table Table returned by CAN_Filter_Compile for this controller's capacity.
+ * @return Std_CAN_Status CAN_E_OK if successful, otherwise CAN_E_NOT_OK.
+ */
+Std_CAN_Status CAN_Filter_Apply(CAN_Handle_type* can_handle, const CAN_FilterTable_type* table);
+
+#endif /* S32K144_CAN_FILTER_H */
@@ -0,0 +1,119 @@
+/**
+ * @file s32k144_can_gateway.h
+ * @brief Frame routing between CAN0, CAN1 and CAN2 inside the receive interrupt.
+ *
+ * The gateway installs driver hooks on every routed controller. A received frame is matched
+ * against the routing table in its Rx interrupt and copied from the Rx message buffer into a
+ * Tx message buffer (or the Tx queue) of each destination, without passing the Rx ring or the
+ * application. Each route measures its latency from the Rx interrupt to the end of the
+ * transmission on the destination bus with an application supplied free-running clock.
+ *
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef S32K144_CAN_GATEWAY_H
+#define S32K144_CAN_GATEWAY_H
+
+/*******************************************************************************
+ * Inclusion
+ ******************************************************************************/
+
+#include "s32k144_can_driver.h"
+
+/*******************************************************************************
+* Definitions
+******************************************************************************/
+
+#ifndef CAN_GATEWAY_MAX_ROUTES
+#define CAN_GATEWAY_MAX_ROUTES (32U)        /* Routes per CAN_Gateway_type */
+#endif
+
+#define CAN_GATEWAY_CLOCK_MASK (0x00FFFFFFU) /* Clock bits carried with a forwarded frame, bounds the measurable latency */
+
+/* Free-running time in ticks of the application's choice, e.g. microseconds or DWT cycles */
+typedef uint32_t (*CAN_Gateway_Clock_type)(void);
+
+/* Frames of src_bus in the identifier format of flags with (id & mask) == match are sent on every bus of
+   dst_buses, in the same format */
+typedef struct
+{
+    uint8_t src_bus;        /* Index into the gateway buses */
+    uint8_t dst_buses;      /* Bit n: forward to bus n */
+    uint8_t keep_local;     /* 1: the frame also enters the Rx ring of the source controller */
+    uint32_t match;
+    uint32_t mask;
+    uint32_t rewrite_mask;  /* Identifier bits replaced by new_id, 0 to forward the identifier unchanged */
+    uint32_t new_id;
+    uint8_t flags;          /* CAN_FRAME_FLAG_IDE for a route of extended identifiers, 0 for standard ones */
+} CAN_GatewayRoute_type;
+
+typedef struct
+{
+    uint32_t matched;       /* Received frames that matched the route */
+    uint32_t forwarded;     /* Frames handed to a destination controller, one per destination */
+    uint32_t dropped;       /* Destination Tx queue full or payload too long for the destination */
+    uint32_t completed;     /* Forwarded frames sent on their destination bus */
+    uint32_t latency_min;   /* Rx interrupt to end of transmission, clock ticks */
+    uint32_t latency_max;
+    uint64_t latency_sum;   /* Average: latency_sum / completed */
+} CAN_GatewayRouteStats_type;
+
+typedef struct
+{
+    CAN_Handle_type *buses[CAN_INSTANCE_COUNT]; /* Initialised controllers, NULL for an unused index */
+    const CAN_GatewayRoute_type *routes;        /* First matching route wins */
+    uint8_t num_routes;                         /* At most CAN_GATEWAY_MAX_ROUTES */
+    CAN_Gateway_Clock_type clock;               /* NULL: no latency measurement */
+} CAN_Gateway_Config_type;
+
+typedef struct
+{
+    CAN_Handle_type *buses[CAN_INSTANCE_COUNT];
+    const CAN_GatewayRoute_type *routes;
+    uint8_t num_routes;
+    CAN_Gateway_Clock_type clock;
+    CAN_GatewayRouteStats_type stats[CAN_GATEWAY_MAX_ROUTES]; /* Written by the interrupt handlers */
+} CAN_Gateway_type;
+
+/*******************************************************************************
+* API
+******************************************************************************/
+
+/**
+ * @brief Checks the routing table and installs the gateway hooks on every configured controller.
+ *
+ * @param[out] gateway Gateway state, must stay valid while the hooks are installed.
+ * @param[in] config Controllers, routing table and clock. The routing table is referenced, not copied.
+ * @return Std_CAN_Status CAN_E_OK if successful, CAN_E_NOT_OK if a route names a missing bus, routes a
+ *         bus to itself or there are too many routes.
+ */
+Std_CAN_Status CAN_Gateway_Init(CAN_Gateway_type* gateway, const CAN_Gateway_Config_type* config);
+
+/**
+ * @brief Removes the gateway hooks, every frame goes to the Rx rings again.
+ *
+ * @param[in] gateway Gateway state.
+ */
+void CAN_Gateway_DeInit(CAN_Gateway_type* gateway);
+
+/**
+ * @brief Copies the counters and latencies of one route consistently.
+ *
+ * @param[in] gateway Gateway state.
+ * @param[in] route Route index.
+ * @param[out] stats Counters since CAN_Gateway_Init or CAN_Gateway_ResetStats.
+ */
+void CAN_Gateway_GetRouteStats(CAN_Gateway_type* gateway, uint8_t route, CAN_GatewayRouteStats_type* stats);
+
+/**
+ * @brief Clears the counters and latencies of every route.
+ *
+ * @param[in] gateway Gateway state.
+ */
+void CAN_Gateway_ResetStats(CAN_Gateway_type* gateway);
+
+#endif /* S32K144_CAN_GATEWAY_H */
@@ -0,0 +1,178 @@
+/**
+ * @file s32k144_can_isotp.h
+ * @brief ISO 15765-2 (ISO-TP) segmentation, reassembly and flow control on top of the CAN driver.
+ *
+ * Normal addressing with 11 bit identifiers. Each channel pairs one transmit and one receive
+ * identifier and runs one transmission and one reception at a time; the channels of a controller
+ * share its Tx queue and Rx ring. The engine is polled: received frames are handed in with
+ * CAN_IsoTp_RxIndication, consecutive frames, flow control retries and timeouts are processed
+ * by CAN_IsoTp_MainFunction.
+ *
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef S32K144_CAN_ISOTP_H
+#define S32K144_CAN_ISOTP_H
+
+/*******************************************************************************
+ * Inclusion
+ ******************************************************************************/
+
+#include "s32k144_can_driver.h"
+
+/*******************************************************************************
+* Definitions
+******************************************************************************/
+
+#ifndef CAN_ISOTP_MAX_CHANNELS
+#define CAN_ISOTP_MAX_CHANNELS (8U)       /* Channels per CAN_IsoTp_type */
+#endif
+
+#ifndef CAN_ISOTP_N_BS_US
+#define CAN_ISOTP_N_BS_US      (1000000U) /* Sender wait for a flow control frame */
+#endif
+
+#ifndef CAN_ISOTP_N_CR_US
+#define CAN_ISOTP_N_CR_US      (1000000U) /* Receiver wait for the next consecutive frame */
+#endif
+
+#define CAN_ISOTP_MAX_WFT      (16U)      /* FC(WAIT) frames accepted in a row before giving up */
+#define CAN_ISOTP_PADDING_BYTE (0xCCU)    /* Fills frames up to 8 bytes or the next CAN FD DLC size */
+
+/* Outcome of a transmission or reception (N_Result) */
+typedef enum
+{
+    ISOTP_OK,
+    ISOTP_BUSY,          /* In progress */
+    ISOTP_TIMEOUT_BS,    /* No flow control within CAN_ISOTP_N_BS_US */
+    ISOTP_TIMEOUT_CR,    /* No consecutive frame within CAN_ISOTP_N_CR_US */
+    ISOTP_WRONG_SN,      /* Consecutive frame out of sequence */
+    ISOTP_INVALID_FS,    /* Unknown flow status */
+    ISOTP_UNEXP_PDU,     /* A new message interrupted the reception */
+    ISOTP_WFT_OVRN,      /* More than CAN_ISOTP_MAX_WFT FC(WAIT) */
+    ISOTP_BUFFER_OVFLW   /* Message longer than the receive buffer, or the receiver reported overflow */
+} CAN_ISOTP_RESULT_type;
+
+typedef enum
+{
+    ISOTP_TX_DONE,       /* Last frame of a transmission handed to the driver, or transmission aborted */
+    ISOTP_RX_DONE        /* Reception complete in rx_buffer, or reception aborted */
+} CAN_ISOTP_EVENT_type;
+
+typedef struct
+{
+    uint32_t tx_id;          /* Standard identifier of sent data frames and of flow control for receptions */
+    uint32_t rx_id;          /* Standard identifier of received data frames and of flow control for transmissions */
+    uint8_t tx_dl;           /* Frame length used to send: 8 for CAN 2.0, 8-64 (a CAN FD DLC size) for CAN FD */
+    uint8_t block_size;      /* BS announced to senders, 0: no further flow control after the first */
+    uint8_t st_min;          /* STmin announced to senders: 0x00-0x7F ms, 0xF1-0xF9 100-900 us */
+    uint8_t *rx_buffer;      /* Receives messages, valid from ISOTP_RX_DONE until the next reception starts */
+    uint32_t rx_buffer_size;
+} CAN_IsoTp_ChannelConfig_type;
+
+typedef struct
+{
+    const CAN_IsoTp_ChannelConfig_type *config;
+
+    /* Transmission */
+    const uint8_t *tx_data;  /* Caller buffer, must stay valid until ISOTP_TX_DONE */
+    uint32_t tx_length;
+    uint32_t tx_offset;      /* Bytes handed to the driver */
+    uint32_t tx_deadline_us; /* N_Bs end while waiting for flow control, else earliest next CF (STmin) */
+    uint32_t tx_stmin_us;    /* Separation time requested by the receiver */
+    uint8_t tx_state;
+    uint8_t tx_result;       /* CAN_ISOTP_RESULT_type */
+    uint8_t tx_sn;           /* Sequence number of the next consecutive frame */
+    uint8_t tx_bs_left;      /* Consecutive frames left in the block, 0 without limit */
+    uint8_t tx_bs;           /* Block size requested by the receiver */
+    uint8_t tx_wait_count;
+
+    /* Reception */
+    uint32_t rx_length;      /* Message length announced by SF or FF */
+    uint32_t rx_offset;      /* Bytes stored in rx_buffer */
+    uint32_t rx_deadline_us; /* N_Cr end */
+    uint8_t rx_state;
+    uint8_t rx_result;       /* CAN_ISOTP_RESULT_type */
+    uint8_t rx_sn;           /* Expected sequence number */
+    uint8_t rx_bs_left;      /* Consecutive frames left until the next flow control */
+    uint8_t rx_fc_pending;   /* Flow status of a flow control frame the Tx queue did not take yet, 0xFF none */
+} CAN_IsoTp_Channel_type;
+
+typedef struct CAN_IsoTp CAN_IsoTp_type;
+
+/* Completion of a transmission or reception on channel, result is a CAN_ISOTP_RESULT_type */
+typedef void (*CAN_IsoTp_Callback_type)(CAN_IsoTp_type* isotp, uint8_t channel, uint8_t event, uint8_t result);
+
+typedef struct
+{
+    CAN_Handle_type *can_handle;
+    const CAN_IsoTp_ChannelConfig_type *channels;
+    uint8_t num_channels;                 /* At most CAN_ISOTP_MAX_CHANNELS */
+    CAN_IsoTp_Callback_type callback;     /* NULL: results are only recorded in the channels */
+} CAN_IsoTp_Config_type;
+
+struct CAN_IsoTp
+{
+    CAN_Handle_type *can_handle;
+    CAN_IsoTp_Channel_type channels[CAN_ISOTP_MAX_CHANNELS];
+    uint8_t num_channels;
+    CAN_IsoTp_Callback_type callback;
+    uint32_t now_us;                      /* Time passed to the last CAN_IsoTp_MainFunction */
+    uint32_t unmatched_frames;            /* Frames passed to CAN_IsoTp_RxIndication for no channel */
+};
+
+/*******************************************************************************
+* API
+******************************************************************************/
+
+/**
+ * @brief Binds the channels to an initialised controller and resets their state.
+ *
+ * @param[out] isotp Engine state.
+ * @param[in] config Controller, channel configurations and completion callback. The channel
+ *                   configurations are referenced, not copied.
+ * @return Std_CAN_Status CAN_E_OK if successful, CAN_E_NOT_OK if a channel needs a larger frame
+ *         than the controller sends or has no receive buffer.
+ */
+Std_CAN_Status CAN_IsoTp_Init(CAN_IsoTp_type* isotp, const CAN_IsoTp_Config_type* config);
+
+/**
+ * @brief Starts sending a message on a channel.
+ *
+ * Messages up to one frame go out as single frame, longer ones as first frame followed by
+ * consecutive frames paced by the receiver's flow control (BS, STmin). Completion is reported
+ * through the callback and tx_result.
+ *
+ * @param[in] isotp Engine state.
+ * @param[in] channel Channel index.
+ * @param[in] data Message, referenced until ISOTP_TX_DONE.
+ * @param[in] length Message length, 1 to 4294967295 bytes (above 4095 with the 32 bit first frame).
+ * @return Std_CAN_Status CAN_E_OK if started, CAN_E_NOT_OK if the channel is busy or the arguments are invalid.
+ */
+Std_CAN_Status CAN_IsoTp_Send(CAN_IsoTp_type* isotp, uint8_t channel, const uint8_t* data, uint32_t length);
+
+/**
+ * @brief Processes one received frame.
+ *
+ * @param[in] isotp Engine state.
+ * @param[in] frame Frame taken from the controller Rx ring.
+ * @return Std_CAN_Status CAN_E_OK if the frame belongs to a channel, CAN_E_NOT_OK otherwise.
+ */
+Std_CAN_Status CAN_IsoTp_RxIndication(CAN_IsoTp_type* isotp, const CAN_Frame_type* frame);
+
+/**
+ * @brief Sends due consecutive and flow control frames and checks the timeouts.
+ *
+ * Call it periodically and after received frames. Consecutive frames are queued as long as STmin
+ * allows and the Tx queue takes them, so the call rate bounds the throughput only with STmin > 0.
+ *
+ * @param[in] isotp Engine state.
+ * @param[in] now_us Free-running microsecond time, wrapping at 2^32.
+ */
+void CAN_IsoTp_MainFunction(CAN_IsoTp_type* isotp, uint32_t now_us);
+
+#endif /* S32K144_CAN_ISOTP_H */
@@ -0,0 +1,267 @@
+/**
+ * @file s32k144_can_sim.h
+ * @brief Host-side register model of FlexCAN controllers sharing one virtual CAN bus.
+ *
+ * Built only with CAN_SIM defined. CAN0-2 then point at CAN_Sim_regs and the unchanged
+ * driver runs on a Linux host: MCR handshakes are acknowledged, Tx message buffers arbitrate
+ * by local priority and identifier, aborts (MCR[AEN]) of pending MBs complete at once, bus off and
+ * its recovery can be forced, Stop mode with the Pretended Networking wake-up filter can be entered,
+ * frames are matched against RXIMR/RXMGMASK or the Rx FIFO ID table (drained by the routed eDMA
+ * channel when MCR[DMA] is set, see CAN_Sim_dma and CAN_Sim_dmamux) and the interrupt handler of
+ * every attached handle is called when IFLAG1 & IMASK1 is set.
+ * Message buffer locking (CS read / TIMER read) is not modelled.
+ *
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef S32K144_CAN_SIM_H
+#define S32K144_CAN_SIM_H
+
+#ifdef CAN_SIM
+
+/*******************************************************************************
+ * Inclusion
+ ******************************************************************************/
+
+#include "s32k144_can_driver.h"
+#include "s32k144_can_isotp.h"
+#include "s32k144_can_codec.h"
+#include "s32k144_can_cyclic.h"
+
+/*******************************************************************************
+* Definitions
+******************************************************************************/
+
+#define CAN_SIM_MAX_NODES (8U) /* Controllers attached to the virtual bus */
+
+typedef struct
+{
+    uint64_t time_ns;        /* Simulated time, advanced by every frame on the bus */
+    uint64_t busy_ns;        /* Time the bus carried frames */
+    uint32_t frames;         /* Frames that won arbitration or were injected */
+    uint32_t rx_stored;      /* Frames stored into a receiver MB or Rx FIFO */
+    uint32_t rx_lost;        /* Frames overwriting a full MB or dropped by a full Rx FIFO */
+    uint32_t tx_completed;   /* Tx message buffers completed */
+    uint64_t latency_sum_ns; /* Sum over tx_completed of Tx request (CODE = DATA) to end of frame */
+    uint64_t latency_max_ns;
+} CAN_Sim_Stats_type;
+
+typedef struct
+{
+    uint32_t frames_sent;       /* Frames accepted by CAN_Transmit */
+    uint32_t frames_received;   /* Frames taken from the receiver Rx ring */
+    uint64_t bus_time_ns;       /* Simulated bus time of the run */
+    uint32_t frames_per_second; /* Bus throughput in simulated time */
+    uint64_t avg_latency_ns;
+    uint64_t max_latency_ns;
+    uint64_t host_ns_per_frame; /* Host CPU time spent in driver and model per frame */
+} CAN_Sim_Bench_type;
+
+/* Told when the model works on the registers inside a driver call (CAN_Sim_Poll, CAN_Sim_ClearFlags):
+   active 1 with the register accesses the hardware would see for that call, then active 0 */
+typedef void (*CAN_Sim_ModelHook_type)(uint8_t active, uint32_t accesses);
+
+typedef struct
+{
+    uint32_t bytes;             /* Message bytes delivered */
+    uint32_t frames;            /* Frames on the bus, flow control included */
+    uint64_t bus_time_ns;       /* Simulated bus time of the transfer */
+    uint32_t bytes_per_second;  /* Message throughput in simulated time */
+    uint64_t host_ns_per_frame; /* Host CPU time spent in ISO-TP, driver and model per frame */
+} CAN_Sim_IsoTpBench_type;
+
+typedef struct
+{
+    uint32_t frames;            /* Frames decoded by each decoder */
+    uint64_t bitwise_ns;        /* Host time per frame of a byte and bit walking reference decoder */
+    uint64_t compiled_ns;       /* Host time per frame of CAN_Codec_UnpackRaw, CAN_Codec_LoadWords included */
+    uint32_t mismatches;        /* Raw values on which both decoders disagree */
+} CAN_Sim_CodecBench_type;
+
+typedef struct
+{
+    uint32_t frames;          /* Payloads written into and read back from a message buffer by each kernel */
+    uint64_t bytewise_ns;     /* Host time per frame of byte shifting loops reading the MB word once per byte */
+    uint64_t wordwise_ns;     /* Host time per frame of the unrolled word kernels of the driver */
+    uint64_t bytewise_cycles; /* Time stamp counter ticks per frame of the byte loops, 0 without a counter */
+    uint64_t wordwise_cycles; /* Time stamp counter ticks per frame of the word kernels, 0 without a counter */
+    uint32_t mismatches;      /* Payloads on which both kernels disagree */
+} CAN_Sim_CopyBench_type;
+
+typedef struct
+{
+    uint32_t frames;                                 /* Cyclic frames received */
+    uint16_t peak_load_permille;                     /* Bus load of the busiest window */
+    uint16_t avg_load_permille;                      /* Bus load over the whole run */
+    uint32_t max_jitter_us[CAN_CYCLIC_MAX_MESSAGES]; /* Largest deviation of a reception interval from the period */
+    uint32_t max_jitter_all_us;                      /* Largest of max_jitter_us */
+} CAN_Sim_CyclicBench_type;
+
+/*******************************************************************************
+* API
+******************************************************************************/
+
+/**
+ * @brief Loads the reset values into CAN_Sim_regs, detaches every node and clears the statistics.
+ */
+void CAN_Sim_Reset(void);
+
+/**
+ * @brief Loads the FlexCAN reset values into one register model (CAN_Sim_regs or a RAM image).
+ *
+ * @param[in] can_instance Register model to reset.
+ */
+void CAN_Sim_ResetRegs(CAN_Type* can_instance);
+
+/**
+ * @brief Connects an initialised controller to the virtual bus.
+ *
+ * @param[in] can_handle Handle initialised by CAN_Init, its CAN_IRQHandler is called on events.
+ * @return Std_CAN_Status CAN_E_OK if attached, CAN_E_NOT_OK if CAN_SIM_MAX_NODES are in use.
+ */
+Std_CAN_Status CAN_Sim_Attach(CAN_Handle_type* can_handle);
+
+/**
+ * @brief Arbitrates the pending Tx message buffers of all nodes and transfers the winning frame.
+ *
+ * @return uint8_t 1 if a frame was transferred, 0 if the bus stays idle.
+ */
+uint8_t CAN_Sim_Step(void);
+
+/**
+ * @brief Transfers frames until the bus is idle or max_frames were sent.
+ *
+ * @param[in] max_frames Upper bound of frames to transfer.
+ * @return uint32_t Frames transferred.
+ */
+uint32_t CAN_Sim_Run(uint32_t max_frames);
+
+/**
+ * @brief Puts a frame of an external node on the bus, e.g. to replay a traffic capture.
+ *
+ * @param[in] frame Identifier, DLC and payload.
+ * @param[in] cs_flags CAN_MB_CS_EDL_MASK, CAN_MB_CS_BRS_MASK and CAN_MB_CS_IDE_MASK as needed.
+ * @return Std_CAN_Status CAN_E_OK if sent, CAN_E_NOT_OK if no attached node is on the bus.
+ */
+Std_CAN_Status CAN_Sim_Inject(const CAN_Frame_type* frame, uint32_t cs_flags);
+
+/**
+ * @brief Drives an attached controller into bus off, as after repeated transmit errors.
+ *
+ * The node leaves the bus until its automatic recovery (128 x 11 bit times of bus time, run on
+ * an otherwise idle bus by CAN_Sim_Step) ends, or until TXERRCNT is cleared in freeze mode.
+ *
+ * @param[in] can_instance Register model of an attached controller.
+ * @return Std_CAN_Status CAN_E_OK if the node went bus off, CAN_E_NOT_OK if it is not attached.
+ */
+Std_CAN_Status CAN_Sim_BusOff(CAN_Type* can_instance);
+
+/**
+ * @brief Models the MCU entering Stop mode with Pretended Networking enabled on a controller.
+ *
+ * The node leaves the bus and only compares frames with its PN filter, storing matches in the WMBs.
+ * On wake-up it rejoins the bus and CAN_PnWakeUpIRQHandler is called. The match timeout is not modelled.
+ *
+ * @param[in] can_instance Register model of an attached controller with MCR[PNET_EN] set.
+ * @return Std_CAN_Status CAN_E_OK if the node stopped, CAN_E_NOT_OK otherwise.
+ */
+Std_CAN_Status CAN_Sim_EnterStop(CAN_Type* can_instance);
+
+/**
+ * @brief Copies the bus statistics.
+ *
+ * @param[out] stats Statistics since CAN_Sim_Reset.
+ */
+void CAN_Sim_GetStats(CAN_Sim_Stats_type* stats);
+
+/**
+ * @brief Installs the hook told about the register work of the model inside driver calls.
+ *
+ * Lets a host tool that watches the register accesses of the driver, e.g. by protecting the register
+ * pages, leave out the accesses of the model and count what the hardware would see instead.
+ *
+ * @param[in] hook Called around the model work, NULL to remove it.
+ */
+void CAN_Sim_SetModelHook(CAN_Sim_ModelHook_type hook);
+
+/**
+ * @brief Sends num_frames frames from one node to another through the driver API and measures
+ *        bus throughput, Tx latency and host CPU time per frame.
+ *
+ * @param[in] tx_handle Attached sending node.
+ * @param[in] rx_handle Attached receiving node, its filters must accept id.
+ * @param[in] id Standard identifier of every frame.
+ * @param[in] length Payload length of every frame.
+ * @param[in] num_frames Frames to send.
+ * @param[out] result Measurements of the run.
+ * @return Std_CAN_Status CAN_E_OK if every frame was received, otherwise CAN_E_NOT_OK.
+ */
+Std_CAN_Status CAN_Sim_Benchmark(CAN_Handle_type* tx_handle, CAN_Handle_type* rx_handle, uint32_t id,
+                                 uint8_t length, uint32_t num_frames, CAN_Sim_Bench_type* result);
+
+/**
+ * @brief Sends one ISO-TP message from one channel to another through the bus and measures its throughput.
+ *
+ * Meant for a controller in LOOP_BACK_MODE carrying both channels (tx_id of one is rx_id of the other
+ * and its filters accept both). CAN_IsoTp_MainFunction runs with the simulated time after every frame.
+ * Messages of up to 7 bytes cover the classic single frame, which CAN FD channels send as well.
+ *
+ * @param[in] isotp Engine with both channels.
+ * @param[in] tx_channel Sending channel.
+ * @param[in] rx_channel Receiving channel, its receive buffer must hold length bytes.
+ * @param[in] data Message.
+ * @param[in] length Message length.
+ * @param[out] result Measurements of the transfer.
+ * @return Std_CAN_Status CAN_E_OK if the message arrived unchanged, otherwise CAN_E_NOT_OK.
+ */
+Std_CAN_Status CAN_Sim_IsoTpBenchmark(CAN_IsoTp_type* isotp, uint8_t tx_channel, uint8_t rx_channel,
+                                      const uint8_t* data, uint32_t length, CAN_Sim_IsoTpBench_type* result);
+
+/**
+ * @brief Decodes random payloads of a message with a bit walking reference decoder and with the
+ *        compiled plan, and compares their speed and results.
+ *
+ * @param[in] message Message description, e.g. 40 signals in a 64 byte CAN FD frame.
+ * @param[in] num_frames Payloads decoded by each decoder.
+ * @param[out] result Measurements of the run.
+ * @return Std_CAN_Status CAN_E_OK if the message compiles and both decoders agree, otherwise CAN_E_NOT_OK.
+ */
+Std_CAN_Status CAN_Sim_CodecBenchmark(const CAN_MessageDesc_type* message, uint32_t num_frames,
+                                      CAN_Sim_CodecBench_type* result);
+
+/**
+ * @brief Copies random payloads into a message buffer and back with byte shifting loops and with
+ *        the word kernels of the driver, and compares their speed and results.
+ *
+ * @param[in] length Payload bytes, a multiple of 4 up to 64, e.g. 8, 16, 32 or 64.
+ * @param[in] num_frames Payloads copied by each kernel.
+ * @param[out] result Measurements of the run.
+ * @return Std_CAN_Status CAN_E_OK if the length is valid and both kernels agree, otherwise CAN_E_NOT_OK.
+ */
+Std_CAN_Status CAN_Sim_CopyBenchmark(uint8_t length, uint32_t num_frames, CAN_Sim_CopyBench_type* result);
+
+/**
+ * @brief Runs a cyclic scheduler on the bus for a while and measures the bus load and the
+ *        reception jitter of every message.
+ *
+ * CAN_Cyclic_MainFunction runs every call_period_us of simulated time, between frames; the bus
+ * idles in between. Frames are taken from the receiver every frame and timed at their end.
+ *
+ * @param[in] cyclic Scheduler initialised with CAN_Cyclic_Init at the current simulated time.
+ * @param[in] rx_handle Attached controller receiving every cyclic identifier.
+ * @param[in] duration_us Simulated run time.
+ * @param[in] call_period_us Period of CAN_Cyclic_MainFunction.
+ * @param[in] window_us Window of the peak bus load, e.g. 1000.
+ * @param[out] result Measurements of the run.
+ * @return Std_CAN_Status CAN_E_OK if frames were received, otherwise CAN_E_NOT_OK.
+ */
+Std_CAN_Status CAN_Sim_CyclicBenchmark(CAN_Cyclic_type* cyclic, CAN_Handle_type* rx_handle, uint32_t duration_us,
+                                       uint32_t call_period_us, uint32_t window_us, CAN_Sim_CyclicBench_type* result);
+
+#endif /* CAN_SIM */
+
+#endif /* S32K144_CAN_SIM_H */
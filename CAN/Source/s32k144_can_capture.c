@@ -0,0 +1,261 @@
+/**
+ * @file s32k144_can_capture.c
+ * @brief Bus monitor recording every received frame with its hardware timestamp.
+ *
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*******************************************************************************
+ * Inclusion
+ ******************************************************************************/
+
+#include "../src/Driver/CAN/Include/s32k144_can_capture.h"
+#include <string.h>
+
+/*******************************************************************************
+ * Macro
+ ******************************************************************************/
+
+#if defined(__GNUC__)
+#define CAN_COMPILER_BARRIER() __asm volatile ("" ::: "memory")
+#else
+#define CAN_COMPILER_BARRIER()
+#endif
+
+/*******************************************************************************
+* Variables
+******************************************************************************/
+
+/* Payload words of a CAN FD frame per DLC */
+static const uint8_t CAN_capture_words_arr[16] = {0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 4, 5, 6, 8, 12, 16};
+
+/*******************************************************************************
+* Code
+******************************************************************************/
+
+/* Payload words following a record header, from its CS word */
+static inline uint8_t CAN_Capture_PayloadWords(uint32_t cs)
+{
+    uint8_t dlc = (uint8_t)((cs & CAN_MB_CS_DLC_MASK) >> CAN_MB_CS_DLC_SHIFT);
+
+    if(CAN_CAPTURE_REC_FRAME != ((cs & CAN_MB_CS_CODE_MASK) >> CAN_MB_CS_CODE_SHIFT))
+    {
+        return 0;
+    }
+    if(cs & CAN_MB_CS_EDL_MASK)
+    {
+        return CAN_capture_words_arr[dlc];
+    }
+    /* Classic frame: DLC 9-15 carry 8 bytes, a remote frame none */
+    return (cs & CAN_MB_CS_RTR_MASK) ? 0U : CAN_capture_words_arr[(dlc > 8U) ? 8U : dlc];
+}
+
+/* Rx hook: appends the frame, preceded by the pending marker records, or counts it as dropped */
+static Std_CAN_Status CAN_Capture_RxHook(CAN_Handle_type* can_handle, const CAN_MsgView_type* view)
+{
+    CAN_Capture_type* capture = (CAN_Capture_type*)can_handle->hook_context;
+    uint32_t* buffer = capture->buffer;
+    uint32_t mask = capture->mask;
+    uint32_t head = capture->head;
+    uint32_t cs = view->cs & ~CAN_MB_CS_CODE_MASK;
+    uint8_t num_words = CAN_Capture_PayloadWords(cs);
+    uint32_t needed = 2U + num_words;
+    uint32_t used;
+
+    if(view->timestamp < capture->last_timestamp)
+    {
+        capture->wraps++;
+        capture->wrap_pending = 1;
+    }
+    capture->last_timestamp = view->timestamp;
+    needed += (capture->wrap_pending ? 2U : 0U) + ((0U != capture->lost_pending) ? 2U : 0U);
+
+    used = head - capture->tail;
+    if((mask + 1U - used) < needed)
+    {
+        capture->lost_pending++;
+        capture->dropped++;
+        return CAN_E_OK;
+    }
+
+    if(0U != capture->lost_pending)
+    {
+        buffer[head++ & mask] = (uint32_t)CAN_CAPTURE_REC_LOST << CAN_MB_CS_CODE_SHIFT;
+        buffer[head++ & mask] = capture->lost_pending;
+        capture->lost_pending = 0;
+    }
+    if(capture->wrap_pending)
+    {
+        buffer[head++ & mask] = (uint32_t)CAN_CAPTURE_REC_WRAP << CAN_MB_CS_CODE_SHIFT;
+        buffer[head++ & mask] = capture->wraps;
+        capture->wrap_pending = 0;
+    }
+    buffer[head++ & mask] = cs;
+    buffer[head++ & mask] = view->id;
+    for(uint8_t idx = 0; idx < num_words; idx++)
+    {
+        buffer[head++ & mask] = view->words[idx];
+    }
+
+    /* Records complete before the reader sees them */
+    CAN_COMPILER_BARRIER();
+    capture->head = head;
+    capture->frames++;
+    if((used + needed) > capture->high_water)
+    {
+        capture->high_water = used + needed;
+    }
+
+    return CAN_E_OK;
+}
+
+Std_CAN_Status CAN_Capture_Init(CAN_Capture_type* capture, CAN_Handle_type* can_handle, uint32_t* buffer, uint32_t num_words)
+{
+    if((NULL == buffer) || (num_words < CAN_CAPTURE_MIN_WORDS) || (0U != (num_words & (num_words - 1U))))
+    {
+        return CAN_E_NOT_OK;
+    }
+
+    memset(capture, 0, sizeof(*capture));
+    capture->can_handle = can_handle;
+    capture->buffer = buffer;
+    capture->mask = num_words - 1U;
+    capture->last_timestamp = (uint16_t)can_handle->can_instance->TIMER;
+    CAN_SetHooks(can_handle, CAN_Capture_RxHook, NULL, capture);
+
+    return CAN_E_OK;
+}
+
+void CAN_Capture_DeInit(CAN_Capture_type* capture)
+{
+    CAN_SetHooks(capture->can_handle, NULL, NULL, NULL);
+}
+
+void CAN_Capture_MainFunction(CAN_Capture_type* capture)
+{
+    /* The Rx hook updates the same wrap state */
+    uint32_t primask = CAN_CRITICAL_ENTER();
+    uint16_t timer = (uint16_t)capture->can_handle->can_instance->TIMER;
+
+    /* A frame waiting for the Rx ISR is stamped at most CAN_CAPTURE_WRAP_GUARD bit times ago: close
+       after a wrap it may be stamped before it, and the sample kept stays below its timestamp */
+    if(timer >= CAN_CAPTURE_WRAP_GUARD)
+    {
+        uint16_t sample = (uint16_t)(timer - CAN_CAPTURE_WRAP_GUARD);
+        if(timer < capture->last_timestamp)
+        {
+            capture->wraps++;
+            capture->wrap_pending = 1;
+            capture->last_timestamp = sample;
+        }
+        else if(sample > capture->last_timestamp)
+        {
+            capture->last_timestamp = sample;
+        }
+        else
+        {
+            /* DO NOTHING */
+        }
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+    CAN_CRITICAL_EXIT(primask);
+}
+
+uint32_t CAN_Capture_Read(CAN_Capture_type* capture, uint8_t* stream, uint32_t size)
+{
+    const uint32_t* buffer = capture->buffer;
+    uint32_t mask = capture->mask;
+    uint32_t tail = capture->tail;
+    uint32_t head = capture->head;
+    uint32_t length = 0;
+
+    /* Buffer reads after the head that published them */
+    CAN_COMPILER_BARRIER();
+    while(tail != head)
+    {
+        uint32_t num_words = 2U + CAN_Capture_PayloadWords(buffer[tail & mask]);
+        if((length + (4U * num_words)) > size)
+        {
+            break;
+        }
+        for(uint32_t idx = 0; idx < num_words; idx++)
+        {
+            uint32_t word = buffer[tail++ & mask];
+            stream[length++] = (uint8_t)(word >> 24);
+            stream[length++] = (uint8_t)(word >> 16);
+            stream[length++] = (uint8_t)(word >> 8);
+            stream[length++] = (uint8_t)(word);
+        }
+    }
+    /* Words copied out before the ISR may overwrite them */
+    CAN_COMPILER_BARRIER();
+    capture->tail = tail;
+
+    return length;
+}
+
+/* Big endian word of a stream */
+static inline uint32_t CAN_Capture_StreamWord(const uint8_t* stream)
+{
+    return ((uint32_t)stream[0] << 24) | ((uint32_t)stream[1] << 16) | ((uint32_t)stream[2] << 8) | stream[3];
+}
+
+Std_CAN_Status CAN_Capture_Decode(CAN_CaptureDecoder_type* decoder, const uint8_t* stream, uint32_t size,
+                                  uint32_t* offset, CAN_CaptureFrame_type* frame)
+{
+    uint32_t pos = *offset;
+
+    while((pos + 8U) <= size)
+    {
+        uint32_t cs = CAN_Capture_StreamWord(&stream[pos]);
+        uint32_t value = CAN_Capture_StreamWord(&stream[pos + 4U]);
+        uint32_t type = (cs & CAN_MB_CS_CODE_MASK) >> CAN_MB_CS_CODE_SHIFT;
+        uint32_t num_bytes = 4U * CAN_Capture_PayloadWords(cs);
+
+        if(CAN_CAPTURE_REC_WRAP == type)
+        {
+            decoder->wraps = value;
+        }
+        else if(CAN_CAPTURE_REC_LOST == type)
+        {
+            decoder->lost += value;
+        }
+        else if(CAN_CAPTURE_REC_FRAME != type)
+        {
+            /* Record type of a later format, header only */
+        }
+        else if((pos + 8U + num_bytes) <= size)
+        {
+            frame->cs = cs;
+            frame->timestamp = (decoder->wraps << 16) | (cs & CAN_MB_CS_TIMESTAMP_MASK);
+            frame->frame.id = value;
+            frame->frame.dlc = (uint8_t)((cs & CAN_MB_CS_DLC_MASK) >> CAN_MB_CS_DLC_SHIFT);
+            frame->frame.timestamp = (uint16_t)(cs & CAN_MB_CS_TIMESTAMP_MASK);
+            frame->frame.priority = 0;
+            frame->frame.flags = (uint8_t)(((cs & CAN_MB_CS_IDE_MASK) ? CAN_FRAME_FLAG_IDE : 0U)
+                                         | ((cs & CAN_MB_CS_RTR_MASK) ? CAN_FRAME_FLAG_RTR : 0U)
+                                         | ((cs & CAN_MB_CS_EDL_MASK) ? CAN_FRAME_FLAG_EDL : 0U)
+                                         | ((cs & CAN_MB_CS_BRS_MASK) ? CAN_FRAME_FLAG_BRS : 0U)
+                                         | ((cs & CAN_MB_CS_ESI_MASK) ? CAN_FRAME_FLAG_ESI : 0U));
+            memcpy(frame->frame.data, &stream[pos + 8U], num_bytes);
+            *offset = pos + 8U + num_bytes;
+            return CAN_E_OK;
+        }
+        else
+        {
+            /* Frame record cut off at the end of the stream */
+            break;
+        }
+        pos += 8U;
+    }
+    *offset = pos;
+
+    return CAN_E_NOT_OK;
+}
@@ -0,0 +1,281 @@
+/**
+ * @file s32k144_can_codec.c
+ * @brief Signal packing and unpacking compiled from a DBC-like message description table.
+ *
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*******************************************************************************
+ * Inclusion
+ ******************************************************************************/
+
+#include "../src/Driver/CAN/Include/s32k144_can_codec.h"
+#include <string.h>
+
+/*******************************************************************************
+ * Macro
+ ******************************************************************************/
+
+#if defined(__GNUC__)
+#define CAN_CODEC_BSWAP32(x) __builtin_bswap32(x) /* Single REV instruction on Cortex-M4 */
+#else
+#define CAN_CODEC_BSWAP32(x) ((((x) & 0xFFU) << 24) | (((x) & 0xFF00U) << 8) | (((x) >> 8) & 0xFF00U) | ((x) >> 24))
+#endif
+
+/* Access kinds of CAN_SignalPlan_type */
+#define CAN_CODEC_BE_1WORD (0U) /* Motorola signal inside one word */
+#define CAN_CODEC_BE_2WORD (1U) /* Motorola signal across a word boundary */
+#define CAN_CODEC_LE_1WORD (2U) /* Intel signal inside one byte swapped word */
+#define CAN_CODEC_LE_2WORD (3U) /* Intel signal across a word boundary */
+
+/*******************************************************************************
+* Code
+******************************************************************************/
+
+/* Raw value of one signal from the big endian words and their byte swapped twins */
+static inline uint32_t CAN_Codec_Extract(const CAN_SignalPlan_type* sig, const uint32_t* be, const uint32_t* le)
+{
+    uint32_t value;
+
+    switch(sig->kind)
+    {
+    case CAN_CODEC_BE_1WORD:
+        value = be[sig->word] >> sig->shift;
+        break;
+    case CAN_CODEC_BE_2WORD:
+        value = (uint32_t)((((uint64_t)be[sig->word] << 32) | be[sig->word + 1U]) >> sig->shift);
+        break;
+    case CAN_CODEC_LE_1WORD:
+        value = le[sig->word] >> sig->shift;
+        break;
+    default:
+        value = (uint32_t)((((uint64_t)le[sig->word + 1U] << 32) | le[sig->word]) >> sig->shift);
+        break;
+    }
+    value &= sig->mask;
+    /* A signed 32 bit signal already fills the word, shifting by 0 would change nothing */
+    if(sig->is_signed && (0U != sig->sign_shift))
+    {
+        value = (uint32_t)((int32_t)(value << sig->sign_shift) >> sig->sign_shift);
+    }
+
+    return value;
+}
+
+/* Copies the payload words once and builds the byte swapped words Intel signals are read from */
+static void CAN_Codec_Fetch(const CAN_CodecPlan_type* plan, const volatile uint32_t* words, uint32_t* be, uint32_t* le)
+{
+    for(uint8_t idx = 0; idx < plan->num_words; idx++)
+    {
+        be[idx] = words[idx];
+    }
+    if(plan->has_intel)
+    {
+        for(uint8_t idx = 0; idx < plan->num_words; idx++)
+        {
+            le[idx] = CAN_CODEC_BSWAP32(be[idx]);
+        }
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+}
+
+Std_CAN_Status CAN_Codec_Compile(const CAN_MessageDesc_type* message, CAN_CodecPlan_type* plan)
+{
+    uint16_t num_bits = (uint16_t)(message->length * 8U);
+
+    if((message->length > CAN_MAX_PAYLOAD_BYTES) || (message->num_signals > CAN_CODEC_MAX_SIGNALS)
+    || ((NULL == message->signals) && (0U != message->num_signals)))
+    {
+        return CAN_E_NOT_OK;
+    }
+
+    plan->num_signals = message->num_signals;
+    plan->num_words = (uint8_t)((message->length + 3U) / 4U);
+    plan->has_intel = 0;
+    for(uint8_t idx = 0; idx < message->num_signals; idx++)
+    {
+        const CAN_SignalDesc_type* desc = &message->signals[idx];
+        CAN_SignalPlan_type* sig = &plan->signals[idx];
+        uint16_t lsb;
+
+        if((0U == desc->length) || (desc->length > 32U) || (0.0f == desc->factor))
+        {
+            return CAN_E_NOT_OK;
+        }
+
+        if(CAN_SIGNAL_INTEL == desc->byte_order)
+        {
+            /* Little endian payload: bit n of the byte swapped words is start bit n */
+            lsb = desc->start_bit;
+            if((uint16_t)(lsb + desc->length) > num_bits)
+            {
+                return CAN_E_NOT_OK;
+            }
+            sig->word = (uint8_t)(lsb / 32U);
+            sig->shift = (uint8_t)(lsb % 32U);
+            sig->kind = ((sig->shift + desc->length) <= 32U) ? CAN_CODEC_LE_1WORD : CAN_CODEC_LE_2WORD;
+            plan->has_intel = 1;
+        }
+        else
+        {
+            /* Big endian payload: bits counted from the MSB of byte 0 */
+            uint16_t msb = (uint16_t)((desc->start_bit & ~7U) + (7U - (desc->start_bit & 7U)));
+            lsb = (uint16_t)(msb + desc->length - 1U);
+            if(lsb >= num_bits)
+            {
+                return CAN_E_NOT_OK;
+            }
+            sig->word = (uint8_t)(msb / 32U);
+            if((lsb - (32U * sig->word)) <= 31U)
+            {
+                sig->shift = (uint8_t)(31U - (lsb - (32U * sig->word)));
+                sig->kind = CAN_CODEC_BE_1WORD;
+            }
+            else
+            {
+                sig->shift = (uint8_t)(63U - (lsb - (32U * sig->word)));
+                sig->kind = CAN_CODEC_BE_2WORD;
+            }
+        }
+
+        sig->mask = (32U == desc->length) ? 0xFFFFFFFFU : (uint32_t)((1UL << desc->length) - 1UL);
+        sig->is_signed = (0U != desc->is_signed) ? 1U : 0U;
+        sig->sign_shift = sig->is_signed ? (uint8_t)(32U - desc->length) : 0U;
+        sig->factor = desc->factor;
+        sig->offset = desc->offset;
+        sig->inv_factor = 1.0f / desc->factor;
+    }
+
+    return CAN_E_OK;
+}
+
+void CAN_Codec_LoadWords(const uint8_t* data, uint8_t length, uint32_t* words)
+{
+    uint8_t num_words = (uint8_t)((length + 3U) / 4U);
+
+    for(uint8_t idx = 0; idx < num_words; idx++)
+    {
+        uint32_t word = 0;
+        for(uint8_t byte = 0; byte < 4U; byte++)
+        {
+            uint8_t pos = (uint8_t)((idx * 4U) + byte);
+            word = (word << 8) | ((pos < length) ? data[pos] : 0U);
+        }
+        words[idx] = word;
+    }
+}
+
+void CAN_Codec_StoreWords(const uint32_t* words, uint8_t length, uint8_t* data)
+{
+    uint8_t num_words = (uint8_t)((length + 3U) / 4U);
+
+    for(uint8_t idx = 0; idx < num_words; idx++)
+    {
+        data[(idx * 4U) + 0U] = (uint8_t)(words[idx] >> 24);
+        data[(idx * 4U) + 1U] = (uint8_t)(words[idx] >> 16);
+        data[(idx * 4U) + 2U] = (uint8_t)(words[idx] >> 8);
+        data[(idx * 4U) + 3U] = (uint8_t)(words[idx]);
+    }
+}
+
+void CAN_Codec_UnpackRaw(const CAN_CodecPlan_type* plan, const volatile uint32_t* words, uint32_t* raw)
+{
+    uint32_t be[CAN_CODEC_MAX_WORDS];
+    uint32_t le[CAN_CODEC_MAX_WORDS];
+
+    CAN_Codec_Fetch(plan, words, be, le);
+    for(uint8_t idx = 0; idx < plan->num_signals; idx++)
+    {
+        raw[idx] = CAN_Codec_Extract(&plan->signals[idx], be, le);
+    }
+}
+
+void CAN_Codec_Unpack(const CAN_CodecPlan_type* plan, const volatile uint32_t* words, float* values)
+{
+    uint32_t be[CAN_CODEC_MAX_WORDS];
+    uint32_t le[CAN_CODEC_MAX_WORDS];
+
+    CAN_Codec_Fetch(plan, words, be, le);
+    for(uint8_t idx = 0; idx < plan->num_signals; idx++)
+    {
+        const CAN_SignalPlan_type* sig = &plan->signals[idx];
+        uint32_t value = CAN_Codec_Extract(sig, be, le);
+        float raw = sig->is_signed ? (float)(int32_t)value : (float)value;
+        values[idx] = (raw * sig->factor) + sig->offset;
+    }
+}
+
+void CAN_Codec_PackRaw(const CAN_CodecPlan_type* plan, const uint32_t* raw, uint32_t* words)
+{
+    for(uint8_t idx = 0; idx < plan->num_signals; idx++)
+    {
+        const CAN_SignalPlan_type* sig = &plan->signals[idx];
+        uint32_t value = raw[idx] & sig->mask;
+        uint8_t w = sig->word;
+
+        switch(sig->kind)
+        {
+        case CAN_CODEC_BE_1WORD:
+            words[w] = (words[w] & ~(sig->mask << sig->shift)) | (value << sig->shift);
+            break;
+        case CAN_CODEC_BE_2WORD:
+        {
+            uint64_t window = ((uint64_t)words[w] << 32) | words[w + 1U];
+            window = (window & ~((uint64_t)sig->mask << sig->shift)) | ((uint64_t)value << sig->shift);
+            words[w] = (uint32_t)(window >> 32);
+            words[w + 1U] = (uint32_t)window;
+            break;
+        }
+        case CAN_CODEC_LE_1WORD:
+        {
+            uint32_t le = CAN_CODEC_BSWAP32(words[w]);
+            le = (le & ~(sig->mask << sig->shift)) | (value << sig->shift);
+            words[w] = CAN_CODEC_BSWAP32(le);
+            break;
+        }
+        default:
+        {
+            uint64_t window = ((uint64_t)CAN_CODEC_BSWAP32(words[w + 1U]) << 32) | CAN_CODEC_BSWAP32(words[w]);
+            window = (window & ~((uint64_t)sig->mask << sig->shift)) | ((uint64_t)value << sig->shift);
+            words[w] = CAN_CODEC_BSWAP32((uint32_t)window);
+            words[w + 1U] = CAN_CODEC_BSWAP32((uint32_t)(window >> 32));
+            break;
+        }
+        }
+    }
+}
+
+void CAN_Codec_Pack(const CAN_CodecPlan_type* plan, const float* values, uint32_t* words)
+{
+    uint32_t raw[CAN_CODEC_MAX_SIGNALS];
+
+    for(uint8_t idx = 0; idx < plan->num_signals; idx++)
+    {
+        const CAN_SignalPlan_type* sig = &plan->signals[idx];
+        float scaled = (values[idx] - sig->offset) * sig->inv_factor;
+        scaled += (scaled >= 0.0f) ? 0.5f : -0.5f;
+
+        if(sig->is_signed)
+        {
+            /* Signed range [-2^(length-1), 2^(length-1) - 1] */
+            int32_t max = (int32_t)(sig->mask >> 1);
+            int32_t min = -max - 1;
+            raw[idx] = (scaled >= (float)max) ? (uint32_t)max
+                     : ((scaled <= (float)min) ? (uint32_t)min : (uint32_t)(int32_t)scaled);
+        }
+        else
+        {
+            raw[idx] = (scaled >= (float)sig->mask) ? sig->mask
+                     : ((scaled <= 0.0f) ? 0U : (uint32_t)scaled);
+        }
+    }
+
+    CAN_Codec_PackRaw(plan, raw, words);
+}
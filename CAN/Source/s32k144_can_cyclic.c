@@ -0,0 +1,219 @@
+/**
+ * @file s32k144_can_cyclic.c
+ * @brief Table driven transmission of periodic frames with spread release offsets.
+ *
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*******************************************************************************
+ * Inclusion
+ ******************************************************************************/
+
+#include "../src/Driver/CAN/Include/s32k144_can_cyclic.h"
+#include <string.h>
+
+/*******************************************************************************
+* Variables
+******************************************************************************/
+
+/* Nominal bits released in each tick of the hyperperiod, only used while CAN_Cyclic_Init plans */
+static uint16_t CAN_cyclic_slot_bits[CAN_CYCLIC_MAX_SLOTS];
+
+/*******************************************************************************
+* Code
+******************************************************************************/
+
+static uint32_t CAN_Cyclic_Gcd(uint32_t a, uint32_t b)
+{
+    while(0U != b)
+    {
+        uint32_t rem = a % b;
+        a = b;
+        b = rem;
+    }
+
+    return a;
+}
+
+/* Adds a message released every period ticks from offset to the hyperperiod load */
+static void CAN_Cyclic_Place(uint32_t hyper, uint32_t period, uint32_t offset, uint16_t bits)
+{
+    for(uint32_t slot = offset; slot < hyper; slot += period)
+    {
+        CAN_cyclic_slot_bits[slot] = (uint16_t)(CAN_cyclic_slot_bits[slot] + bits);
+    }
+}
+
+/* Offset whose ticks carry the least load: lowest maximum, then lowest sum */
+static uint32_t CAN_Cyclic_BestOffset(uint32_t hyper, uint32_t period)
+{
+    uint32_t best_offset = 0;
+    uint32_t best_max = 0xFFFFFFFFU;
+    uint32_t best_sum = 0xFFFFFFFFU;
+
+    for(uint32_t offset = 0; offset < period; offset++)
+    {
+        uint32_t max = 0;
+        uint32_t sum = 0;
+        for(uint32_t slot = offset; slot < hyper; slot += period)
+        {
+            sum += CAN_cyclic_slot_bits[slot];
+            if(CAN_cyclic_slot_bits[slot] > max)
+            {
+                max = CAN_cyclic_slot_bits[slot];
+            }
+        }
+        if((max < best_max) || ((max == best_max) && (sum < best_sum)))
+        {
+            best_offset = offset;
+            best_max = max;
+            best_sum = sum;
+        }
+    }
+
+    return best_offset;
+}
+
+Std_CAN_Status CAN_Cyclic_Init(CAN_Cyclic_type* cyclic, const CAN_Cyclic_Config_type* config, uint32_t now_us)
+{
+    uint32_t tick = config->tick_us;
+    uint32_t hyper = 1;
+    uint32_t placed = 0;
+
+    if((0U == tick) || (config->num_messages > CAN_CYCLIC_MAX_MESSAGES)
+    || ((NULL == config->messages) && (0U != config->num_messages)))
+    {
+        return CAN_E_NOT_OK;
+    }
+    for(uint8_t idx = 0; idx < config->num_messages; idx++)
+    {
+        const CAN_CyclicMsgConfig_type* msg = &config->messages[idx];
+        if((0U == msg->period_us) || (0U != (msg->period_us % tick))
+        || ((CAN_CYCLIC_AUTO_OFFSET != msg->offset_us) && (msg->offset_us >= msg->period_us)))
+        {
+            return CAN_E_NOT_OK;
+        }
+        uint32_t period = msg->period_us / tick;
+        hyper = (hyper / CAN_Cyclic_Gcd(hyper, period)) * period;
+        if(hyper > CAN_CYCLIC_MAX_SLOTS)
+        {
+            return CAN_E_NOT_OK;
+        }
+    }
+
+    cyclic->can_handle = config->can_handle;
+    cyclic->num_messages = config->num_messages;
+    memset(CAN_cyclic_slot_bits, 0, sizeof(CAN_cyclic_slot_bits));
+
+    /* Fixed offsets first, counted in the tick they fall into */
+    for(uint8_t idx = 0; idx < config->num_messages; idx++)
+    {
+        const CAN_CyclicMsgConfig_type* msg = &config->messages[idx];
+        CAN_CyclicMsg_type* state = &cyclic->messages[idx];
+
+        memset(state, 0, sizeof(*state));
+        state->config = msg;
+        if(CAN_CYCLIC_AUTO_OFFSET != msg->offset_us)
+        {
+            state->offset_us = msg->offset_us;
+            CAN_Cyclic_Place(hyper, msg->period_us / tick, msg->offset_us / tick,
+                             (uint16_t)(47U + (8U * CAN_DlcToLength(config->can_handle, msg->dlc))));
+            placed |= (uint32_t)(1UL << idx);
+        }
+    }
+
+    /* Then the automatic offsets, shortest period first as it has the fewest choices per release */
+    while(placed != ((config->num_messages >= 32U) ? 0xFFFFFFFFU : (uint32_t)((1UL << config->num_messages) - 1U)))
+    {
+        uint8_t next = 0;
+        uint32_t next_period = 0xFFFFFFFFU;
+        for(uint8_t idx = 0; idx < config->num_messages; idx++)
+        {
+            if((0U == (placed & (1UL << idx))) && (config->messages[idx].period_us < next_period))
+            {
+                next = idx;
+                next_period = config->messages[idx].period_us;
+            }
+        }
+        uint32_t offset = CAN_Cyclic_BestOffset(hyper, next_period / tick);
+        CAN_Cyclic_Place(hyper, next_period / tick, offset,
+                         (uint16_t)(47U + (8U * CAN_DlcToLength(config->can_handle, config->messages[next].dlc))));
+        cyclic->messages[next].offset_us = offset * tick;
+        placed |= (uint32_t)(1UL << next);
+    }
+
+    cyclic->peak_slot_bits = 0;
+    for(uint32_t slot = 0; slot < hyper; slot++)
+    {
+        if(CAN_cyclic_slot_bits[slot] > cyclic->peak_slot_bits)
+        {
+            cyclic->peak_slot_bits = CAN_cyclic_slot_bits[slot];
+        }
+    }
+    for(uint8_t idx = 0; idx < config->num_messages; idx++)
+    {
+        cyclic->messages[idx].next_us = now_us + cyclic->messages[idx].offset_us;
+    }
+
+    return CAN_E_OK;
+}
+
+Std_CAN_Status CAN_Cyclic_Update(CAN_Cyclic_type* cyclic, uint8_t msg, const uint8_t* data)
+{
+    if(msg >= cyclic->num_messages)
+    {
+        return CAN_E_NOT_OK;
+    }
+    memcpy(cyclic->messages[msg].data, data, CAN_DlcToLength(cyclic->can_handle, cyclic->messages[msg].config->dlc));
+
+    return CAN_E_OK;
+}
+
+void CAN_Cyclic_MainFunction(CAN_Cyclic_type* cyclic, uint32_t now_us)
+{
+    CAN_Handle_type* can_handle = cyclic->can_handle;
+
+    for(uint8_t idx = 0; idx < cyclic->num_messages; idx++)
+    {
+        CAN_CyclicMsg_type* msg = &cyclic->messages[idx];
+        const CAN_CyclicMsgConfig_type* config = msg->config;
+        int32_t late = (int32_t)(now_us - msg->next_us);
+
+        if(late >= 0)
+        {
+            CAN_Frame_type frame;
+            uint32_t replaced = can_handle->stats.tx_replaced;
+            uint32_t missed = (uint32_t)late / config->period_us;
+
+            /* Only the latest of several overdue releases is sent, the grid is kept */
+            msg->skipped += missed;
+            msg->next_us += (missed + 1U) * config->period_us;
+
+            frame.id = config->id;
+            frame.dlc = config->dlc;
+            frame.priority = config->priority;
+            frame.flags = 0;
+            memcpy(frame.data, msg->data, CAN_DlcToLength(can_handle, config->dlc));
+            if(CAN_E_OK == CAN_TransmitLatest(can_handle, &frame))
+            {
+                msg->releases++;
+                if(replaced != can_handle->stats.tx_replaced)
+                {
+                    msg->replaced++;
+                }
+            }
+            else
+            {
+                msg->rejected++;
+            }
+        }
+        else
+        {
+            /* DO NOTHING */
+        }
+    }
+}
@@ -1,260 +1,2870 @@
 #include "../src/Driver/CAN/Include/s32k144_can_driver.h"
 //#include "../scr/Driver/CAN/Include/s32k144_can_driver.h"
+#include <string.h>
 
-uint8_t msg_buff_size = 0;
-uint8_t num_msg_buff = 0;
+#if defined(__GNUC__)
+#define CAN_COMPILER_BARRIER() __asm volatile ("" ::: "memory")
+#else
+#define CAN_COMPILER_BARRIER()
+#endif
 
-Std_CAN_Status CAN_BitRateConfig(CAN_Type* can_instance, CAN_Bit_Timing_type* bit_rate_config)
+#if defined(__GNUC__)
+#define CAN_CLZ(x) ((uint8_t)__builtin_clz(x)) /* Single CLZ instruction on Cortex-M4 */
+#else
+static inline uint8_t CAN_CLZ(uint32_t x)
+{
+    uint8_t n = 0;
+    while(0U == (x & 0x80000000U))
+    {
+        x <<= 1;
+        n++;
+    }
+    return n;
+}
+#endif
+
+#ifdef CAN_SIM
+/* Host build: the simulator produces the MCR acknowledges and the write-1-to-clear behaviour of IFLAG1 */
+#define CAN_WAIT_WHILE(can_instance, cond)   while(cond) { CAN_Sim_Poll(can_instance); }
+#define CAN_CLEAR_IFLAG1(can_instance, mask) CAN_Sim_ClearFlags((can_instance), (mask))
+#define CAN_CLEAR_ESR1(can_instance, mask)   ((can_instance)->ESR1 &= ~(mask))
+#define CAN_CLEAR_WU_MTC(can_instance, mask) ((can_instance)->WU_MTC &= ~(mask))
+#else
+#define CAN_WAIT_WHILE(can_instance, cond)   while(cond) { /* DO NOTHING */ }
+#define CAN_CLEAR_IFLAG1(can_instance, mask) ((can_instance)->IFLAG1 = (mask))
+#define CAN_CLEAR_ESR1(can_instance, mask)   ((can_instance)->ESR1 = (mask))
+#define CAN_CLEAR_WU_MTC(can_instance, mask) ((can_instance)->WU_MTC = (mask))
+#endif
+
+/* ESR1 interrupt flags (write 1 to clear) handled by CAN_ErrorIRQHandler */
+#define CAN_ESR1_EVENT_MASK (CAN_ESR1_ERRINT_MASK | CAN_ESR1_ERRINT_FAST_MASK | CAN_ESR1_BOFFINT_MASK | CAN_ESR1_BOFFDONEINT_MASK)
+
+/* CAN_Handle_type.busoff_step of a fast bus off recovery */
+#define CAN_BUSOFF_STEP_IDLE     (0U)
+#define CAN_BUSOFF_STEP_FREEZE   (1U) /* Freeze mode requested, ECR is cleared once acknowledged */
+#define CAN_BUSOFF_STEP_RESUME   (2U) /* Freeze mode left, the state is reported once the controller is ready */
+
+/* ESR1 error bits, cleared by reading ESR1 */
+#define CAN_ESR1_ERROR_MASK (CAN_ESR1_STFERR_MASK | CAN_ESR1_FRMERR_MASK | CAN_ESR1_CRCERR_MASK | CAN_ESR1_ACKERR_MASK \
+                           | CAN_ESR1_BIT0ERR_MASK | CAN_ESR1_BIT1ERR_MASK | CAN_ESR1_STFERR_FAST_MASK             \
+                           | CAN_ESR1_FRMERR_FAST_MASK | CAN_ESR1_CRCERR_FAST_MASK | CAN_ESR1_BIT0ERR_FAST_MASK    \
+                           | CAN_ESR1_BIT1ERR_FAST_MASK)
+
+#ifdef CAN_STATS_ENABLE
+#define CAN_STATS_INIT(can_handle)                      CAN_ResetStats(can_handle)
+#define CAN_STATS_TX_QUEUED(can_handle)                 CAN_StatsTxQueued(can_handle)
+#define CAN_STATS_TX_LOADED(can_handle, idx_mb, frame)  ((can_handle)->stats_state.tx_queued_at[idx_mb] = (frame)->timestamp)
+#define CAN_STATS_TX_FORWARDED(can_handle, idx_mb)      ((can_handle)->stats_state.tx_queued_at[idx_mb] = (uint16_t)(can_handle)->can_instance->TIMER)
+#define CAN_STATS_TX_ABORTED(can_handle, idx_mb, frame) ((frame)->timestamp = (can_handle)->stats_state.tx_queued_at[idx_mb])
+#define CAN_STATS_TX_DONE(can_handle, idx_mb)           CAN_StatsTxDone((can_handle), (idx_mb))
+#define CAN_STATS_RX(can_handle, idx_mb, id, cs)        CAN_StatsRx((can_handle), (idx_mb), (id), (cs))
+#define CAN_STATS_RX_OVERRUN(can_handle, idx_mb)        ((can_handle)->stats_state.live.mbs[idx_mb].rx_overrun++)
+#else
+/* Statistics compiled out: no TIMER reads or counters on the hot path */
+#define CAN_STATS_INIT(can_handle)                      ((void)0)
+#define CAN_STATS_TX_QUEUED(can_handle)                 ((void)0)
+#define CAN_STATS_TX_LOADED(can_handle, idx_mb, frame)  ((void)0)
+#define CAN_STATS_TX_FORWARDED(can_handle, idx_mb)      ((void)0)
+#define CAN_STATS_TX_ABORTED(can_handle, idx_mb, frame) ((void)0)
+#define CAN_STATS_TX_DONE(can_handle, idx_mb)           ((void)0)
+#define CAN_STATS_RX(can_handle, idx_mb, id, cs)        ((void)(cs))
+#define CAN_STATS_RX_OVERRUN(can_handle, idx_mb)        ((void)0)
+#endif
+
+/* Index of the lowest set bit of a non-zero message buffer map */
+#define CAN_LOWEST_MB(map) ((uint8_t)(31U - CAN_CLZ((map) & (0U - (map)))))
+
+/* CAN_TxLimitCheck result of a frame within its limit, next to the CAN_TX_LIMIT_POLICY_type values */
+#define CAN_TX_LIMIT_PASS (0xFFU)
+
+/* Handles serviced by the CANx interrupt vectors, bound in CAN_Init */
+static CAN_Handle_type* CAN_handle_arr[CAN_INSTANCE_COUNT] = {NULL};
+
+/* Payload bytes of each DLC code (CAN FD), CAN 2.0 caps codes 9-15 at 8 bytes */
+static const uint8_t CAN_dlc_length_arr[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64};
+
+/* Words per message buffer of each CAN_PAYLOAD_type (FDCTRL[MBDSRn] value) */
+static const uint8_t CAN_payload_words_arr[4] = {4, 6, 10, 18};
+
+/* Payload words to copy for dlc, limited to what message buffer idx_mb can hold */
+static uint8_t CAN_DlcToWords(const CAN_Handle_type* can_handle, uint8_t idx_mb, uint8_t dlc)
+{
+    uint8_t num_words = (uint8_t)((CAN_DlcToLength(can_handle, dlc) + 3U) / 4U);
+    uint8_t mb_payload_words = (uint8_t)(can_handle->mb_map.mb_words[idx_mb] - 2U);
+    if(num_words > mb_payload_words)
+    {
+        num_words = mb_payload_words;
+    }
+
+    return num_words;
+}
+
+/* Smallest CAN_PAYLOAD_type holding length bytes */
+static uint8_t CAN_PayloadType(uint8_t length)
+{
+    uint8_t payload = PAYLOAD_8_BYTES;
+    while((payload < PAYLOAD_64_BYTES) && (length > (uint8_t)((CAN_payload_words_arr[payload] - 2U) * 4U)))
+    {
+        payload++;
+    }
+
+    return payload;
+}
+
+/* Tx message buffers large enough for a frame with this DLC */
+static inline uint32_t CAN_TxFitMask(const CAN_Handle_type* can_handle, uint8_t dlc)
+{
+    return can_handle->tx_mb_mask & can_handle->mb_map.payload_mb_mask[CAN_PayloadType(CAN_DlcToLength(can_handle, dlc))];
+}
+
+/* Message buffer payload words are big endian: byte 0 is in bits 31-24 */
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+/* One unaligned-safe load plus REV per word */
+static inline uint32_t CAN_LoadPayloadWord(const uint8_t* data)
+{
+    uint32_t word;
+    memcpy(&word, data, sizeof(word));
+    return __builtin_bswap32(word);
+}
+
+static inline void CAN_StorePayloadWord(uint8_t* data, uint32_t word)
+{
+    word = __builtin_bswap32(word);
+    memcpy(data, &word, sizeof(word));
+}
+#elif defined(__GNUC__) && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+static inline uint32_t CAN_LoadPayloadWord(const uint8_t* data)
+{
+    uint32_t word;
+    memcpy(&word, data, sizeof(word));
+    return word;
+}
+
+static inline void CAN_StorePayloadWord(uint8_t* data, uint32_t word)
+{
+    memcpy(data, &word, sizeof(word));
+}
+#else
+/* Portable fallback for unknown compilers and byte orders */
+static inline uint32_t CAN_LoadPayloadWord(const uint8_t* data)
+{
+    return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | (uint32_t)data[3];
+}
+
+static inline void CAN_StorePayloadWord(uint8_t* data, uint32_t word)
+{
+    data[0] = (uint8_t)(word >> 24);
+    data[1] = (uint8_t)(word >> 16);
+    data[2] = (uint8_t)(word >> 8);
+    data[3] = (uint8_t)(word);
+}
+#endif
+
+#define CAN_PUT_WORD(n) (mb_data[(n)] = CAN_LoadPayloadWord(&data[(n) * 4U]))
+#define CAN_GET_WORD(n) CAN_StorePayloadWord(&data[(n) * 4U], mb_data[(n)])
+
+/* Unrolled copy of num_words payload words into a message buffer, each MB word is written once.
+ * Entering the switch at the word count gives the 8/16/32/64 byte kernels (2/4/8/16 words)
+ * and the intermediate CAN FD sizes without a loop. */
+static void CAN_WritePayload(volatile uint32_t* mb_data, const uint8_t* data, uint8_t num_words)
+{
+    switch(num_words)
+    {
+    case 16U:
+        CAN_PUT_WORD(15U); /* fall through */
+    case 15U:
+        CAN_PUT_WORD(14U); /* fall through */
+    case 14U:
+        CAN_PUT_WORD(13U); /* fall through */
+    case 13U:
+        CAN_PUT_WORD(12U); /* fall through */
+    case 12U:
+        CAN_PUT_WORD(11U); /* fall through */
+    case 11U:
+        CAN_PUT_WORD(10U); /* fall through */
+    case 10U:
+        CAN_PUT_WORD(9U); /* fall through */
+    case 9U:
+        CAN_PUT_WORD(8U); /* fall through */
+    case 8U:
+        CAN_PUT_WORD(7U); /* fall through */
+    case 7U:
+        CAN_PUT_WORD(6U); /* fall through */
+    case 6U:
+        CAN_PUT_WORD(5U); /* fall through */
+    case 5U:
+        CAN_PUT_WORD(4U); /* fall through */
+    case 4U:
+        CAN_PUT_WORD(3U); /* fall through */
+    case 3U:
+        CAN_PUT_WORD(2U); /* fall through */
+    case 2U:
+        CAN_PUT_WORD(1U); /* fall through */
+    case 1U:
+        CAN_PUT_WORD(0U); /* fall through */
+    default:
+        break;
+    }
+}
+
+/* Unrolled copy of num_words payload words out of a message buffer, each MB word is read once */
+static void CAN_ReadPayload(const volatile uint32_t* mb_data, uint8_t* data, uint8_t num_words)
+{
+    switch(num_words)
+    {
+    case 16U:
+        CAN_GET_WORD(15U); /* fall through */
+    case 15U:
+        CAN_GET_WORD(14U); /* fall through */
+    case 14U:
+        CAN_GET_WORD(13U); /* fall through */
+    case 13U:
+        CAN_GET_WORD(12U); /* fall through */
+    case 12U:
+        CAN_GET_WORD(11U); /* fall through */
+    case 11U:
+        CAN_GET_WORD(10U); /* fall through */
+    case 10U:
+        CAN_GET_WORD(9U); /* fall through */
+    case 9U:
+        CAN_GET_WORD(8U); /* fall through */
+    case 8U:
+        CAN_GET_WORD(7U); /* fall through */
+    case 7U:
+        CAN_GET_WORD(6U); /* fall through */
+    case 6U:
+        CAN_GET_WORD(5U); /* fall through */
+    case 5U:
+        CAN_GET_WORD(4U); /* fall through */
+    case 4U:
+        CAN_GET_WORD(3U); /* fall through */
+    case 3U:
+        CAN_GET_WORD(2U); /* fall through */
+    case 2U:
+        CAN_GET_WORD(1U); /* fall through */
+    case 1U:
+        CAN_GET_WORD(0U); /* fall through */
+    default:
+        break;
+    }
+}
+
+#ifdef CAN_SIM
+void CAN_Sim_WritePayload(volatile uint32_t* mb_data, const uint8_t* data, uint8_t num_words)
+{
+    CAN_WritePayload(mb_data, data, num_words);
+}
+
+void CAN_Sim_ReadPayload(const volatile uint32_t* mb_data, uint8_t* data, uint8_t num_words)
+{
+    CAN_ReadPayload(mb_data, data, num_words);
+}
+#endif
+
+/* CAN_FRAME_FLAG_* of a received CS word */
+static inline uint8_t CAN_FrameFlags(uint32_t cs)
+{
+    return (uint8_t)(((cs & CAN_MB_CS_IDE_MASK) ? CAN_FRAME_FLAG_IDE : 0U)
+                   | ((cs & CAN_MB_CS_RTR_MASK) ? CAN_FRAME_FLAG_RTR : 0U)
+                   | ((cs & CAN_MB_CS_EDL_MASK) ? CAN_FRAME_FLAG_EDL : 0U)
+                   | ((cs & CAN_MB_CS_BRS_MASK) ? CAN_FRAME_FLAG_BRS : 0U)
+                   | ((cs & CAN_MB_CS_ESI_MASK) ? CAN_FRAME_FLAG_ESI : 0U));
+}
+
+/* MB ID word of an identifier in the format given by CAN_FRAME_FLAG_IDE */
+static inline uint32_t CAN_MsgIdWord(uint32_t id, uint8_t flags)
+{
+    return (flags & CAN_FRAME_FLAG_IDE) ? (id & CAN_MB_ID_EXT_MASK)
+                                        : ((id << CAN_WMBn_CS_STD_ID_SHIFT) & CAN_MB_ID_STD_MASK);
+}
+
+/* Copies one flagged Rx message buffer into frame and returns its CS word. Reading CS locks the MB; the caller
+   clears its IFLAG1 bit and only then unlocks it by reading TIMER, so a frame arriving next keeps its flag */
+static uint32_t CAN_ReadMsgBuff(CAN_Handle_type* can_handle, uint8_t idx_mb, CAN_Frame_type* frame)
+{
+    CAN_Type* CAN_instance = can_handle->can_instance;
+    uint32_t base = can_handle->mb_map.mb_base[idx_mb];
+    uint32_t cs = CAN_instance->RAMn[base];
+    uint32_t id = CAN_instance->RAMn[base + 1];
+
+    if(cs & CAN_MB_CS_IDE_MASK)
+    {
+        frame->id = id & CAN_MB_ID_EXT_MASK;
+    }
+    else
+    {
+        frame->id = (id & CAN_MB_ID_STD_MASK) >> CAN_WMBn_CS_STD_ID_SHIFT;
+    }
+    frame->dlc = (uint8_t)((cs & CAN_MB_CS_DLC_MASK) >> CAN_MB_CS_DLC_SHIFT);
+    frame->timestamp = (uint16_t)(cs & CAN_MB_CS_TIMESTAMP_MASK);
+    frame->flags = CAN_FrameFlags(cs);
+
+    /* A remote frame carries no payload, its DLC is the requested length */
+    if(0U == (cs & CAN_MB_CS_RTR_MASK))
+    {
+        CAN_ReadPayload(&CAN_instance->RAMn[base + 2], frame->data, CAN_DlcToWords(can_handle, idx_mb, frame->dlc));
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+
+    return cs;
+}
+
+/* MB ID word of a Tx frame: PRIO above the identifier, so lower keys win the internal and bus arbitration */
+static inline uint32_t CAN_TxKey(const CAN_Frame_type* frame)
+{
+    return ((uint32_t)(frame->priority & 0x7U) << CAN_MB_ID_PRIO_SHIFT) | CAN_MsgIdWord(frame->id, frame->flags);
+}
+
+/* Tx CS word without CODE: a remote frame is always sent in CAN 2.0 format, SRR only precedes an extended identifier */
+static inline uint32_t CAN_TxCsWord(const CAN_Handle_type* can_handle, uint8_t flags, uint8_t dlc)
+{
+    uint32_t cs = (flags & CAN_FRAME_FLAG_RTR) ? CAN_MB_CS_RTR_MASK : can_handle->tx_cs_flags;
+
+    if(flags & CAN_FRAME_FLAG_IDE)
+    {
+        cs |= CAN_MB_CS_IDE_MASK | CAN_MB_CS_SRR_MASK;
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+
+    return cs | ((uint32_t)dlc << CAN_MB_CS_DLC_SHIFT);
+}
+
+/* Loads frame into an inactive Tx message buffer whose IFLAG1 bit is already clear and requests its transmission */
+static void CAN_WriteMsgBuff(CAN_Handle_type* can_handle, uint8_t idx_mb, const CAN_Frame_type* frame)
+{
+    CAN_Type* CAN_instance = can_handle->can_instance;
+    uint32_t base = can_handle->mb_map.mb_base[idx_mb];
+
+    CAN_instance->RAMn[base + 1] = CAN_TxKey(frame);
+
+    if(0U == (frame->flags & CAN_FRAME_FLAG_RTR))
+    {
+        CAN_WritePayload(&CAN_instance->RAMn[base + 2], frame->data, CAN_DlcToWords(can_handle, idx_mb, frame->dlc));
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+
+    CAN_instance->RAMn[base] = CAN_TxCsWord(can_handle, frame->flags, frame->dlc)
+                             | ((uint32_t)CAN_MB_CODE_TX_DATA << CAN_MB_CS_CODE_SHIFT);
+    can_handle->stats.tx_frames++;
+}
+
+#ifdef CAN_STATS_ENABLE
+/* Adds the TIMER ticks since the last call to the bus load window */
+static void CAN_StatsElapse(CAN_Handle_type* can_handle)
+{
+    CAN_StatsState_type* state = &can_handle->stats_state;
+    uint16_t timer = (uint16_t)can_handle->can_instance->TIMER;
+
+    state->live.bus_ticks += (uint16_t)(timer - state->last_timer);
+    state->last_timer = timer;
+}
+
+/* Counter slot of an identifier, added on first sight. NULL once CAN_STATS_MAX_IDS are tracked */
+static CAN_IdStats_type* CAN_StatsFindId(CAN_StatsSnapshot_type* live, uint32_t id)
+{
+    CAN_IdStats_type* entry = NULL;
+
+    for(uint8_t idx = 0; idx < live->num_ids; idx++)
+    {
+        if(live->ids[idx].id == id)
+        {
+            entry = &live->ids[idx];
+            break;
+        }
+    }
+    if((NULL == entry) && (live->num_ids < CAN_STATS_MAX_IDS))
+    {
+        entry = &live->ids[live->num_ids++];
+        entry->id = id;
+    }
+    else if(NULL == entry)
+    {
+        live->untracked_frames++;
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+
+    return entry;
+}
+
+/* Frame length in nominal bit times from the CS word, stuff bits excluded */
+static uint32_t CAN_StatsFrameBits(const CAN_StatsState_type* state, uint32_t cs, uint8_t dlc)
+{
+    uint32_t ext = (0U != (cs & CAN_MB_CS_IDE_MASK));
+    uint32_t bits;
+
+    if(cs & CAN_MB_CS_EDL_MASK)
+    {
+        uint32_t length = CAN_dlc_length_arr[dlc];
+        /* ESI, DLC, payload, stuff count, CRC17/21 with its fixed stuff bits, CRC delimiter */
+        uint32_t data_bits = 5U + (8U * length) + 4U + ((length > 16U) ? (21U + 7U) : (17U + 6U)) + 1U;
+        /* Arbitration up to BRS, then ACK, EOF and intermission */
+        bits = (ext ? 36U : 17U) + 12U;
+        if(cs & CAN_MB_CS_BRS_MASK)
+        {
+            bits += (data_bits * state->data_bit_q8) >> 8;
+        }
+        else
+        {
+            bits += data_bits;
+        }
+    }
+    else
+    {
+        /* A remote frame carries no data field */
+        uint32_t length = (cs & CAN_MB_CS_RTR_MASK) ? 0U : ((dlc > 8U) ? 8U : dlc);
+        bits = (ext ? 67U : 47U) + (8U * length);
+    }
+
+    return bits;
+}
+
+static void CAN_StatsTxQueued(CAN_Handle_type* can_handle)
+{
+    CAN_TxQueue_type* queue = &can_handle->tx_queue;
+    CAN_StatsState_type* state = &can_handle->stats_state;
+
+    /* CAN_TxQueuePush took the slot just above the remaining free slot stack */
+    queue->frames[queue->free_slots[CAN_TX_QUEUE_SIZE - queue->count]].timestamp = (uint16_t)can_handle->can_instance->TIMER;
+    if(queue->count > state->live.tx_queue_high_water)
+    {
+        state->live.tx_queue_high_water = queue->count;
+    }
+}
+
+static void CAN_StatsTxDone(CAN_Handle_type* can_handle, uint8_t idx_mb)
+{
+    CAN_Type* CAN_instance = can_handle->can_instance;
+    CAN_StatsState_type* state = &can_handle->stats_state;
+    uint32_t base = can_handle->mb_map.mb_base[idx_mb];
+    uint32_t cs = CAN_instance->RAMn[base];
+    uint32_t id = CAN_instance->RAMn[base + 1U];
+    uint8_t dlc = (uint8_t)((cs & CAN_MB_CS_DLC_MASK) >> CAN_MB_CS_DLC_SHIFT);
+
+    id = (cs & CAN_MB_CS_IDE_MASK) ? ((id & CAN_MB_ID_EXT_MASK) | CAN_STATS_ID_EXT_FLAG)
+                                   : ((id & CAN_MB_ID_STD_MASK) >> CAN_WMBn_CS_STD_ID_SHIFT);
+    state->live.mbs[idx_mb].tx_frames++;
+    state->live.bus_bits += CAN_StatsFrameBits(state, cs, dlc);
+    CAN_StatsElapse(can_handle);
+
+    CAN_IdStats_type* entry = CAN_StatsFindId(&state->live, id);
+    if(NULL != entry)
+    {
+        uint16_t latency = (uint16_t)((cs & CAN_MB_CS_TIMESTAMP_MASK) - state->tx_queued_at[idx_mb]);
+        uint8_t bucket = 0;
+        if(latency >= 128U)
+        {
+            bucket = (uint8_t)((31U - CAN_CLZ(latency)) - 6U);
+            if(bucket >= CAN_STATS_LATENCY_BUCKETS)
+            {
+                bucket = CAN_STATS_LATENCY_BUCKETS - 1U;
+            }
+        }
+        entry->tx_frames++;
+        entry->tx_latency_hist[bucket]++;
+        if(latency > entry->tx_latency_max)
+        {
+            entry->tx_latency_max = latency;
+        }
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+}
+
+static void CAN_StatsRx(CAN_Handle_type* can_handle, uint8_t idx_mb, uint32_t id, uint32_t cs)
+{
+    CAN_StatsState_type* state = &can_handle->stats_state;
+    uint8_t dlc = (uint8_t)((cs & CAN_MB_CS_DLC_MASK) >> CAN_MB_CS_DLC_SHIFT);
+
+    id = (cs & CAN_MB_CS_IDE_MASK) ? (id | CAN_STATS_ID_EXT_FLAG) : id;
+
+    state->live.mbs[idx_mb].rx_frames++;
+    if(CAN_MB_CODE_RX_OVERRUN == ((cs & CAN_MB_CS_CODE_MASK) >> CAN_MB_CS_CODE_SHIFT))
+    {
+        state->live.mbs[idx_mb].rx_overrun++;
+    }
+    state->live.bus_bits += CAN_StatsFrameBits(state, cs, dlc);
+    CAN_StatsElapse(can_handle);
+
+    CAN_IdStats_type* entry = CAN_StatsFindId(&state->live, id);
+    if(NULL != entry)
+    {
+        entry->rx_frames++;
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+}
+#endif
+
+/* Queue slot a is sent before slot b */
+static inline uint8_t CAN_TxQueueBefore(const CAN_TxQueue_type* queue, uint8_t a, uint8_t b)
+{
+    return (queue->key[a] < queue->key[b])
+        || ((queue->key[a] == queue->key[b]) && ((int32_t)(queue->order[a] - queue->order[b]) < 0));
+}
+
+/* Inserts a frame into the Tx queue heap, the queue must not be full */
+static void CAN_TxQueuePush(CAN_TxQueue_type* queue, const CAN_Frame_type* frame, uint32_t order, uint32_t tag)
+{
+    uint8_t slot = queue->free_slots[CAN_TX_QUEUE_SIZE - 1U - queue->count];
+    uint8_t pos = queue->count;
+
+    queue->frames[slot] = *frame;
+    queue->key[slot] = CAN_TxKey(frame);
+    queue->order[slot] = order;
+    queue->tag[slot] = tag;
+    while(pos > 0U)
+    {
+        uint8_t parent = (uint8_t)((pos - 1U) / 2U);
+        if(!CAN_TxQueueBefore(queue, slot, queue->heap[parent]))
+        {
+            break;
+        }
+        queue->heap[pos] = queue->heap[parent];
+        pos = parent;
+    }
+    queue->heap[pos] = slot;
+    queue->count++;
+}
+
+/* Removes the first ranked frame from the Tx queue heap */
+static void CAN_TxQueuePop(CAN_TxQueue_type* queue)
+{
+    uint8_t top = queue->heap[0];
+    uint8_t count = (uint8_t)(queue->count - 1U);
+    uint8_t last = queue->heap[count];
+    uint8_t pos = 0;
+
+    while(1)
+    {
+        uint8_t child = (uint8_t)((2U * pos) + 1U);
+        if(child >= count)
+        {
+            break;
+        }
+        if(((child + 1U) < count) && CAN_TxQueueBefore(queue, queue->heap[child + 1U], queue->heap[child]))
+        {
+            child++;
+        }
+        if(!CAN_TxQueueBefore(queue, queue->heap[child], last))
+        {
+            break;
+        }
+        queue->heap[pos] = queue->heap[child];
+        pos = child;
+    }
+    queue->heap[pos] = last;
+    queue->count = count;
+    queue->free_slots[CAN_TX_QUEUE_SIZE - 1U - count] = top;
+}
+
+/* Empties the Tx queue, the free slot stack holds every slot again */
+static void CAN_TxQueueReset(CAN_TxQueue_type* queue)
+{
+    queue->count = 0;
+    for(uint8_t slot = 0; slot < CAN_TX_QUEUE_SIZE; slot++)
+    {
+        queue->free_slots[slot] = slot;
+    }
+}
+
+/* Reports a sent frame to the Tx done hook when it was queued with a tag */
+static inline void CAN_TxDone(CAN_Handle_type* can_handle, uint8_t idx_mb)
+{
+    if((0U != can_handle->tx_mb_tag[idx_mb]) && (NULL != can_handle->tx_done_hook))
+    {
+        can_handle->tx_done_hook(can_handle, can_handle->tx_mb_tag[idx_mb]);
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+}
+
+/* Free Tx message buffers of fit_map a frame with this ID word may be loaded into */
+static uint32_t CAN_TxFreeMap(const CAN_Handle_type* can_handle, uint32_t key, uint32_t fit_map)
+{
+    uint32_t free_map = can_handle->tx_free_map & fit_map;
+    uint32_t same_map = 0;
+
+    /* Equal ID words leave lowest MB first, so a frame must go above every loaded one with its key */
+    for(uint32_t map = can_handle->tx_mb_mask & ~can_handle->tx_free_map; 0U != map; map &= (map - 1U))
+    {
+        uint8_t idx_mb = CAN_LOWEST_MB(map);
+        if(can_handle->tx_mb_key[idx_mb] == key)
+        {
+            same_map |= (uint32_t)(1UL << idx_mb);
+        }
+    }
+    if(0U != same_map)
+    {
+        uint8_t last_mb = (uint8_t)(31U - CAN_CLZ(same_map));
+        free_map &= (31U == last_mb) ? 0U : ~((2UL << last_mb) - 1U);
+    }
+
+    return free_map;
+}
+
+/* Adds the TIMER ticks since the last refill to every Tx limit bucket */
+static void CAN_TxLimitRefill(CAN_Handle_type* can_handle)
+{
+    uint16_t timer = (uint16_t)can_handle->can_instance->TIMER;
+    uint32_t elapsed = (uint16_t)(timer - can_handle->tx_limit_timer);
+
+    can_handle->tx_limit_timer = timer;
+    for(uint8_t idx = 0; idx < can_handle->num_tx_limits; idx++)
+    {
+        CAN_TxLimitClass_type* limit_class = &can_handle->tx_limit[idx];
+        uint32_t full = 1000U * limit_class->limit.burst_bits;
+        uint32_t credit = limit_class->credit + (elapsed * limit_class->limit.load_permille);
+        limit_class->credit = (credit > full) ? full : credit;
+    }
+}
+
+/* Charges a frame to the first Tx limit class it matches. CAN_TX_LIMIT_PASS or the policy of a class over its limit */
+static uint8_t CAN_TxLimitCheck(CAN_Handle_type* can_handle, uint32_t id, uint8_t flags, uint8_t dlc)
+{
+    uint8_t result = CAN_TX_LIMIT_PASS;
+
+    if(0U == can_handle->num_tx_limits)
+    {
+        return CAN_TX_LIMIT_PASS;
+    }
+
+    CAN_TxLimitRefill(can_handle);
+    for(uint8_t idx = 0; idx < can_handle->num_tx_limits; idx++)
+    {
+        CAN_TxLimitClass_type* limit_class = &can_handle->tx_limit[idx];
+        if(((id & limit_class->limit.mask) == limit_class->limit.match)
+        && (0U == ((flags ^ limit_class->limit.flags) & CAN_FRAME_FLAG_IDE)))
+        {
+            /* Nominal CAN 2.0 length, the remote frame without data field */
+            uint32_t length = (flags & CAN_FRAME_FLAG_RTR) ? 0U : CAN_DlcToLength(can_handle, dlc);
+            uint32_t cost = 1000U * (((flags & CAN_FRAME_FLAG_IDE) ? 67U : 47U) + (8U * length));
+            if(limit_class->credit >= cost)
+            {
+                limit_class->credit -= cost;
+                limit_class->stats.passed++;
+            }
+            else if(TX_LIMIT_DROP == limit_class->limit.policy)
+            {
+                limit_class->stats.dropped++;
+                result = TX_LIMIT_DROP;
+            }
+            else
+            {
+                limit_class->stats.deferred++;
+                result = TX_LIMIT_DEFER;
+            }
+            break;
+        }
+    }
+
+    return result;
+}
+
+/* Keeps the highest ranked frames in the Tx message buffers: loads the first queued frame into a free MB
+   large enough for it, or aborts the lowest ranked loaded frame below it. Caller keeps the Tx interrupts masked */
+static void CAN_ScheduleTx(CAN_Handle_type* can_handle)
+{
+    CAN_Type* CAN_instance = can_handle->can_instance;
+    CAN_TxQueue_type* queue = &can_handle->tx_queue;
+
+    while(0U != queue->count)
+    {
+        uint8_t slot = queue->heap[0];
+        uint32_t fit_map = CAN_TxFitMask(can_handle, queue->frames[slot].dlc);
+        uint32_t free_map = CAN_TxFreeMap(can_handle, queue->key[slot], fit_map);
+
+        if(0U != free_map)
+        {
+            uint8_t idx_mb = CAN_LOWEST_MB(free_map);
+            can_handle->tx_free_map &= ~(1UL << idx_mb);
+            can_handle->tx_mb_order[idx_mb] = queue->order[slot];
+            can_handle->tx_mb_key[idx_mb] = queue->key[slot];
+            can_handle->tx_mb_tag[idx_mb] = queue->tag[slot];
+            CAN_STATS_TX_LOADED(can_handle, idx_mb, &queue->frames[slot]);
+            CAN_WriteMsgBuff(can_handle, idx_mb, &queue->frames[slot]);
+            CAN_TxQueuePop(queue);
+            continue;
+        }
+
+        /* One abort at a time, the Tx ISR schedules again once it is resolved */
+        if(0U == can_handle->tx_abort_map)
+        {
+            uint32_t worst_key = queue->key[slot];
+            int8_t worst_mb = -1;
+            for(uint32_t map = fit_map & ~can_handle->tx_free_map; 0U != map; map &= (map - 1U))
+            {
+                uint8_t idx_mb = CAN_LOWEST_MB(map);
+                uint32_t key = can_handle->tx_mb_key[idx_mb];
+                /* Among equal ranks the youngest frame goes back, keeping the send order */
+                if((key > worst_key)
+                || ((key == worst_key) && (worst_mb >= 0)
+                    && ((int32_t)(can_handle->tx_mb_order[idx_mb] - can_handle->tx_mb_order[worst_mb]) > 0)))
+                {
+                    worst_key = key;
+                    worst_mb = (int8_t)idx_mb;
+                }
+            }
+            /* A frame already sent has its IFLAG pending behind the masked Tx interrupt: an abort would
+               read back as not sent and send it twice. The ISR frees that MB and schedules again */
+            if((worst_mb >= 0) && (0U == (CAN_instance->IFLAG1 & (uint32_t)(1UL << worst_mb))))
+            {
+                uint32_t base = can_handle->mb_map.mb_base[worst_mb];
+                CAN_instance->RAMn[base] = (CAN_instance->RAMn[base] & ~CAN_MB_CS_CODE_MASK)
+                                         | ((uint32_t)CAN_MB_CODE_TX_ABORT << CAN_MB_CS_CODE_SHIFT);
+                can_handle->tx_abort_map |= (uint32_t)(1UL << worst_mb);
+            }
+        }
+        break;
+    }
+}
+
+/* Hands a received frame to the Rx hook, CAN_E_OK if the hook consumed it. words is the payload in MB layout */
+static Std_CAN_Status CAN_OfferRxHook(CAN_Handle_type* can_handle, uint8_t idx_mb, uint32_t cs, uint32_t id,
+                                      const volatile uint32_t* words)
+{
+    CAN_MsgView_type view;
+
+    view.words = words;
+    view.id = (cs & CAN_MB_CS_IDE_MASK) ? (id & CAN_MB_ID_EXT_MASK)
+                                        : ((id & CAN_MB_ID_STD_MASK) >> CAN_WMBn_CS_STD_ID_SHIFT);
+    view.cs = cs;
+    view.timestamp = (uint16_t)(cs & CAN_MB_CS_TIMESTAMP_MASK);
+    view.dlc = (uint8_t)((cs & CAN_MB_CS_DLC_MASK) >> CAN_MB_CS_DLC_SHIFT);
+    view.length = (cs & CAN_MB_CS_RTR_MASK) ? 0U : CAN_DlcToLength(can_handle, view.dlc);
+    view.idx_mb = idx_mb;
+
+    Std_CAN_Status status = can_handle->rx_hook(can_handle, &view);
+    if(CAN_E_OK == status)
+    {
+        /* The Rx FIFO CODE field holds no overrun state */
+        CAN_STATS_RX(can_handle, idx_mb, view.id, (ENABLE_RX_FIFO == can_handle->rx_fifo) ? (cs & ~CAN_MB_CS_CODE_MASK) : cs);
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+
+    return status;
+}
+
+/* Empties the whole Rx FIFO into the Rx ring. Clearing BUF5I pops the next frame into the MB0 output area */
+static void CAN_DrainRxFifo(CAN_Handle_type* can_handle)
+{
+    CAN_Type* CAN_instance = can_handle->can_instance;
+    CAN_RxRing_type* ring = &can_handle->rx_ring;
+
+    /* With eDMA the FIFO output belongs to the DMA channel, only the overflow is serviced here */
+    while((ENABLE_RX_DMA != can_handle->rx_dma) && (CAN_instance->IFLAG1 & CAN_IFLAG1_BUF5I_MASK))
+    {
+        uint16_t head = ring->head;
+        uint32_t base = can_handle->mb_map.mb_base[0];
+        uint8_t consumed = 0U;
+        if(NULL != can_handle->rx_hook)
+        {
+            /* CS before ID, argument evaluation order is unspecified */
+            uint32_t cs = CAN_instance->RAMn[base];
+            uint32_t id = CAN_instance->RAMn[base + 1U];
+            consumed = (CAN_E_OK == CAN_OfferRxHook(can_handle, 0U, cs, id, &CAN_instance->RAMn[base + 2U])) ? 1U : 0U;
+        }
+        else
+        {
+            /* DO NOTHING */
+        }
+
+        if(consumed)
+        {
+            /* Consumed in place, the FIFO output is not locked: clearing BUF5I moves it on */
+        }
+        else if((uint16_t)(head - ring->tail) < CAN_RX_RING_SIZE)
+        {
+            uint32_t cs = CAN_ReadMsgBuff(can_handle, 0, &ring->frames[head & (CAN_RX_RING_SIZE - 1U)]);
+            CAN_STATS_RX(can_handle, 0U, ring->frames[head & (CAN_RX_RING_SIZE - 1U)].id, cs & ~CAN_MB_CS_CODE_MASK);
+            CAN_COMPILER_BARRIER();
+            ring->head = (uint16_t)(head + 1U);
+            can_handle->stats.rx_frames++;
+        }
+        else
+        {
+            can_handle->stats.rx_overflow++;
+        }
+        CAN_CLEAR_IFLAG1(CAN_instance, CAN_IFLAG1_BUF5I_MASK);
+    }
+
+    /* Frames lost by the hardware FIFO itself */
+    if(CAN_instance->IFLAG1 & CAN_IFLAG1_BUF7I_MASK)
+    {
+        can_handle->stats.rx_overflow++;
+        CAN_STATS_RX_OVERRUN(can_handle, 0U);
+    }
+    CAN_CLEAR_IFLAG1(CAN_instance, CAN_IFLAG1_BUF6I_MASK | CAN_IFLAG1_BUF7I_MASK);
+}
+
+/* Programs the eDMA channel to copy the 16 byte FIFO output into rx_dma_buffer on every BUF5I request.
+   The minor loop offset moves the source back to the output area after each frame (CR[EMLM]).
+   The major loop spans the whole buffer and interrupts at its half and its end, i.e. every watermark */
+static void CAN_DmaConfig(CAN_Handle_type* can_handle, uint8_t dma_request)
+{
+    CAN_Type* CAN_instance = can_handle->can_instance;
+    uint8_t ch = can_handle->rx_dma_channel;
+    uint16_t num_frames = can_handle->rx_dma_frames;
+
+    DMA->CERQ = ch;
+    DMAMUX->CHCFG[ch] = 0;
+    DMA->CR |= DMA_CR_EMLM_MASK; /* NBYTES with minor loop offsets, other channels keep MLOFFNO with SMLOE = DMLOE = 0 */
+
+    DMA->TCD[ch].SADDR = (uint32_t)(uintptr_t)&CAN_instance->RAMn[0];
+    DMA->TCD[ch].SOFF = 4U;
+    DMA->TCD[ch].ATTR = DMA_TCD_ATTR_SSIZE(2U) | DMA_TCD_ATTR_DSIZE(2U);
+    DMA->TCD[ch].NBYTES.MLOFFYES = DMA_TCD_NBYTES_MLOFFYES_SMLOE_MASK
+                                 | DMA_TCD_NBYTES_MLOFFYES_MLOFF((uint32_t)(-(int32_t)sizeof(CAN_DmaFrame_type)))
+                                 | DMA_TCD_NBYTES_MLOFFYES_NBYTES(sizeof(CAN_DmaFrame_type));
+    DMA->TCD[ch].SLAST = 0U; /* The last minor loop offset already restored SADDR */
+    DMA->TCD[ch].DADDR = (uint32_t)(uintptr_t)can_handle->rx_dma_buffer;
+    DMA->TCD[ch].DOFF = 4U;
+    DMA->TCD[ch].CITER.ELINKNO = DMA_TCD_CITER_ELINKNO_CITER(num_frames);
+    DMA->TCD[ch].BITER.ELINKNO = DMA_TCD_BITER_ELINKNO_BITER(num_frames);
+    DMA->TCD[ch].DLASTSGA = (uint32_t)(-(int32_t)(sizeof(CAN_DmaFrame_type) * num_frames));
+    DMA->TCD[ch].CSR = DMA_TCD_CSR_INTHALF_MASK | DMA_TCD_CSR_INTMAJOR_MASK;
+
+    DMAMUX->CHCFG[ch] = DMAMUX_CHCFG_ENBL_MASK | DMAMUX_CHCFG_SOURCE(dma_request);
+    DMA->SERQ = ch;
+}
+
+/* Picks the segments of one phase for n_tq time quanta and a sample point in percent */
+static uint8_t CAN_SplitPhase(uint8_t n_tq, uint8_t samp_point, const CAN_Phase_Limit_type* limit, CAN_Phase_Timing_type* phase)
+{
+    uint8_t valid = 0;
+    uint16_t sample_tq = (uint16_t)(((uint16_t)n_tq * samp_point + 50U) / 100U);
+    int16_t phase_seg2 = (int16_t)n_tq - (int16_t)sample_tq;
+
+    if(phase_seg2 < (int16_t)limit->min_phase_seg2)
+    {
+        phase_seg2 = limit->min_phase_seg2;
+    }
+    if(phase_seg2 > (int16_t)limit->max_phase_seg2)
+    {
+        phase_seg2 = limit->max_phase_seg2;
+    }
+
+    /* tseg1 = PROPSEG + PSEG1, PSEG1 follows PSEG2 to keep the resynchronisation jump symmetric */
+    int16_t tseg1 = (int16_t)n_tq - 1 - phase_seg2;
+    int16_t phase_seg1 = (phase_seg2 > (int16_t)limit->max_phase_seg1) ? (int16_t)limit->max_phase_seg1 : phase_seg2;
+    int16_t prop_seg = tseg1 - phase_seg1;
+    if(prop_seg > (int16_t)limit->max_prop_seg)
+    {
+        prop_seg = limit->max_prop_seg;
+        phase_seg1 = tseg1 - prop_seg;
+    }
+    if(prop_seg < (int16_t)limit->min_prop_seg)
+    {
+        prop_seg = limit->min_prop_seg;
+        phase_seg1 = tseg1 - prop_seg;
+    }
+
+    if((phase_seg1 >= 1) && (phase_seg1 <= (int16_t)limit->max_phase_seg1))
+    {
+        uint8_t rjw = (uint8_t)((phase_seg1 < phase_seg2) ? phase_seg1 : phase_seg2);
+        phase->prop_seg = (uint8_t)prop_seg;
+        phase->phase_seg1 = (uint8_t)phase_seg1;
+        phase->phase_seg2 = (uint8_t)phase_seg2;
+        phase->rjw = (rjw > limit->max_rjw) ? limit->max_rjw : rjw;
+        valid = 1;
+    }
+
+    return valid;
+}
+
+/* Bit rate error of prescaler * n_tq against bit_rate in ppm, and sample point error in 0.1 % */
+static uint32_t CAN_PhaseError(uint32_t clock_hz, uint32_t bit_rate, uint8_t samp_point, const CAN_Phase_Timing_type* phase, uint32_t* samp_error)
+{
+    uint32_t n_tq = 1U + phase->prop_seg + phase->phase_seg1 + phase->phase_seg2;
+    uint64_t actual = (uint64_t)bit_rate * phase->prescaler * n_tq;
+    uint64_t diff = (actual > clock_hz) ? (actual - clock_hz) : ((uint64_t)clock_hz - actual);
+    int32_t samp = (int32_t)CAN_TIMING_SAMPLE_POINT(phase->prop_seg, phase->phase_seg1, phase->phase_seg2) - ((int32_t)samp_point * 10);
+
+    *samp_error += (uint32_t)((samp < 0) ? -samp : samp);
+    return (uint32_t)((diff * 1000000U) / clock_hz);
+}
+
+Std_CAN_Status CAN_ComputeBitTiming(uint32_t clock_hz, const CAN_Bit_Timing_type* bit_rate_config, uint8_t can_mode, CAN_Bit_Timing_Result_type* result)
+{
+    static const CAN_Phase_Limit_type nominal_limit = {1U, 64U, 32U, 2U, 32U, 32U};
+    static const CAN_Phase_Limit_type data_limit = {0U, 31U, 8U, 2U, 8U, 8U};
+    Std_CAN_Status status = CAN_E_NOT_OK;
+    uint32_t best_error = 0xFFFFFFFFU;
+    uint32_t best_samp_error = 0xFFFFFFFFU;
+    uint8_t nominal_samp = (0U != bit_rate_config->samp_point) ? bit_rate_config->samp_point : 80U;
+    uint8_t data_samp = (0U != bit_rate_config->data_samp_point) ? bit_rate_config->data_samp_point : 75U;
+
+    if((0U == bit_rate_config->nominal_bit_Rate) || ((CANFD == can_mode) && (0U == bit_rate_config->data_bit_rate)))
+    {
+        return CAN_E_NOT_OK;
+    }
+
+    /* Both phases share the prescaler, as recommended for CAN FD */
+    for(uint16_t prescaler = 1; prescaler <= CAN_MAX_PRESCALER; prescaler++)
+    {
+        CAN_Bit_Timing_Result_type candidate;
+        uint32_t n_tq = (clock_hz + ((uint32_t)prescaler * bit_rate_config->nominal_bit_Rate / 2U)) / ((uint32_t)prescaler * bit_rate_config->nominal_bit_Rate);
+        uint8_t valid = (n_tq >= CAN_MIN_NOMINAL_TQ) && (n_tq <= CAN_MAX_NOMINAL_TQ)
+                     && ((0U == bit_rate_config->time_quanta) || (n_tq == bit_rate_config->time_quanta));
+        uint32_t samp_error = 0;
+        uint32_t error = 0;
+
+        candidate.nominal.prescaler = prescaler;
+        candidate.data = candidate.nominal;
+        candidate.tdc_offset = 0;
+        candidate.data_error_ppm = 0;
+        if(valid)
+        {
+            valid = CAN_SplitPhase((uint8_t)n_tq, nominal_samp, &nominal_limit, &candidate.nominal);
+        }
+        if(valid)
+        {
+            candidate.nominal_error_ppm = CAN_PhaseError(clock_hz, bit_rate_config->nominal_bit_Rate, nominal_samp, &candidate.nominal, &samp_error);
+            error = candidate.nominal_error_ppm;
+        }
+
+        if(valid && (CANFD == can_mode))
+        {
+            uint32_t d_tq = (clock_hz + ((uint32_t)prescaler * bit_rate_config->data_bit_rate / 2U)) / ((uint32_t)prescaler * bit_rate_config->data_bit_rate);
+            candidate.data.prescaler = prescaler;
+            valid = (d_tq >= CAN_MIN_DATA_TQ) && (d_tq <= CAN_MAX_DATA_TQ)
+                 && CAN_SplitPhase((uint8_t)d_tq, data_samp, &data_limit, &candidate.data);
+            if(valid)
+            {
+                candidate.data_error_ppm = CAN_PhaseError(clock_hz, bit_rate_config->data_bit_rate, data_samp, &candidate.data, &samp_error);
+                error += candidate.data_error_ppm;
+
+                /* Above 1 Mbit/s the transceiver loop delay needs compensation: measure at the data sample point */
+                if(bit_rate_config->data_bit_rate > CAN_TDC_MIN_BIT_RATE)
+                {
+                    uint32_t tdc_offset = (1U + candidate.data.prop_seg + candidate.data.phase_seg1) * prescaler;
+                    valid = (prescaler <= CAN_TDC_MAX_PRESCALER) && (tdc_offset <= CAN_TDC_MAX_OFFSET);
+                    candidate.tdc_offset = (uint8_t)tdc_offset;
+                }
+            }
+        }
+
+        if(valid && ((error < best_error) || ((error == best_error) && (samp_error < best_samp_error))))
+        {
+            best_error = error;
+            best_samp_error = samp_error;
+            *result = candidate;
+            status = CAN_E_OK;
+        }
+    }
+
+    return status;
+}
+
+void CAN_ApplyBitTiming(CAN_Type* can_instance, const CAN_Bit_Timing_Result_type* timing)
+{
+    can_instance->CBT = CAN_CBT_BTF_MASK
+                      | CAN_CBT_EPRESDIV(timing->nominal.prescaler - 1U)
+                      | CAN_CBT_ERJW(timing->nominal.rjw - 1U)
+                      | CAN_CBT_EPROPSEG(timing->nominal.prop_seg - 1U)
+                      | CAN_CBT_EPSEG1(timing->nominal.phase_seg1 - 1U)
+                      | CAN_CBT_EPSEG2(timing->nominal.phase_seg2 - 1U);
+
+    if(can_instance->MCR & CAN_MCR_FDEN_MASK)
+    {
+        can_instance->FDCBT = CAN_FDCBT_FPRESDIV(timing->data.prescaler - 1U)
+                            | CAN_FDCBT_FRJW(timing->data.rjw - 1U)
+                            | CAN_FDCBT_FPROPSEG(timing->data.prop_seg)
+                            | CAN_FDCBT_FPSEG1(timing->data.phase_seg1 - 1U)
+                            | CAN_FDCBT_FPSEG2(timing->data.phase_seg2 - 1U);
+
+        can_instance->FDCTRL &= ~(CAN_FDCTRL_TDCEN_MASK | CAN_FDCTRL_TDCOFF_MASK);
+        if(0U != timing->tdc_offset)
+        {
+            can_instance->FDCTRL |= CAN_FDCTRL_TDCEN_MASK | CAN_FDCTRL_TDCOFF(timing->tdc_offset);
+        }
+    }
+}
+
+Std_CAN_Status CAN_BitRateConfig(CAN_Type* can_instance, uint32_t clock_hz, CAN_Bit_Timing_type* bit_rate_config)
 {
 	Std_CAN_Status status = CAN_E_OK;
+    CAN_Bit_Timing_Result_type timing;
+    uint8_t can_mode = (can_instance->MCR & CAN_MCR_FDEN_MASK) ? CANFD : CAN20;
+
+    if(NULL != bit_rate_config->fixed_timing)
+    {
+        /* Precomputed at build time, no search at boot */
+        CAN_ApplyBitTiming(can_instance, bit_rate_config->fixed_timing);
+    }
+    else
+    {
+        status = CAN_ComputeBitTiming(clock_hz, bit_rate_config, can_mode, &timing);
+        if(CAN_E_OK == status)
+        {
+            CAN_ApplyBitTiming(can_instance, &timing);
+        }
+    }
+
+    return status;
+}
+
+/* Places the MBs of every RAM block with the sizes of region_payload and returns their number */
+static uint8_t CAN_BuildMsgBuffMap(CAN_MsgBuffMap_type* map, uint16_t ram_words, const uint8_t* region_payload)
+{
+    uint8_t num_msg_buff = 0;
+
+    memset(map->payload_mb_mask, 0, sizeof(map->payload_mb_mask));
+    for(uint8_t region = 0; region < CAN_MB_REGION_COUNT; region++)
+    {
+        uint16_t region_base = (uint16_t)(region * CAN_MB_REGION_WORDS);
+        uint8_t words = CAN_payload_words_arr[region_payload[region]];
+        uint16_t region_words = 0;
+
+        map->region_payload[region] = region_payload[region];
+        if(region_base < ram_words)
+        {
+            region_words = (uint16_t)(ram_words - region_base);
+            if(region_words > CAN_MB_REGION_WORDS)
+            {
+                region_words = CAN_MB_REGION_WORDS;
+            }
+        }
+
+        /* An MB never crosses a block boundary, the rest of the block stays unused */
+        for(uint16_t offset = 0; ((offset + words) <= region_words) && (num_msg_buff < CAN_MAX_MSG_BUFF); offset += words)
+        {
+            map->mb_words[num_msg_buff] = words;
+            map->mb_base[num_msg_buff] = (uint16_t)(region_base + offset);
+            for(uint8_t payload = PAYLOAD_8_BYTES; payload <= region_payload[region]; payload++)
+            {
+                map->payload_mb_mask[payload] |= (uint32_t)(1UL << num_msg_buff);
+            }
+            num_msg_buff++;
+        }
+    }
+
+    return num_msg_buff;
+}
+
+/* Picks the block sizes giving the most MBs that still hold the layout and places the Rx MBs into rx_mb_mask.
+   Returns the number of MBs, 0 if the layout does not fit the MB RAM */
+static uint8_t CAN_PlanMsgBuff(CAN_MsgBuffMap_type* map, uint16_t ram_words, uint8_t can_mode, const CAN_MsgBuffLayout_type* layout,
+                               uint32_t* rx_mb_mask)
+{
+    uint8_t region_payload[CAN_MB_REGION_COUNT];
+    uint8_t num_regions = (uint8_t)((ram_words + CAN_MB_REGION_WORDS - 1U) / CAN_MB_REGION_WORDS);
+    uint8_t num_payload = (CANFD == can_mode) ? 4U : 1U; /* CAN 2.0 MBs are always 8 bytes */
+    uint16_t num_combos = 1;
+    int32_t best_combo = -1;
+    uint8_t best_num = 0;
+    uint8_t num_planned = 0;
+
+    if(num_regions > CAN_MB_REGION_COUNT)
+    {
+        num_regions = CAN_MB_REGION_COUNT;
+    }
+    for(uint8_t region = 0; region < num_regions; region++)
+    {
+        num_combos = (uint16_t)(num_combos * num_payload);
+    }
+
+    for(uint16_t combo = 0; combo <= num_combos; combo++)
+    {
+        /* The extra last pass rebuilds the best combination */
+        uint16_t digits = (combo < num_combos) ? combo : (uint16_t)best_combo;
+        if((combo == num_combos) && (best_combo < 0))
+        {
+            return 0U;
+        }
+        for(uint8_t region = 0; region < CAN_MB_REGION_COUNT; region++)
+        {
+            region_payload[region] = (uint8_t)((region < num_regions) ? (digits % num_payload) : PAYLOAD_8_BYTES);
+            digits = (uint16_t)(digits / num_payload);
+        }
+
+        uint8_t num_msg_buff = CAN_BuildMsgBuffMap(map, ram_words, region_payload);
+        if(combo == num_combos)
+        {
+            num_planned = num_msg_buff;
+            break;
+        }
+
+        /* Every size class needs enough MBs at least that large */
+        uint8_t fits = 1;
+        uint16_t need = 0;
+        for(uint8_t payload = 4; (payload-- > 0U) && fits;)
+        {
+            uint8_t have = 0;
+            need = (uint16_t)(need + layout->num_rx[payload] + layout->num_tx[payload]);
+            for(uint32_t mb_map = map->payload_mb_mask[payload]; 0U != mb_map; mb_map &= (mb_map - 1U))
+            {
+                have++;
+            }
+            fits = (need <= have);
+        }
+        if(fits && (num_msg_buff > best_num))
+        {
+            best_num = num_msg_buff;
+            best_combo = combo;
+        }
+    }
+
+    /* Largest frames first, each into the smallest MB that holds it */
+    uint32_t used = 0;
+    *rx_mb_mask = 0;
+    for(uint8_t payload = 4; payload-- > 0U;)
+    {
+        uint32_t larger = (payload < PAYLOAD_64_BYTES) ? map->payload_mb_mask[payload + 1U] : 0U;
+        for(uint8_t count = (uint8_t)(layout->num_rx[payload] + layout->num_tx[payload]); count > 0U; count--)
+        {
+            uint32_t pool = map->payload_mb_mask[payload] & ~larger & ~used;
+            if(0U == pool)
+            {
+                pool = map->payload_mb_mask[payload] & ~used;
+            }
+            uint32_t mb_mask = (uint32_t)(1UL << CAN_LOWEST_MB(pool));
+            used |= mb_mask;
+            if(count <= layout->num_rx[payload])
+            {
+                *rx_mb_mask |= mb_mask;
+            }
+        }
+    }
+
+    return num_planned;
+}
+
+/* Writes the PN filter registers, the controller is in freeze mode */
+static void CAN_PnWriteFilter(CAN_Type* CANx, const CAN_PN_Config_type* pn_config)
+{
+    uint32_t id1;
+    uint32_t id2;
+
+    if(EXTENDED_ID == pn_config->id_type)
+    {
+        id1 = CAN_FLT_ID1_FLT_IDE_MASK | (pn_config->id1 & CAN_MB_ID_EXT_MASK);
+        id2 = pn_config->id2 & CAN_MB_ID_EXT_MASK;
+    }
+    else
+    {
+        id1 = (pn_config->id1 << CAN_WMBn_CS_STD_ID_SHIFT) & CAN_MB_ID_STD_MASK;
+        id2 = (pn_config->id2 << CAN_WMBn_CS_STD_ID_SHIFT) & CAN_MB_ID_STD_MASK;
+    }
+    if(PN_MATCH_EXACT == pn_config->id_match)
+    {
+        /* IDE and RTR always compared: only data frames of the configured ID type wake */
+        id2 |= CAN_FLT_ID2_IDMASK_IDE_MSK_MASK | CAN_FLT_ID2_IDMASK_RTR_MSK_MASK;
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+
+    CANx->CTRL1_PN = CAN_CTRL1_PN_FCS(pn_config->filter) | CAN_CTRL1_PN_IDFS(pn_config->id_match)
+                   | CAN_CTRL1_PN_PLFS(pn_config->payload_match) | CAN_CTRL1_PN_NMATCH(pn_config->num_matches)
+                   | CAN_CTRL1_PN_WUMF_MSK_MASK | ((0U != pn_config->match_timeout) ? CAN_CTRL1_PN_WTOF_MSK_MASK : 0U);
+    CANx->CTRL2_PN = CAN_CTRL2_PN_MATCHTO(pn_config->match_timeout);
+    CANx->FLT_ID1 = id1;
+    CANx->FLT_ID2_IDMASK = id2;
+    CANx->FLT_DLC = CAN_FLT_DLC_FLT_DLC_HI(pn_config->dlc_high) | CAN_FLT_DLC_FLT_DLC_LO(pn_config->dlc_low);
+    CANx->PL1_LO = ((uint32_t)pn_config->payload1[0] << 24) | ((uint32_t)pn_config->payload1[1] << 16)
+                 | ((uint32_t)pn_config->payload1[2] << 8) | pn_config->payload1[3];
+    CANx->PL1_HI = ((uint32_t)pn_config->payload1[4] << 24) | ((uint32_t)pn_config->payload1[5] << 16)
+                 | ((uint32_t)pn_config->payload1[6] << 8) | pn_config->payload1[7];
+    CANx->PL2_PLMASK_LO = ((uint32_t)pn_config->payload2[0] << 24) | ((uint32_t)pn_config->payload2[1] << 16)
+                        | ((uint32_t)pn_config->payload2[2] << 8) | pn_config->payload2[3];
+    CANx->PL2_PLMASK_HI = ((uint32_t)pn_config->payload2[4] << 24) | ((uint32_t)pn_config->payload2[5] << 16)
+                        | ((uint32_t)pn_config->payload2[6] << 8) | pn_config->payload2[7];
+    CAN_CLEAR_WU_MTC(CANx, CAN_WU_MTC_WUMF_MASK | CAN_WU_MTC_WTOF_MASK);
+    CANx->MCR |= CAN_MCR_PNET_EN_MASK;
+}
+
+/* Only CAN0 has Pretended Networking; NMATCH 0 and DLC bounds above 8 are reserved */
+static uint8_t CAN_PnValid(const CAN_Type* CANx, const CAN_PN_Config_type* pn_config)
+{
+    return (CAN0 == CANx) && (NULL != pn_config) && (pn_config->filter <= PN_ID_AND_PAYLOAD_NMATCH)
+        && (pn_config->id_match <= PN_MATCH_RANGE) && (pn_config->payload_match <= PN_MATCH_RANGE)
+        && (0U != pn_config->num_matches) && (pn_config->dlc_low <= pn_config->dlc_high) && (pn_config->dlc_high <= 8U);
+}
+
+/* Writes CTRL1[LPB, LOM], CTRL2[EACEN] and every Rx mask of an operation mode, none is left from an earlier
+   mode. The controller is in freeze mode, num_masks is the number of RXIMR of the instance */
+static void CAN_ApplyOperateMode(CAN_Type* CANx, uint8_t operate_mode, uint8_t num_masks)
+{
+    /* A monitor accepts every identifier of either format: with CTRL2[EACEN] the Rx MB IDE bit is compared
+       only under its (cleared) mask. Every other mode compares all identifier bits */
+    uint32_t mask = (LISTEN_ONLY_MODE == operate_mode) ? 0U : 0xFFFFFFFFU;
+
+    CANx->CTRL1 &= ~(CAN_CTRL1_LPB_MASK | CAN_CTRL1_LOM_MASK);
+    CANx->CTRL2 &= ~CAN_CTRL2_EACEN_MASK;
+    CANx->RXMGMASK = mask;
+    CANx->RX14MASK = mask;
+    CANx->RX15MASK = mask;
+    CANx->RXFGMASK = mask;
+    for(uint8_t idx = 0; idx < num_masks; idx++)
+    {
+        CANx->RXIMR[idx] = mask;
+    }
+
+    if(LOOP_BACK_MODE == operate_mode)
+    {
+        CANx->CTRL1 |= CAN_CTRL1_LPB_MASK;
+    }
+    else if(LISTEN_ONLY_MODE == operate_mode)
+    {
+        /* Monitor: no ACK, no error frames, no transmission */
+        CANx->CTRL1 |= CAN_CTRL1_LOM_MASK;
+        CANx->CTRL2 |= CAN_CTRL2_EACEN_MASK;
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+}
+
+Std_CAN_Status CAN_Init(CAN_Handle_type* can_handle, CAN_Config_type* can_config)
+{
+    Std_CAN_Status status = CAN_E_OK;
+    /* CANx is CAN0 or CAN1 or CAN2 */
+    CAN_Type* CANx = can_config->can_instance;
+    uint8_t max_msg_buff = CAN0_MB_COUNT;
+    uint8_t msg_buff_size = 2U; /* Header words only, until a Tx MB is placed */
+    uint8_t num_msg_buff = 0;
+    uint8_t dma_request = CAN0_DMA_REQUEST;
+    int8_t idx_instance = -1;
+    CAN_MsgBuffMap_type mb_map;
+    uint32_t layout_rx_mb_mask = 0;
+    CAN_Bit_Timing_Result_type solved;
+    const CAN_Bit_Timing_Result_type* timing = can_config->bit_rate_config->fixed_timing;
+
+    /* The legacy Rx FIFO only stores CAN 2.0 frames and takes the MBs it needs itself */
+    if((ENABLE_RX_FIFO == can_config->rx_fifo)
+    && ((CANFD == can_config->can_mode) || (NULL != can_config->mb_layout)))
+    {
+        return CAN_E_NOT_OK;
+    }
+
+    /* eDMA reads the Rx FIFO output into a buffer of two watermark halves */
+    if((ENABLE_RX_DMA == can_config->rx_dma)
+    && ((ENABLE_RX_FIFO != can_config->rx_fifo) || (ENABLE_RX_ZERO_COPY == can_config->rx_zero_copy)
+     || (NULL == can_config->rx_dma_buffer) || (0U == can_config->rx_dma_watermark)
+     || ((2UL * can_config->rx_dma_watermark) > CAN_DMA_MAX_FRAMES)
+     || (can_config->rx_dma_channel >= CAN_DMA_CHANNEL_COUNT)))
+    {
+        return CAN_E_NOT_OK;
+    }
+
+    if((PRETENDED_NETWORK_MODE == can_config->operate_mode) && !CAN_PnValid(CANx, can_config->pn_config))
+    {
+        return CAN_E_NOT_OK;
+    }
+
+    if(CAN0 == CANx)
+    {
+        idx_instance = 0;
+    }
+    else if(CAN1 == CANx)
+    {
+        idx_instance = 1;
+        max_msg_buff = CAN1_MB_COUNT;
+        dma_request = CAN1_DMA_REQUEST;
+    }
+    else if(CAN2 == CANx)
+    {
+        idx_instance = 2;
+        max_msg_buff = CAN2_MB_COUNT;
+        dma_request = CAN2_DMA_REQUEST;
+    }
+    else
+    {
+        /* RAM image of CAN_Type, serviced by calling CAN_IRQHandler directly; no DMA request line */
+        if(ENABLE_RX_DMA == can_config->rx_dma)
+        {
+            return CAN_E_NOT_OK;
+        }
+        else
+        {
+            /* DO NOTHING */
+        }
+    }
+
+    /* Place the message buffers */
+    uint16_t ram_words = (uint16_t)(max_msg_buff * 4U);
+    if(NULL != can_config->mb_layout)
+    {
+        num_msg_buff = CAN_PlanMsgBuff(&mb_map, ram_words, can_config->can_mode, can_config->mb_layout, &layout_rx_mb_mask);
+        if(0U == num_msg_buff)
+        {
+            /* Requested mailboxes do not fit the MB RAM */
+            return CAN_E_NOT_OK;
+        }
+    }
+    else
+    {
+        uint8_t region_payload[CAN_MB_REGION_COUNT];
+        uint8_t payload = PAYLOAD_8_BYTES;
+        if((CANFD == can_config->can_mode) && (can_config->payload <= PAYLOAD_64_BYTES))
+        {
+            payload = can_config->payload;
+        }
+        for(uint8_t region = 0; region < CAN_MB_REGION_COUNT; region++)
+        {
+            region_payload[region] = payload;
+        }
+        num_msg_buff = CAN_BuildMsgBuffMap(&mb_map, ram_words, region_payload);
+    }
+
+    if((ENABLE_RX_FIFO == can_config->rx_fifo)
+    && ((CAN_RX_FIFO_MB_COUNT + (2U * (can_config->rx_fifo_filter_num + 1U))) >= num_msg_buff))
+    {
+        /* Filter table would leave no MB for transmission */
+        return CAN_E_NOT_OK;
+    }
+
+    if(NULL == timing)
+    {
+        if(CAN_E_OK != CAN_ComputeBitTiming((BUS_CLOCK == can_config->clock_source) ? CANCLK : fCANCLK,
+                                            can_config->bit_rate_config, can_config->can_mode, &solved))
+        {
+            /* No legal segment set for the requested bit rates */
+            return CAN_E_NOT_OK;
+        }
+        timing = &solved;
+    }
+
+    /* Everything is validated, no error return follows. A running controller is quiesced before its
+       handle is unbound, so no interrupt finds an empty slot or a half initialised handle */
+    CANx->IMASK1 = 0;
+    CANx->CTRL1 &= ~(CAN_CTRL1_BOFFMSK_MASK | CAN_CTRL1_ERRMSK_MASK);
+    CANx->CTRL2 &= ~(CAN_CTRL2_BOFFDONEMSK_MASK | CAN_CTRL2_ERRMSK_FAST_MASK);
+    if(idx_instance >= 0)
+    {
+        CAN_handle_arr[idx_instance] = NULL;
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+
+    can_handle->can_instance = CANx;
+    can_handle->mb_map = mb_map;
+    can_handle->num_msg_buff = num_msg_buff;
+    can_handle->rx_ring.head = 0;
+    can_handle->rx_ring.tail = 0;
+    CAN_TxQueueReset(&can_handle->tx_queue);
+    can_handle->tx_queue.next_order = 0;
+    can_handle->tx_abort_map = 0;
+    can_handle->tx_cs_flags = 0;
+    can_handle->tx_id_flags = (EXTENDED_ID == can_config->id_type) ? CAN_FRAME_FLAG_IDE : 0U;
+    can_handle->remote_mb_mask = 0;
+    can_handle->rx_fifo = DISABLE_RX_FIFO;
+    can_handle->rx_fifo_filter_num = 0;
+    can_handle->stats.rx_frames = 0;
+    can_handle->stats.rx_overflow = 0;
+    can_handle->stats.tx_frames = 0;
+    can_handle->stats.tx_replaced = 0;
+    can_handle->num_tx_limits = 0;
+    can_handle->busoff_recovery = can_config->busoff_recovery;
+    can_handle->busoff_tx = can_config->busoff_tx;
+    can_handle->busoff_step = CAN_BUSOFF_STEP_IDLE;
+    can_handle->error_callback = can_config->error_callback;
+    memset(&can_handle->error_status, 0, sizeof(can_handle->error_status));
+    can_handle->pn_wake_status = 0;
+    can_handle->rx_hook = NULL;
+    can_handle->tx_done_hook = NULL;
+    can_handle->hook_context = NULL;
+    memset(can_handle->tx_mb_tag, 0, sizeof(can_handle->tx_mb_tag));
+    can_handle->rx_dma = can_config->rx_dma;
+    can_handle->rx_dma_channel = can_config->rx_dma_channel;
+    can_handle->rx_dma_frames = (uint16_t)(2U * can_config->rx_dma_watermark);
+    can_handle->rx_dma_read = 0;
+    can_handle->rx_dma_buffer = can_config->rx_dma_buffer;
+
+    /* Disable module before selecting clock*/
+    CANx->MCR |= CAN_MCR_MDIS_MASK;
+    CAN_WAIT_WHILE(CANx, !((CANx->MCR & CAN_MCR_LPMACK_MASK) >> CAN_MCR_LPMACK_SHIFT));
+
+    /* setting clock*/
+    if(BUS_CLOCK == can_config->clock_source)
+    {
+        CANx->CTRL1 |= CAN_CTRL1_CLKSRC_MASK;
+    }
+    else
+    {
+        CANx->CTRL1 &= ~CAN_CTRL1_CLKSRC_MASK;
+    }
+
+    /* Enable module after selecting clock and enter freeze mode(MCR[FRZ], MCR[HALT] are only set out of reset)*/
+    CANx->MCR |= CAN_MCR_FRZ_MASK | CAN_MCR_HALT_MASK;
+    CANx->MCR &= ~CAN_MCR_MDIS_MASK;
+    CAN_WAIT_WHILE(CANx, ((CANx->MCR & CAN_MCR_LPMACK_MASK) >> CAN_MCR_LPMACK_SHIFT));
+    CAN_WAIT_WHILE(CANx, !((CANx->MCR & CAN_MCR_FRZACK_MASK) >> CAN_MCR_FRZACK_SHIFT));
+
+    /* Set CAN mode(CAN 2.0 or FlexCAN) */
+    if(CANFD == can_config->can_mode)
+    {
+        CANx->MCR |= CAN_MCR_FDEN_MASK;
+        /* Switching BRS */
+        can_handle->tx_cs_flags = CAN_MB_CS_EDL_MASK;
+        if(ENABLE_BRS == can_config->bit_rate_sw)
+        {
+            CANx->FDCTRL |= CAN_FDCTRL_FDRATE_MASK;
+            can_handle->tx_cs_flags |= CAN_MB_CS_BRS_MASK;
+        }
+        else
+        {
+            /* DO NOTHING */
+        }
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+
+    if(CANFD == can_config->can_mode)
+    {
+        CANx->FDCTRL &= ~CAN_FDCTRL_MBDSR0_MASK;
+        CANx->FDCTRL |= CAN_FDCTRL_MBDSR0(can_handle->mb_map.region_payload[0]);
+#ifdef CAN_FDCTRL_MBDSR1_MASK
+        CANx->FDCTRL &= ~CAN_FDCTRL_MBDSR1_MASK;
+        CANx->FDCTRL |= CAN_FDCTRL_MBDSR1(can_handle->mb_map.region_payload[1]);
+#endif
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+
+    CANx->MCR &= ~CAN_MCR_MAXMB_MASK;
+    CANx->MCR |= CAN_MCR_MAXMB(num_msg_buff - 1U);
+
+    /* Tx MBs arbitrate internally by PRIO and ID (CTRL1[LBUF] = 0) and may be aborted for higher ranked frames */
+    CANx->MCR |= CAN_MCR_AEN_MASK | CAN_MCR_LPRIOEN_MASK;
+    CANx->CTRL1 &= ~CAN_CTRL1_LBUF_MASK;
+
+    /* configue bit timing */
+    CAN_ApplyBitTiming(CANx, timing);
+    CAN_STATS_INIT(can_handle);
+
+    for(uint16_t idx = 0; idx < ram_words; idx++)
+    {
+        CANx->RAMn[idx] = 0;
+    }
+
+    if(ENABLE_RX_FIFO == can_config->rx_fifo)
+    {
+        /* MB0-5 hold the FIFO engine, the ID filter table follows with 4 format A elements per MB */
+        uint8_t num_filter = (uint8_t)(CAN_RX_FIFO_FILTER_PER_RFFN * (can_config->rx_fifo_filter_num + 1U));
+        uint8_t first_tx_mb = (uint8_t)(CAN_RX_FIFO_MB_COUNT + (num_filter / 4U));
+        uint32_t filter;
+        if(STARDADARD_ID == can_config->id_type)
+        {
+            filter = (can_config->rx_identifier << CAN_RX_FIFO_ID_STD_SHIFT) & CAN_RX_FIFO_ID_STD_MASK;
+        }
+        else
+        {
+            filter = CAN_RX_FIFO_ID_IDE_MASK | ((can_config->rx_identifier << CAN_RX_FIFO_ID_EXT_SHIFT) & CAN_RX_FIFO_ID_EXT_MASK);
+        }
+
+        CANx->MCR |= CAN_MCR_RFEN_MASK;
+        CANx->MCR &= ~CAN_MCR_IDAM_MASK;
+        CANx->CTRL2 &= ~CAN_CTRL2_RFFN_MASK;
+        CANx->CTRL2 |= CAN_CTRL2_RFFN(can_config->rx_fifo_filter_num);
+        for(uint8_t idx = 0; idx < num_filter; idx++)
+        {
+            CANx->RAMn[(CAN_RX_FIFO_MB_COUNT * 4U) + idx] = filter;
+        }
+
+        /* Every MB behind the filter table is used for transmission */
+        for(uint8_t idx = first_tx_mb; idx < num_msg_buff; idx++)
+        {
+            CANx->RAMn[can_handle->mb_map.mb_base[idx]] = 0x08000000;
+            CANx->RAMn[can_handle->mb_map.mb_base[idx]] |= (uint32_t)(1 << 31);
+        }
+
+        can_handle->rx_fifo = ENABLE_RX_FIFO;
+        can_handle->rx_fifo_filter_num = can_config->rx_fifo_filter_num;
+        can_handle->rx_mb_mask = CAN_IFLAG1_RX_FIFO_MASK;
+
+        if(ENABLE_RX_DMA == can_config->rx_dma)
+        {
+            /* BUF5I becomes the DMA request, only the FIFO overflow still interrupts the CPU */
+            CANx->MCR |= CAN_MCR_DMA_MASK;
+            can_handle->rx_mb_mask = CAN_IFLAG1_BUF7I_MASK;
+            CAN_DmaConfig(can_handle, dma_request);
+        }
+        else
+        {
+            /* DO NOTHING */
+        }
+        can_handle->tx_mb_mask = (uint32_t)((1ULL << num_msg_buff) - 1ULL) & ~(uint32_t)((1UL << first_tx_mb) - 1UL);
+    }
+    else
+    {
+        if((NULL == can_config->mb_layout) && (LISTEN_ONLY_MODE == can_config->operate_mode))
+        {
+            /* A monitor never transmits, every MB receives */
+            can_handle->rx_mb_mask = (uint32_t)((1ULL << num_msg_buff) - 1ULL);
+            can_handle->tx_mb_mask = 0;
+        }
+        else if(NULL == can_config->mb_layout)
+        {
+            /* Lower half receives, upper half transmits */
+            can_handle->rx_mb_mask = (uint32_t)((1UL << (num_msg_buff / 2)) - 1UL);
+            can_handle->tx_mb_mask = (uint32_t)((1ULL << num_msg_buff) - 1ULL) & ~can_handle->rx_mb_mask;
+        }
+        else
+        {
+            /* Roles placed by CAN_PlanMsgBuff, MBs left over add Tx capacity */
+            can_handle->rx_mb_mask = layout_rx_mb_mask;
+            can_handle->tx_mb_mask = (uint32_t)((1ULL << num_msg_buff) - 1ULL) & ~layout_rx_mb_mask;
+        }
+
+        for(uint8_t idx = 0; idx < num_msg_buff; idx++)
+        {
+            if(can_handle->rx_mb_mask & (1UL << idx))
+            {
+                /* Enable for reception */
+                CANx->RAMn[can_handle->mb_map.mb_base[idx]] = 0x04000000;
+            }
+            else
+            {
+                CANx->RAMn[can_handle->mb_map.mb_base[idx]] = 0x08000000;
+            }
+            CANx->RAMn[can_handle->mb_map.mb_base[idx]] |= (uint32_t)(1 << 31);
+        }
+
+        /* write Rx ID into the first Rx msg buf */
+        if(0U != can_handle->rx_mb_mask)
+        {
+            uint16_t first_rx_base = can_handle->mb_map.mb_base[CAN_LOWEST_MB(can_handle->rx_mb_mask)];
+            if(STARDADARD_ID == can_config->id_type)
+            {
+                CANx->RAMn[first_rx_base + 1U] = ((can_config->rx_identifier) << CAN_WMBn_CS_STD_ID_SHIFT);
+            }
+            else
+            {
+                CANx->RAMn[first_rx_base] |= CAN_MB_CS_IDE_MASK;
+                CANx->RAMn[first_rx_base + 1U] = ((can_config->rx_identifier));
+            }
+        }
+
+        can_handle->rx_fifo = DISABLE_RX_FIFO;
+    }
+
+    /* Largest frame the Tx message buffers can hold */
+    for(uint32_t map = can_handle->tx_mb_mask; 0U != map; map &= (map - 1U))
+    {
+        uint8_t idx_mb = CAN_LOWEST_MB(map);
+        if(can_handle->mb_map.mb_words[idx_mb] > msg_buff_size)
+        {
+            msg_buff_size = can_handle->mb_map.mb_words[idx_mb];
+        }
+    }
+    can_handle->msg_buff_size = msg_buff_size;
+
+    /* Rx and Tx message buffers are serviced by CAN_IRQHandler, zero copy Rx MBs by CAN_PeekMsgBuff */
+    can_handle->tx_free_map = can_handle->tx_mb_mask;
+    can_handle->rx_peek_mask = 0;
+    if(ENABLE_RX_ZERO_COPY == can_config->rx_zero_copy)
+    {
+        can_handle->rx_peek_mask = (ENABLE_RX_FIFO == can_handle->rx_fifo) ? CAN_IFLAG1_BUF5I_MASK : can_handle->rx_mb_mask;
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+    CAN_CLEAR_IFLAG1(CANx, 0xFFFFFFFFU);
+    CANx->IMASK1 = ((0U != can_handle->rx_peek_mask) ? 0U : can_handle->rx_mb_mask) | can_handle->tx_mb_mask;
+
+    /* Error and bus off interrupts are serviced by CAN_ErrorIRQHandler. Automatic recovery stays on
+       (CTRL1[BOFFREC] = 0) and completes a fast recovery the hardware did not accept */
+    CANx->CTRL1 &= ~CAN_CTRL1_BOFFREC_MASK;
+    CANx->CTRL1 |= CAN_CTRL1_BOFFMSK_MASK | CAN_CTRL1_ERRMSK_MASK;
+    CANx->CTRL2 |= CAN_CTRL2_BOFFDONEMSK_MASK;
+    /* Remote requests are received like data frames until CAN_SetRemoteAnswer sets up an answer */
+    CANx->CTRL2 |= CAN_CTRL2_RRS_MASK;
+    if(CANx->MCR & CAN_MCR_FDEN_MASK)
+    {
+        CANx->CTRL2 |= CAN_CTRL2_ERRMSK_FAST_MASK;
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+    CAN_CLEAR_ESR1(CANx, CAN_ESR1_EVENT_MASK);
+
+    /* operation configure, a controller initialised again drops the mode bits and masks of the last one */
+    CAN_ApplyOperateMode(CANx, can_config->operate_mode, max_msg_buff);
+    if(PRETENDED_NETWORK_MODE == can_config->operate_mode)
+    {
+        /* Normal operation until the MCU enters Stop mode, then only the wake-up filter listens */
+        CAN_PnWriteFilter(CANx, can_config->pn_config);
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+
+    /* The ISRs see the handle only once it is complete */
+    if(idx_instance >= 0)
+    {
+        CAN_handle_arr[idx_instance] = can_handle;
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+
+    /* Out freeze mode */
+    CAN_ExitFreezeMode(can_handle);
+
+    return status;
+}
+
+Std_CAN_Status CAN_Reconfigure(CAN_Handle_type* can_handle, const CAN_Reconfig_type* reconfig)
+{
+    CAN_Type* CANx = can_handle->can_instance;
+    CAN_Bit_Timing_Result_type solved;
+    const CAN_Bit_Timing_Result_type* timing = NULL;
+    uint8_t can_mode = (CANx->MCR & CAN_MCR_FDEN_MASK) ? CANFD : CAN20;
+
+    if((NORMAL_MODE != reconfig->operate_mode) && (LOOP_BACK_MODE != reconfig->operate_mode)
+    && (LISTEN_ONLY_MODE != reconfig->operate_mode))
+    {
+        return CAN_E_NOT_OK;
+    }
+
+    /* Solve while the controller is still on the bus */
+    if(NULL == reconfig->bit_rate_config)
+    {
+        /* Bit timing kept */
+    }
+    else if(NULL != reconfig->bit_rate_config->fixed_timing)
+    {
+        timing = reconfig->bit_rate_config->fixed_timing;
+    }
+    else
+    {
+        uint32_t clock_hz = (CANx->CTRL1 & CAN_CTRL1_CLKSRC_MASK) ? CANCLK : fCANCLK;
+        if(CAN_E_OK != CAN_ComputeBitTiming(clock_hz, reconfig->bit_rate_config, can_mode, &solved))
+        {
+            return CAN_E_NOT_OK;
+        }
+        timing = &solved;
+    }
+
+    CAN_EnterFreezeMode(can_handle);
+
+    if(NULL != timing)
+    {
+        CAN_ApplyBitTiming(CANx, timing);
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+
+    if(CANFD == can_mode)
+    {
+        if(ENABLE_BRS == reconfig->bit_rate_sw)
+        {
+            CANx->FDCTRL |= CAN_FDCTRL_FDRATE_MASK;
+            can_handle->tx_cs_flags |= CAN_MB_CS_BRS_MASK;
+        }
+        else
+        {
+            CANx->FDCTRL &= ~CAN_FDCTRL_FDRATE_MASK;
+            can_handle->tx_cs_flags &= ~CAN_MB_CS_BRS_MASK;
+        }
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+
+    if((LISTEN_ONLY_MODE == reconfig->operate_mode) != (0U != (CANx->CTRL1 & CAN_CTRL1_LOM_MASK)))
+    {
+        /* Into or out of listen-only: the masks and CTRL2[EACEN] of CAN_Init for the new mode */
+        uint8_t num_masks = (CAN1 == CANx) ? CAN1_MB_COUNT : ((CAN2 == CANx) ? CAN2_MB_COUNT : CAN0_MB_COUNT);
+        CAN_ApplyOperateMode(CANx, reconfig->operate_mode, num_masks);
+    }
+    else
+    {
+        /* Between normal and loop back the filters stay */
+        CANx->CTRL1 &= ~CAN_CTRL1_LPB_MASK;
+        if(LOOP_BACK_MODE == reconfig->operate_mode)
+        {
+            CANx->CTRL1 |= CAN_CTRL1_LPB_MASK;
+        }
+        else
+        {
+            /* DO NOTHING */
+        }
+    }
+
+    CAN_ExitFreezeMode(can_handle);
+    /* Nominal bit times and the data phase ratio follow the new timing */
+    CAN_STATS_INIT(can_handle);
+
+    return CAN_E_OK;
+}
+
+void CAN_EnterFreezeMode(CAN_Handle_type* can_handle)
+{
+    CAN_Type* CANx = can_handle->can_instance;
+
+    CANx->MCR |= CAN_MCR_FRZ_MASK;
+    CANx->MCR |= CAN_MCR_HALT_MASK;
+    CAN_WAIT_WHILE(CANx, !((CANx->MCR & CAN_MCR_FRZACK_MASK) >> CAN_MCR_FRZACK_SHIFT));
+}
+
+void CAN_ExitFreezeMode(CAN_Handle_type* can_handle)
+{
+    CAN_Type* CANx = can_handle->can_instance;
+
+    CANx->MCR &= ~CAN_MCR_FRZ_MASK;
+    CANx->MCR &= ~CAN_MCR_HALT_MASK;
+    CAN_WAIT_WHILE(CANx, ((CANx->MCR & CAN_MCR_FRZACK_MASK) >> CAN_MCR_FRZACK_SHIFT));
+
+    CAN_WAIT_WHILE(CANx, (CANx->MCR & CAN_MCR_NOTRDY_MASK) >> CAN_MCR_NOTRDY_SHIFT);
+}
+
+const CAN_MsgBuffMap_type* CAN_GetMsgBuffMap(const CAN_Handle_type* can_handle)
+{
+    return &can_handle->mb_map;
+}
+
+void CAN_transmit_msg(CAN_Handle_type* can_handle, uint32_t id, uint8_t* data_buff)
+{
+    /* Sends a whole message buffer payload */
+    uint8_t length = (uint8_t)((can_handle->msg_buff_size - 2) * 4);
+    if(0U == (can_handle->tx_cs_flags & CAN_MB_CS_EDL_MASK))
+    {
+        length = 8;
+    }
+
+    /* Tx queue full or frame deferred by a Tx rate limit, wait for the Tx ISR or the tokens */
+    CAN_WAIT_WHILE(can_handle->can_instance, CAN_E_OK != CAN_Transmit(can_handle, id, data_buff, length));
+}
+
+uint8_t CAN_LengthToDlc(uint8_t length)
+{
+    uint8_t dlc = 0;
+    while((dlc < 15U) && (CAN_dlc_length_arr[dlc] < length))
+    {
+        dlc++;
+    }
+
+    return dlc;
+}
+
+uint8_t CAN_DlcToLength(const CAN_Handle_type* can_handle, uint8_t dlc)
+{
+    uint8_t length = CAN_dlc_length_arr[dlc & 0x0FU];
+    if((0U == (can_handle->tx_cs_flags & CAN_MB_CS_EDL_MASK)) && (length > 8U))
+    {
+        length = 8;
+    }
+
+    return length;
+}
+
+Std_CAN_Status CAN_Transmit(CAN_Handle_type* can_handle, uint32_t id, const uint8_t* data, uint8_t length)
+{
+    Std_CAN_Status status = CAN_E_NOT_OK;
+    uint8_t dlc = CAN_LengthToDlc(length);
+
+    /* The DLC must carry length bytes in this mode and some Tx MB of the layout must hold them */
+    if(((NULL != data) || (0U == length)) && (length <= CAN_DlcToLength(can_handle, dlc))
+    && (0U != CAN_TxFitMask(can_handle, dlc)))
+    {
+        CAN_Frame_type frame;
+        frame.id = id;
+        frame.dlc = dlc;
+        frame.timestamp = 0;
+        frame.priority = 0;
+        frame.flags = can_handle->tx_id_flags;
+
+        /* Copy the payload and pad up to the next DLC size and word boundary */
+        uint8_t padded = (uint8_t)((CAN_dlc_length_arr[frame.dlc] + 3U) & ~3U);
+        for(uint8_t data_idx = 0; data_idx < padded; data_idx++)
+        {
+            frame.data[data_idx] = (data_idx < length) ? data[data_idx] : CAN_FD_PADDING_BYTE;
+        }
+
+        status = CAN_TransmitAsync(can_handle, &frame);
+    }
+
+    return status;
+}
+
+Std_CAN_Status CAN_Receive(CAN_Handle_type* can_handle, uint32_t* id, uint8_t* data, uint8_t* length)
+{
+    CAN_Frame_type frame;
+    Std_CAN_Status status = CAN_TryReceive(can_handle, &frame);
+
+    if(CAN_E_OK == status)
+    {
+        /* A remote frame carries no data, its DLC only names the requested length */
+        uint8_t rx_length = (frame.flags & CAN_FRAME_FLAG_RTR) ? 0U : CAN_DlcToLength(can_handle, frame.dlc);
+        if(rx_length > *length)
+        {
+            rx_length = *length;
+        }
+        for(uint8_t data_idx = 0; data_idx < rx_length; data_idx++)
+        {
+            data[data_idx] = frame.data[data_idx];
+        }
+        *id = frame.id;
+        *length = rx_length;
+    }
+
+    return status;
+}
+
+Std_CAN_Status CAN_TransmitAsync(CAN_Handle_type* can_handle, const CAN_Frame_type* frame)
+{
+    Std_CAN_Status status = CAN_E_NOT_OK;
+
+    /* A frame no Tx MB can hold would block the queue head forever */
+    if((NULL != can_handle) && (NULL != frame) && (0U != CAN_TxFitMask(can_handle, frame->dlc)))
+    {
+        CAN_TxQueue_type* queue = &can_handle->tx_queue;
+
+        /* Neither the Tx ISR of this controller nor a gateway forwarding from another one may reorder the queue meanwhile */
+        uint32_t primask = CAN_CRITICAL_ENTER();
+
+        /* A slot stays reserved for a frame coming back from an abort */
+        uint8_t room = ((queue->count + ((0U != can_handle->tx_abort_map) ? 1U : 0U)) < CAN_TX_QUEUE_SIZE);
+        uint8_t limit = room ? CAN_TxLimitCheck(can_handle, frame->id, frame->flags, frame->dlc) : CAN_TX_LIMIT_PASS;
+        if(CAN_TX_LIMIT_PASS != limit)
+        {
+            /* Over its rate limit: refused for a later retry, or discarded */
+            status = (TX_LIMIT_DROP == limit) ? CAN_E_OK : CAN_E_NOT_OK;
+        }
+        else if(room)
+        {
+            CAN_TxQueuePush(queue, frame, queue->next_order++, 0U);
+            CAN_STATS_TX_QUEUED(can_handle);
+            CAN_ScheduleTx(can_handle);
+            status = CAN_E_OK;
+        }
+        else
+        {
+            /* Tx queue full */
+        }
+
+        CAN_CRITICAL_EXIT(primask);
+    }
+
+    return status;
+}
+
+Std_CAN_Status CAN_TransmitLatest(CAN_Handle_type* can_handle, const CAN_Frame_type* frame)
+{
+    Std_CAN_Status status = CAN_E_NOT_OK;
+    CAN_TxQueue_type* queue = &can_handle->tx_queue;
+    uint32_t key = CAN_TxKey(frame);
+
+    if(0U == CAN_TxFitMask(can_handle, frame->dlc))
+    {
+        return CAN_E_NOT_OK;
+    }
+
+    uint32_t primask = CAN_CRITICAL_ENTER();
+
+    /* Tagged frames belong to another module, e.g. a gateway, and are never merged */
+    for(uint8_t pos = 0; pos < queue->count; pos++)
+    {
+        uint8_t slot = queue->heap[pos];
+        if((queue->key[slot] == key) && (0U == queue->tag[slot])
+        && (0U == ((queue->frames[slot].flags ^ frame->flags) & (CAN_FRAME_FLAG_IDE | CAN_FRAME_FLAG_RTR))))
+        {
+            queue->frames[slot].dlc = frame->dlc;
+            memcpy(queue->frames[slot].data, frame->data, CAN_DlcToLength(can_handle, frame->dlc));
+            can_handle->stats.tx_replaced++;
+            status = CAN_E_OK;
+            break;
+        }
+    }
+
+    /* A merged frame adds nothing to the bus load */
+    uint8_t room = (CAN_E_OK != status)
+                && ((queue->count + ((0U != can_handle->tx_abort_map) ? 1U : 0U)) < CAN_TX_QUEUE_SIZE);
+    uint8_t limit = room ? CAN_TxLimitCheck(can_handle, frame->id, frame->flags, frame->dlc) : CAN_TX_LIMIT_PASS;
+    if(CAN_TX_LIMIT_PASS != limit)
+    {
+        status = (TX_LIMIT_DROP == limit) ? CAN_E_OK : CAN_E_NOT_OK;
+    }
+    else if(room)
+    {
+        CAN_TxQueuePush(queue, frame, queue->next_order++, 0U);
+        CAN_STATS_TX_QUEUED(can_handle);
+        CAN_ScheduleTx(can_handle);
+        status = CAN_E_OK;
+    }
+    else
+    {
+        /* Merged, or Tx queue full */
+    }
+
+    CAN_CRITICAL_EXIT(primask);
+
+    return status;
+}
+
+Std_CAN_Status CAN_ForwardMsgBuff(CAN_Handle_type* can_handle, const CAN_MsgView_type* view, uint32_t id, uint32_t tag)
+{
+    Std_CAN_Status status = CAN_E_NOT_OK;
+    CAN_Type* CAN_instance = can_handle->can_instance;
+    CAN_TxQueue_type* queue = &can_handle->tx_queue;
+    uint32_t fit_map = CAN_TxFitMask(can_handle, view->dlc);
+
+    /* A CAN 2.0 controller sends DLC 9-15 as 8 bytes, longer payloads would be cut */
+    if((0U == fit_map) || (view->length > CAN_DlcToLength(can_handle, view->dlc)))
+    {
+        return CAN_E_NOT_OK;
+    }
+
+    /* Runs in the Rx ISR of another controller: only a critical section, not this controller's IMASK1,
+       keeps the application and every other ISR off this Tx queue */
+    uint32_t primask = CAN_CRITICAL_ENTER();
+
+    uint8_t flags = (uint8_t)(CAN_FrameFlags(view->cs) & (CAN_FRAME_FLAG_IDE | CAN_FRAME_FLAG_RTR));
+    uint32_t key = CAN_MsgIdWord(id, flags);
+    uint32_t free_map = CAN_TxFreeMap(can_handle, key, fit_map);
+    uint8_t room = ((0U == queue->count) && (0U != free_map))
+                || ((queue->count + ((0U != can_handle->tx_abort_map) ? 1U : 0U)) < CAN_TX_QUEUE_SIZE);
+    uint8_t limit = room ? CAN_TxLimitCheck(can_handle, id, flags, view->dlc) : CAN_TX_LIMIT_PASS;
+    if(CAN_TX_LIMIT_PASS != limit)
+    {
+        status = (TX_LIMIT_DROP == limit) ? CAN_E_OK : CAN_E_NOT_OK;
+    }
+    else if((0U == queue->count) && (0U != free_map))
+    {
+        /* Nothing ranks before it: straight into a Tx MB, word for word */
+        uint8_t idx_mb = CAN_LOWEST_MB(free_map);
+        uint32_t base = can_handle->mb_map.mb_base[idx_mb];
+        uint8_t num_words = (flags & CAN_FRAME_FLAG_RTR) ? 0U : CAN_DlcToWords(can_handle, idx_mb, view->dlc);
+
+        can_handle->tx_free_map &= ~(1UL << idx_mb);
+        can_handle->tx_mb_order[idx_mb] = queue->next_order++;
+        can_handle->tx_mb_key[idx_mb] = key;
+        can_handle->tx_mb_tag[idx_mb] = tag;
+        CAN_STATS_TX_FORWARDED(can_handle, idx_mb);
+        CAN_instance->RAMn[base + 1U] = key;
+        for(uint8_t word = 0; word < num_words; word++)
+        {
+            CAN_instance->RAMn[base + 2U + word] = view->words[word];
+        }
+        CAN_instance->RAMn[base] = CAN_TxCsWord(can_handle, flags, view->dlc)
+                                 | ((uint32_t)CAN_MB_CODE_TX_DATA << CAN_MB_CS_CODE_SHIFT);
+        can_handle->stats.tx_frames++;
+        status = CAN_E_OK;
+    }
+    else if((queue->count + ((0U != can_handle->tx_abort_map) ? 1U : 0U)) < CAN_TX_QUEUE_SIZE)
+    {
+        CAN_Frame_type frame;
+        frame.id = id;
+        frame.dlc = view->dlc;
+        frame.priority = 0;
+        frame.flags = flags;
+        CAN_ReadPayload(view->words, frame.data, (uint8_t)((view->length + 3U) / 4U));
+        CAN_TxQueuePush(queue, &frame, queue->next_order++, tag);
+        CAN_STATS_TX_QUEUED(can_handle);
+        CAN_ScheduleTx(can_handle);
+        status = CAN_E_OK;
+    }
+    else
+    {
+        /* Tx queue full */
+    }
+
+    CAN_CRITICAL_EXIT(primask);
+
+    return status;
+}
+
+void CAN_SetHooks(CAN_Handle_type* can_handle, CAN_RxHook_type rx_hook, CAN_TxDoneHook_type tx_done_hook, void* context)
+{
+    CAN_Type* CAN_instance = can_handle->can_instance;
+
+    /* No interrupt may see half installed hooks */
+    uint32_t imask = CAN_instance->IMASK1;
+    CAN_instance->IMASK1 = 0;
+    CAN_COMPILER_BARRIER();
+    can_handle->rx_hook = rx_hook;
+    can_handle->tx_done_hook = tx_done_hook;
+    can_handle->hook_context = context;
+    CAN_COMPILER_BARRIER();
+    CAN_instance->IMASK1 = imask;
+}
+
+/* Remote answer message buffer set up for an identifier, -1 if none */
+static int8_t CAN_FindRemoteAnswer(const CAN_Handle_type* can_handle, uint32_t id_word, uint8_t flags)
+{
+    const CAN_Type* CAN_instance = can_handle->can_instance;
+
+    for(uint32_t map = can_handle->remote_mb_mask; 0U != map; map &= (map - 1U))
+    {
+        uint8_t idx_mb = CAN_LOWEST_MB(map);
+        uint32_t base = can_handle->mb_map.mb_base[idx_mb];
+        if(((CAN_instance->RAMn[base + 1U] & CAN_MB_ID_EXT_MASK) == id_word)
+        && ((0U != (CAN_instance->RAMn[base] & CAN_MB_CS_IDE_MASK)) == (0U != (flags & CAN_FRAME_FLAG_IDE))))
+        {
+            return (int8_t)idx_mb;
+        }
+    }
+
+    return -1;
+}
+
+/* CTRL2[RRS] is only writable in freeze mode: stores remote requests (1) or lets the remote answers reply (0) */
+static void CAN_SetRemoteRequestStoring(CAN_Handle_type* can_handle, uint8_t store)
+{
+    CAN_Type* CAN_instance = can_handle->can_instance;
+
+    if((0U != (CAN_instance->CTRL2 & CAN_CTRL2_RRS_MASK)) != (0U != store))
+    {
+        CAN_EnterFreezeMode(can_handle);
+        if(store)
+        {
+            CAN_instance->CTRL2 |= CAN_CTRL2_RRS_MASK;
+        }
+        else
+        {
+            CAN_instance->CTRL2 &= ~CAN_CTRL2_RRS_MASK;
+        }
+        CAN_ExitFreezeMode(can_handle);
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+}
+
+Std_CAN_Status CAN_SetRemoteAnswer(CAN_Handle_type* can_handle, const CAN_Frame_type* frame)
+{
+    Std_CAN_Status status = CAN_E_NOT_OK;
+    CAN_Type* CAN_instance = can_handle->can_instance;
+    uint8_t flags = (uint8_t)(frame->flags & CAN_FRAME_FLAG_IDE);
+    uint32_t id_word = CAN_MsgIdWord(frame->id, flags);
+
+    if(frame->dlc > 8U)
+    {
+        return CAN_E_NOT_OK;
+    }
+
+    /* Tx message buffers change roles, no Tx ISR and no forwarding gateway may run meanwhile */
+    uint32_t primask = CAN_CRITICAL_ENTER();
+
+    int8_t idx_mb = CAN_FindRemoteAnswer(can_handle, id_word, flags);
+    uint32_t free_map = can_handle->tx_free_map & CAN_TxFitMask(can_handle, frame->dlc);
+    if((idx_mb < 0) && (0U != free_map))
+    {
+        /* Highest free MB, the lower ones stay first in line for the Tx queue */
+        uint32_t mb_mask;
+        idx_mb = (int8_t)(31U - CAN_CLZ(free_map));
+        mb_mask = (uint32_t)(1UL << idx_mb);
+        can_handle->tx_mb_mask &= ~mb_mask;
+        can_handle->tx_free_map &= ~mb_mask;
+        can_handle->remote_mb_mask |= mb_mask;
+        CAN_instance->IMASK1 &= ~mb_mask;
+        CAN_CLEAR_IFLAG1(CAN_instance, mb_mask);
+    }
+    else
+    {
+        /* Update of an answer in place, or no MB left */
+    }
+
+    if(idx_mb >= 0)
+    {
+        uint32_t base = can_handle->mb_map.mb_base[idx_mb];
+
+        /* Deactivated while its content changes, an answer already on the bus completes */
+        CAN_instance->RAMn[base] = (uint32_t)CAN_MB_CODE_TX_INACTIVE << CAN_MB_CS_CODE_SHIFT;
+        CAN_instance->RAMn[base + 1U] = id_word;
+        CAN_WritePayload(&CAN_instance->RAMn[base + 2U], frame->data, (uint8_t)((frame->dlc + 3U) / 4U));
+        CAN_instance->RAMn[base] = ((flags & CAN_FRAME_FLAG_IDE) ? (CAN_MB_CS_IDE_MASK | CAN_MB_CS_SRR_MASK) : 0U)
+                                 | ((uint32_t)CAN_MB_CODE_TX_RANSWER << CAN_MB_CS_CODE_SHIFT)
+                                 | ((uint32_t)frame->dlc << CAN_MB_CS_DLC_SHIFT);
+        status = CAN_E_OK;
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+
+    CAN_CRITICAL_EXIT(primask);
+
+    if(CAN_E_OK == status)
+    {
+        CAN_SetRemoteRequestStoring(can_handle, 0U);
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+
+    return status;
+}
+
+Std_CAN_Status CAN_ClearRemoteAnswer(CAN_Handle_type* can_handle, uint32_t id, uint8_t flags)
+{
+    Std_CAN_Status status = CAN_E_NOT_OK;
+    CAN_Type* CAN_instance = can_handle->can_instance;
+    uint32_t id_word = CAN_MsgIdWord(id, flags);
+
+    uint32_t primask = CAN_CRITICAL_ENTER();
+
+    int8_t idx_mb = CAN_FindRemoteAnswer(can_handle, id_word, flags);
+    if(idx_mb >= 0)
+    {
+        uint32_t mb_mask = (uint32_t)(1UL << idx_mb);
+
+        /* Back into the Tx pool, a frame waiting for a fitting MB may take it right away */
+        CAN_instance->RAMn[can_handle->mb_map.mb_base[idx_mb]] = (uint32_t)CAN_MB_CODE_TX_INACTIVE << CAN_MB_CS_CODE_SHIFT;
+        CAN_CLEAR_IFLAG1(CAN_instance, mb_mask);
+        can_handle->remote_mb_mask &= ~mb_mask;
+        can_handle->tx_mb_mask |= mb_mask;
+        can_handle->tx_free_map |= mb_mask;
+        CAN_instance->IMASK1 |= mb_mask;
+        CAN_ScheduleTx(can_handle);
+        status = CAN_E_OK;
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+
+    CAN_CRITICAL_EXIT(primask);
+
+    if((CAN_E_OK == status) && (0U == can_handle->remote_mb_mask))
+    {
+        CAN_SetRemoteRequestStoring(can_handle, 1U);
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+
+    return status;
+}
+
+Std_CAN_Status CAN_SetTxLimits(CAN_Handle_type* can_handle, const CAN_TxLimit_type* limits, uint8_t num_limits)
+{
+    CAN_Type* CAN_instance = can_handle->can_instance;
+
+    if((num_limits > CAN_TX_LIMIT_MAX_CLASSES) || ((NULL == limits) && (0U != num_limits)))
+    {
+        return CAN_E_NOT_OK;
+    }
+    for(uint8_t idx = 0; idx < num_limits; idx++)
+    {
+        if((0U == limits[idx].load_permille) || (limits[idx].load_permille > 1000U)
+        || (0U == limits[idx].burst_bits) || (limits[idx].burst_bits > CAN_TX_LIMIT_MAX_BURST))
+        {
+            return CAN_E_NOT_OK;
+        }
+    }
+
+    /* Buckets are charged inside the critical section and refilled from the Tx ISR */
+    uint32_t primask = CAN_CRITICAL_ENTER();
+    for(uint8_t idx = 0; idx < num_limits; idx++)
+    {
+        CAN_TxLimitClass_type* limit_class = &can_handle->tx_limit[idx];
+        limit_class->limit = limits[idx];
+        limit_class->credit = 1000U * limits[idx].burst_bits;
+        memset(&limit_class->stats, 0, sizeof(limit_class->stats));
+    }
+    can_handle->num_tx_limits = num_limits;
+    can_handle->tx_limit_timer = (uint16_t)CAN_instance->TIMER;
+    CAN_CRITICAL_EXIT(primask);
 
-    if(can_instance->MCR & CAN_MCR_FDEN_SHIFT)
+    return CAN_E_OK;
+}
+
+void CAN_TxLimitMainFunction(CAN_Handle_type* can_handle)
+{
+    /* The Tx ISR and senders in other contexts refill the same buckets */
+    uint32_t primask = CAN_CRITICAL_ENTER();
+    if(0U != can_handle->num_tx_limits)
     {
-        can_instance->CBT = 0x802FB9EF;
-        can_instance->FDCBT = 0x00131CE3;
+        CAN_TxLimitRefill(can_handle);
     }
     else
     {
-        float cr_samp_point = bit_rate_config->samp_point/(float)100;
-        uint8_t cr_time_quanta = (uint8_t)(((float)bit_rate_config->time_quanta) * cr_samp_point);
-        uint8_t sync_seg = 1;
-        uint8_t phase_seg2 = (bit_rate_config->time_quanta - cr_time_quanta);
-        uint8_t phase_seg1 = phase_seg2;
-        uint8_t prop_seg = bit_rate_config->time_quanta - phase_seg1 - phase_seg2 - sync_seg;
-        uint32_t f_Sclock = bit_rate_config->time_quanta * bit_rate_config->nominal_bit_Rate;
-        uint8_t prescaler_val = 1 - (fCANCLK / f_Sclock);
-        uint8_t rjw = 3;
-        if(phase_seg2 < 4)
-        {
-            rjw = phase_seg2 - 1;
-        }
-        else
-        {
-            /* DO NOTHING */
-        }
-        can_instance->CBT |= CAN_CBT_BTF_MASK;
-        can_instance->CBT |= CAN_CBT_EPRESDIV(prescaler_val);
-        can_instance->CBT |= CAN_CBT_ERJW(rjw);
-        can_instance->CBT |= CAN_CBT_EPSEG1(phase_seg1 - 1);
-        can_instance->CBT |= CAN_CBT_EPSEG2(phase_seg2 - 1);
-        can_instance->CBT |= CAN_CBT_EPROPSEG(prop_seg - 1);
+        /* DO NOTHING */
+    }
+    CAN_CRITICAL_EXIT(primask);
+}
+
+Std_CAN_Status CAN_GetTxLimitStats(CAN_Handle_type* can_handle, uint8_t idx_limit, CAN_TxLimitStats_type* stats)
+{
+    if(idx_limit >= can_handle->num_tx_limits)
+    {
+        return CAN_E_NOT_OK;
+    }
+
+    uint32_t primask = CAN_CRITICAL_ENTER();
+    *stats = can_handle->tx_limit[idx_limit].stats;
+    CAN_CRITICAL_EXIT(primask);
+
+    return CAN_E_OK;
+}
+
+void CAN_receive_msg(CAN_Handle_type* can_handle, uint8_t *rx_buff, uint16_t length_buff)
+{
+    CAN_Frame_type frame;
+    CAN_WAIT_WHILE(can_handle->can_instance, CAN_E_OK != CAN_TryReceive(can_handle, &frame));
+
+    uint16_t num_bytes = (frame.flags & CAN_FRAME_FLAG_RTR) ? 0U : CAN_DlcToLength(can_handle, frame.dlc);
+    for(uint16_t rx_idx = 0; (rx_idx < length_buff) && (rx_idx < num_bytes); rx_idx++)
+    {
+        rx_buff[rx_idx] = frame.data[rx_idx];
+    }
+}
+
+Std_CAN_Status CAN_TryReceive(CAN_Handle_type* can_handle, CAN_Frame_type* frame)
+{
+    Std_CAN_Status status = CAN_E_NOT_OK;
+    CAN_RxRing_type* ring = (NULL != can_handle) ? &can_handle->rx_ring : NULL;
+
+    if((NULL != ring) && (NULL != frame) && (ring->head != ring->tail))
+    {
+        uint16_t tail = ring->tail;
+        *frame = ring->frames[tail & (CAN_RX_RING_SIZE - 1U)];
+        CAN_COMPILER_BARRIER();
+        ring->tail = (uint16_t)(tail + 1U);
+        status = CAN_E_OK;
     }
 
     return status;
 }
 
-Std_CAN_Status CAN_Init(CAN_Config_type* can_config)
+Std_CAN_Status CAN_PeekMsgBuff(CAN_Handle_type* can_handle, CAN_MsgView_type* view)
 {
-    Std_CAN_Status status = CAN_E_OK;
-    /* CANx is CAN0 or CAN1 or CAN2 */
-    CAN_Type* CANx = can_config->can_instance;
-    /* Disable module before selecting clock*/
-    CANx->MCR |= CAN_MCR_MDIS_MASK;
-    while(!((CANx->MCR & CAN_MCR_LPMACK_MASK) >> CAN_MCR_LPMACK_SHIFT))
+    Std_CAN_Status status = CAN_E_NOT_OK;
+    CAN_Type* CAN_instance = can_handle->can_instance;
+    uint32_t pending = CAN_instance->IFLAG1 & can_handle->rx_peek_mask;
+
+    if((NULL != view) && (0U != pending))
     {
-        /* DO NOTHING */
+        uint8_t idx_mb = (ENABLE_RX_FIFO == can_handle->rx_fifo) ? 0U : CAN_LOWEST_MB(pending);
+        uint32_t base = can_handle->mb_map.mb_base[idx_mb];
+        uint32_t cs = CAN_instance->RAMn[base];
+        uint32_t id = CAN_instance->RAMn[base + 1U];
+
+        view->cs = cs;
+        view->id = (cs & CAN_MB_CS_IDE_MASK) ? (id & CAN_MB_ID_EXT_MASK)
+                                             : ((id & CAN_MB_ID_STD_MASK) >> CAN_WMBn_CS_STD_ID_SHIFT);
+        view->dlc = (uint8_t)((cs & CAN_MB_CS_DLC_MASK) >> CAN_MB_CS_DLC_SHIFT);
+        view->length = (cs & CAN_MB_CS_RTR_MASK) ? 0U : CAN_DlcToLength(can_handle, view->dlc);
+        view->timestamp = (uint16_t)(cs & CAN_MB_CS_TIMESTAMP_MASK);
+        view->idx_mb = idx_mb;
+        view->words = &CAN_instance->RAMn[base + 2U];
+        status = CAN_E_OK;
     }
 
-    /* setting clock*/
-    if(BUS_CLOCK == can_config->clock_source)
+    return status;
+}
+
+Std_CAN_Status CAN_ReleaseMsgBuff(CAN_Handle_type* can_handle, const CAN_MsgView_type* view)
+{
+    Std_CAN_Status status = CAN_E_NOT_OK;
+    CAN_Type* CAN_instance = can_handle->can_instance;
+    uint32_t base = can_handle->mb_map.mb_base[view->idx_mb];
+    uint32_t mb_mask = (ENABLE_RX_FIFO == can_handle->rx_fifo) ? CAN_IFLAG1_BUF5I_MASK : (uint32_t)(1UL << view->idx_mb);
+
+    /* Same CS word (code, DLC and timestamp): no frame arrived while the view was in use. The flag is cleared
+       while the MB is still locked and TIMER is read last, so a frame arriving after the unlock keeps its flag */
+    uint32_t cs = CAN_instance->RAMn[base];
+    if(cs == view->cs)
     {
-        CANx->CTRL1 |= CAN_CTRL1_CLKSRC_MASK;
+        CAN_CLEAR_IFLAG1(CAN_instance, mb_mask);
+        CAN_STATS_RX(can_handle, view->idx_mb, view->id, (ENABLE_RX_FIFO == can_handle->rx_fifo) ? (cs & ~CAN_MB_CS_CODE_MASK) : cs);
+        can_handle->stats.rx_frames++;
+        status = CAN_E_OK;
     }
     else
     {
-        CANx->CTRL1 &= ~CAN_CTRL1_CLKSRC_MASK;
+        can_handle->stats.rx_overflow++;
     }
+    (void)CAN_instance->TIMER;
 
-    /* Enable module after selecting clock and enter freeze mode(MCR[FRZ], MCR[HALT] is auto set)*/
-    CANx->MCR &= ~CAN_MCR_MDIS_MASK;
-    while(((CANx->MCR & CAN_MCR_LPMACK_MASK) >> CAN_MCR_LPMACK_SHIFT))
+    if((ENABLE_RX_FIFO == can_handle->rx_fifo) && (CAN_instance->IFLAG1 & CAN_IFLAG1_BUF7I_MASK))
     {
-        /* DO NOTHING */
+        can_handle->stats.rx_overflow++;
+        CAN_STATS_RX_OVERRUN(can_handle, 0U);
+        CAN_CLEAR_IFLAG1(CAN_instance, CAN_IFLAG1_BUF6I_MASK | CAN_IFLAG1_BUF7I_MASK);
     }
-    while (!((CANx->MCR & CAN_MCR_FRZACK_MASK) >> CAN_MCR_FRZACK_SHIFT))
+    else
     {
         /* DO NOTHING */
     }
 
-    /* Set CAN mode(CAN 2.0 or FlexCAN) */
-    if(CANFD == can_config->can_mode)
+    return status;
+}
+
+uint16_t CAN_ReceiveBatch(CAN_Handle_type* can_handle, CAN_Frame_type* frames, uint16_t max_frames)
+{
+    uint16_t count = 0;
+    CAN_RxRing_type* ring = (NULL != can_handle) ? &can_handle->rx_ring : NULL;
+
+    if((NULL != ring) && (NULL != frames))
     {
-        CANx->MCR |= CAN_MCR_FDEN_MASK;
-        /* Switching BRS */
-        if(ENABLE_BRS == can_config->bit_rate_sw)
+        uint16_t tail = ring->tail;
+        uint16_t available = (uint16_t)(ring->head - tail);
+        if(available > max_frames)
         {
-            CANx->FDCTRL |= CAN_FDCTRL_FDRATE_MASK;
+            available = max_frames;
         }
-        else
+        for(count = 0; count < available; count++)
         {
-            /* DO NOTHING */
+            frames[count] = ring->frames[(uint16_t)(tail + count) & (CAN_RX_RING_SIZE - 1U)];
         }
+        CAN_COMPILER_BARRIER();
+        ring->tail = (uint16_t)(tail + count);
+    }
+
+    return count;
+}
+
+#ifdef CAN_STATS_ENABLE
+void CAN_GetStatsSnapshot(CAN_Handle_type* can_handle, CAN_StatsSnapshot_type* snapshot)
+{
+    /* Gateways forwarding from other controllers count here too, so the copy is taken in a critical section */
+    uint32_t primask = CAN_CRITICAL_ENTER();
+    CAN_StatsElapse(can_handle);
+    *snapshot = can_handle->stats_state.live;
+    CAN_CRITICAL_EXIT(primask);
+
+    snapshot->bus_load_permille = 0;
+    if(0U != snapshot->bus_ticks)
+    {
+        uint64_t load = (snapshot->bus_bits * 1000U) / snapshot->bus_ticks;
+        snapshot->bus_load_permille = (uint16_t)((load > 1000U) ? 1000U : load);
+    }
+}
+
+void CAN_StatsMainFunction(CAN_Handle_type* can_handle)
+{
+    /* The Rx and Tx ISRs elapse the same window */
+    uint32_t primask = CAN_CRITICAL_ENTER();
+    CAN_StatsElapse(can_handle);
+    CAN_CRITICAL_EXIT(primask);
+}
+
+void CAN_ResetStats(CAN_Handle_type* can_handle)
+{
+    CAN_Type* CAN_instance = can_handle->can_instance;
+    CAN_StatsState_type* state = &can_handle->stats_state;
 
-        /* payload configure */
+    uint32_t primask = CAN_CRITICAL_ENTER();
+    memset(&state->live, 0, sizeof(state->live));
+    state->last_timer = (uint16_t)CAN_instance->TIMER;
 
-        switch (can_config->payload)
+    /* Ratio of the data phase to the nominal bit time from the programmed prescalers and segments */
+    uint32_t cbt = CAN_instance->CBT;
+    uint32_t fdcbt = CAN_instance->FDCBT;
+    uint32_t nominal = (((cbt & CAN_CBT_EPRESDIV_MASK) >> CAN_CBT_EPRESDIV_SHIFT) + 1U)
+                     * (4U + ((cbt & CAN_CBT_EPROPSEG_MASK) >> CAN_CBT_EPROPSEG_SHIFT)
+                           + ((cbt & CAN_CBT_EPSEG1_MASK) >> CAN_CBT_EPSEG1_SHIFT)
+                           + ((cbt & CAN_CBT_EPSEG2_MASK) >> CAN_CBT_EPSEG2_SHIFT));
+    uint32_t data = (((fdcbt & CAN_FDCBT_FPRESDIV_MASK) >> CAN_FDCBT_FPRESDIV_SHIFT) + 1U)
+                  * (3U + ((fdcbt & CAN_FDCBT_FPROPSEG_MASK) >> CAN_FDCBT_FPROPSEG_SHIFT)
+                        + ((fdcbt & CAN_FDCBT_FPSEG1_MASK) >> CAN_FDCBT_FPSEG1_SHIFT)
+                        + ((fdcbt & CAN_FDCBT_FPSEG2_MASK) >> CAN_FDCBT_FPSEG2_SHIFT));
+    state->data_bit_q8 = (uint16_t)(((data << 8) + (nominal / 2U)) / nominal);
+    if((0U == (CAN_instance->MCR & CAN_MCR_FDEN_MASK)) || (state->data_bit_q8 > 256U))
+    {
+        state->data_bit_q8 = 256U;
+    }
+    CAN_CRITICAL_EXIT(primask);
+}
+#endif
+
+void CAN_IRQHandler(CAN_Handle_type* can_handle)
+{
+    CAN_Type* CAN_instance = can_handle->can_instance;
+    uint32_t pending = CAN_instance->IFLAG1 & CAN_instance->IMASK1;
+
+    if((ENABLE_RX_FIFO == can_handle->rx_fifo) && (pending & CAN_IFLAG1_RX_FIFO_MASK))
+    {
+        pending &= ~CAN_IFLAG1_RX_FIFO_MASK;
+        CAN_DrainRxFifo(can_handle);
+    }
+
+    while(0U != pending)
+    {
+        uint8_t idx_mb = CAN_LOWEST_MB(pending);
+        uint32_t mb_mask = (uint32_t)(1UL << idx_mb);
+        pending &= ~mb_mask;
+        if(can_handle->tx_mb_mask & mb_mask)
         {
-        case PAYLOAD_8_BYTES:
-            can_config->can_instance->FDCTRL |= CAN_FDCTRL_MBDSR0(0);
-            can_config->can_instance->MCR &= ~CAN_MCR_MAXMB_MASK;
-            can_config->can_instance->MCR |= CAN_MCR_MAXMB(31);
-            msg_buff_size = 4;
-            num_msg_buff = 32;
-            break;
-        case PAYLOAD_16_BYTES:
-            can_config->can_instance->FDCTRL |= CAN_FDCTRL_MBDSR0(1);
-            can_config->can_instance->MCR &= ~CAN_MCR_MAXMB_MASK;
-            can_config->can_instance->MCR |= CAN_MCR_MAXMB(20);
-            msg_buff_size = 6;
-            num_msg_buff = 21;
-            break;
-        case PAYLOAD_32_BYTES:
-            can_config->can_instance->FDCTRL |= CAN_FDCTRL_MBDSR0(2);
-            can_config->can_instance->MCR &= ~CAN_MCR_MAXMB_MASK;
-            can_config->can_instance->MCR |= CAN_MCR_MAXMB(11);
-            msg_buff_size = 10;
-            num_msg_buff = 12;
-            break;
-        case PAYLOAD_64_BYTES:
-            can_config->can_instance->FDCTRL |= CAN_FDCTRL_MBDSR0(3);
-            can_config->can_instance->MCR &= ~CAN_MCR_MAXMB_MASK;
-            can_config->can_instance->MCR |= CAN_MCR_MAXMB(6);
-            msg_buff_size = 18;
-            num_msg_buff = 7;
-            break;
-        default:
-            break;
+            /* Tx complete or aborted: the MB is free again, load the highest ranked queued frames.
+               A gateway ISR of higher priority forwarding to this controller must not preempt the queue update */
+            uint32_t primask = CAN_CRITICAL_ENTER();
+            CAN_CLEAR_IFLAG1(CAN_instance, mb_mask);
+            if(0U != can_handle->num_tx_limits)
+            {
+                /* Refilled once per frame, so no TIMER wrap is lost while the bus is busy */
+                CAN_TxLimitRefill(can_handle);
+            }
+            else
+            {
+                /* DO NOTHING */
+            }
+            if(can_handle->tx_abort_map & mb_mask)
+            {
+                uint32_t base = can_handle->mb_map.mb_base[idx_mb];
+                can_handle->tx_abort_map &= ~mb_mask;
+                if(CAN_MB_CODE_TX_ABORT == ((CAN_instance->RAMn[base] & CAN_MB_CS_CODE_MASK) >> CAN_MB_CS_CODE_SHIFT))
+                {
+                    /* Not sent: back into the queue at its original rank */
+                    CAN_Frame_type frame;
+                    (void)CAN_ReadMsgBuff(can_handle, idx_mb, &frame);
+                    frame.priority = (uint8_t)(CAN_instance->RAMn[base + 1U] >> CAN_MB_ID_PRIO_SHIFT);
+                    CAN_STATS_TX_ABORTED(can_handle, idx_mb, &frame);
+                    CAN_TxQueuePush(&can_handle->tx_queue, &frame, can_handle->tx_mb_order[idx_mb], can_handle->tx_mb_tag[idx_mb]);
+                    can_handle->stats.tx_frames--;
+                }
+                else
+                {
+                    /* Sent before the abort took effect */
+                    CAN_STATS_TX_DONE(can_handle, idx_mb);
+                    CAN_TxDone(can_handle, idx_mb);
+                }
+            }
+            else
+            {
+                CAN_STATS_TX_DONE(can_handle, idx_mb);
+                CAN_TxDone(can_handle, idx_mb);
+            }
+            can_handle->tx_free_map |= mb_mask;
+            CAN_ScheduleTx(can_handle);
+            CAN_CRITICAL_EXIT(primask);
+        }
+        else
+        {
+            CAN_RxRing_type* ring = &can_handle->rx_ring;
+            uint32_t base = can_handle->mb_map.mb_base[idx_mb];
+            uint8_t consumed = 0U;
+            if(NULL != can_handle->rx_hook)
+            {
+                /* Reading CS locks the MB, it must come before the ID. Argument evaluation order is unspecified */
+                uint32_t cs = CAN_instance->RAMn[base];
+                uint32_t id = CAN_instance->RAMn[base + 1U];
+                consumed = (CAN_E_OK == CAN_OfferRxHook(can_handle, idx_mb, cs, id, &CAN_instance->RAMn[base + 2U])) ? 1U : 0U;
+            }
+            else
+            {
+                /* DO NOTHING */
+            }
+
+            if(consumed)
+            {
+                /* Consumed in place */
+            }
+            else if((uint16_t)(ring->head - ring->tail) < CAN_RX_RING_SIZE)
+            {
+                uint16_t head = ring->head;
+                uint32_t cs = CAN_ReadMsgBuff(can_handle, idx_mb, &ring->frames[head & (CAN_RX_RING_SIZE - 1U)]);
+                CAN_STATS_RX(can_handle, idx_mb, ring->frames[head & (CAN_RX_RING_SIZE - 1U)].id, cs);
+                CAN_COMPILER_BARRIER();
+                ring->head = (uint16_t)(head + 1U);
+                can_handle->stats.rx_frames++;
+            }
+            else
+            {
+                /* Lock the MB, the unlock below lets it receive again */
+                (void)CAN_instance->RAMn[base];
+                can_handle->stats.rx_overflow++;
+            }
+            /* Flag cleared while the MB is still locked, then reading TIMER unlocks it (reference manual order) */
+            CAN_CLEAR_IFLAG1(CAN_instance, mb_mask);
+            (void)CAN_instance->TIMER;
         }
     }
-    else
+}
+
+void CAN_DmaIRQHandler(CAN_Handle_type* can_handle)
+{
+    CAN_RxRing_type* ring = &can_handle->rx_ring;
+    uint8_t ch = can_handle->rx_dma_channel;
+    uint16_t read = can_handle->rx_dma_read;
+    uint16_t write;
+
+    DMA->CINT = ch;
+
+    /* CITER counts the frames left in the major loop, it is reloaded once the buffer wrapped */
+    write = (uint16_t)(can_handle->rx_dma_frames - (DMA->TCD[ch].CITER.ELINKNO & DMA_TCD_CITER_ELINKNO_CITER_MASK));
+    while(read != write)
     {
-        CANx->MCR |= CAN_MCR_MAXMB(31);
-        msg_buff_size = 4;
-        num_msg_buff = 32;
+        const CAN_DmaFrame_type* buf = &can_handle->rx_dma_buffer[read];
+        uint16_t head = ring->head;
+        if((NULL != can_handle->rx_hook) && (CAN_E_OK == CAN_OfferRxHook(can_handle, 0U, buf->cs, buf->id, buf->data)))
+        {
+            /* Consumed by the hook */
+        }
+        else if((uint16_t)(head - ring->tail) < CAN_RX_RING_SIZE)
+        {
+            CAN_Frame_type* frame = &ring->frames[head & (CAN_RX_RING_SIZE - 1U)];
+            if(buf->cs & CAN_MB_CS_IDE_MASK)
+            {
+                frame->id = buf->id & CAN_MB_ID_EXT_MASK;
+            }
+            else
+            {
+                frame->id = (buf->id & CAN_MB_ID_STD_MASK) >> CAN_WMBn_CS_STD_ID_SHIFT;
+            }
+            frame->dlc = (uint8_t)((buf->cs & CAN_MB_CS_DLC_MASK) >> CAN_MB_CS_DLC_SHIFT);
+            frame->timestamp = (uint16_t)(buf->cs & CAN_MB_CS_TIMESTAMP_MASK);
+            frame->flags = CAN_FrameFlags(buf->cs);
+            CAN_ReadPayload(buf->data, frame->data, 2U);
+            CAN_STATS_RX(can_handle, 0U, frame->id, buf->cs & ~CAN_MB_CS_CODE_MASK);
+            CAN_COMPILER_BARRIER();
+            ring->head = (uint16_t)(head + 1U);
+            can_handle->stats.rx_frames++;
+        }
+        else
+        {
+            can_handle->stats.rx_overflow++;
+        }
+        read++;
+        if(read >= can_handle->rx_dma_frames)
+        {
+            read = 0;
+        }
     }
-    /* configue bit timing */
-    CAN_BitRateConfig(CANx, can_config->bit_rate_config);
+    can_handle->rx_dma_read = read;
+}
 
-    for(volatile uint8_t idx = 0; idx < 128U; idx++)
+/* Fault confinement state of an ESR1 value */
+static uint8_t CAN_FaultState(uint32_t esr1)
+{
+    uint8_t fltconf = (uint8_t)((esr1 & CAN_ESR1_FLTCONF_MASK) >> CAN_ESR1_FLTCONF_SHIFT);
+    uint8_t state = BUS_OFF;
+    if(0U == fltconf)
     {
-        CANx->RAMn[idx] = 0;
+        state = ERROR_ACTIVE;
     }
-
-    /* init 32 msg buff filter */
-    for(uint8_t idx = 0; idx < num_msg_buff; idx++)
+    else if(1U == fltconf)
+    {
+        state = ERROR_PASSIVE;
+    }
+    else
     {
-        CANx->RXIMR[idx] = 0xFFFFFFFF;
+        /* DO NOTHING */
     }
 
-    /* Enable for reception */
-    for(uint8_t idx = 0; idx < (uint8_t)(num_msg_buff / 2); idx++)
+    return state;
+}
+
+static void CAN_SetErrorState(CAN_Handle_type* can_handle, uint8_t state, uint32_t esr1)
+{
+    if(state != can_handle->error_status.state)
     {
-        CANx->RAMn[idx*msg_buff_size] = 0x04000000;
-        CANx->RAMn[idx*msg_buff_size] |= (uint32_t)(1 << 31);
+        can_handle->error_status.state = state;
+        if(NULL != can_handle->error_callback)
+        {
+            can_handle->error_callback(can_handle, state, esr1);
+        }
     }
+}
+
+/* Drops every queued and loaded Tx frame. Bus off: the Tx MBs are not in arbitration, so they are deactivated without a flag */
+static void CAN_FlushTx(CAN_Handle_type* can_handle)
+{
+    CAN_Type* CAN_instance = can_handle->can_instance;
+    uint32_t primask = CAN_CRITICAL_ENTER();
 
-    for(uint8_t idx = (uint8_t)(num_msg_buff / 2); idx < num_msg_buff; idx++)
+    for(uint32_t map = can_handle->tx_mb_mask & ~can_handle->tx_free_map; 0U != map; map &= (map - 1U))
     {
-        CANx->RAMn[idx*msg_buff_size] = 0x08000000;
-        CANx->RAMn[idx*msg_buff_size] |= (uint32_t)(1 << 31);
+        uint32_t base = can_handle->mb_map.mb_base[CAN_LOWEST_MB(map)];
+        CAN_instance->RAMn[base] = (CAN_instance->RAMn[base] & ~CAN_MB_CS_CODE_MASK)
+                                 | ((uint32_t)CAN_MB_CODE_TX_INACTIVE << CAN_MB_CS_CODE_SHIFT);
     }
+    CAN_CLEAR_IFLAG1(CAN_instance, can_handle->tx_mb_mask);
+    can_handle->tx_free_map = can_handle->tx_mb_mask;
+    can_handle->tx_abort_map = 0;
+    CAN_TxQueueReset(&can_handle->tx_queue);
+    CAN_CRITICAL_EXIT(primask);
+}
+
+void CAN_ErrorIRQHandler(CAN_Handle_type* can_handle)
+{
+    CAN_Type* CAN_instance = can_handle->can_instance;
+    CAN_ErrorStatus_type* status = &can_handle->error_status;
+    uint32_t esr1 = CAN_instance->ESR1;
+    uint32_t events = esr1 & CAN_ESR1_EVENT_MASK;
 
-    volatile uint8_t idx = 0;
-    while((idx < num_msg_buff) && (0x84000000 != CANx->RAMn[idx*msg_buff_size]))
+    CAN_CLEAR_ESR1(CAN_instance, events);
+
+    if(events & (CAN_ESR1_ERRINT_MASK | CAN_ESR1_ERRINT_FAST_MASK))
     {
-    	idx++;
+        status->error_frames++;
+        status->last_errors = esr1 & CAN_ESR1_ERROR_MASK;
     }
 
-    /* write Rx ID into msg buf */
-    if(STARDADARD_ID == can_config->id_type)
+    if(events & CAN_ESR1_BOFFINT_MASK)
     {
-        CANx->RAMn[idx*msg_buff_size + 1] = ((can_config->rx_identifier) << CAN_WMBn_CS_STD_ID_SHIFT);
+        status->bus_off_count++;
+        CAN_SetErrorState(can_handle, BUS_OFF, esr1);
+        if(FLUSH_TX_QUEUE == can_handle->busoff_tx)
+        {
+            CAN_FlushTx(can_handle);
+        }
+        if(FAST_RECOVERY == can_handle->busoff_recovery)
+        {
+            /* ECR is writable in freeze mode only: request it here, CAN_ErrorMainFunction waits for FRZACK */
+            CAN_instance->MCR |= CAN_MCR_FRZ_MASK | CAN_MCR_HALT_MASK;
+            can_handle->busoff_step = CAN_BUSOFF_STEP_FREEZE;
+        }
     }
-    else
+
+    CAN_SetErrorState(can_handle, CAN_FaultState(esr1), esr1);
+
+    uint32_t ecr = CAN_instance->ECR;
+    status->tx_error_count = (uint8_t)((ecr & CAN_ECR_TXERRCNT_MASK) >> CAN_ECR_TXERRCNT_SHIFT);
+    status->rx_error_count = (uint8_t)((ecr & CAN_ECR_RXERRCNT_MASK) >> CAN_ECR_RXERRCNT_SHIFT);
+}
+
+void CAN_ErrorMainFunction(CAN_Handle_type* can_handle)
+{
+    CAN_Type* CAN_instance = can_handle->can_instance;
+    uint32_t mcr = CAN_instance->MCR;
+
+    if(CAN_BUSOFF_STEP_FREEZE == can_handle->busoff_step)
     {
-        CANx->RAMn[idx*msg_buff_size + 1] = ((can_config->rx_identifier));
+        if(mcr & CAN_MCR_FRZACK_MASK)
+        {
+            /* Clearing TXERRCNT leaves bus off */
+            CAN_instance->ECR = 0;
+            CAN_instance->MCR = mcr & ~(CAN_MCR_FRZ_MASK | CAN_MCR_HALT_MASK);
+            can_handle->busoff_step = CAN_BUSOFF_STEP_RESUME;
+        }
+        else
+        {
+            /* Still on its way, or left meanwhile by another freeze mode user: keep requesting it */
+            CAN_instance->MCR = mcr | CAN_MCR_FRZ_MASK | CAN_MCR_HALT_MASK;
+        }
     }
-    /* operation configure */
-    if(LOOP_BACK_MODE == can_config->operate_mode)
+    else if(CAN_BUSOFF_STEP_RESUME == can_handle->busoff_step)
     {
-        CANx->CTRL1 |= CAN_CTRL1_LPB_MASK;
+        if(0U == (mcr & (CAN_MCR_FRZACK_MASK | CAN_MCR_NOTRDY_MASK)))
+        {
+            uint32_t esr1 = CAN_instance->ESR1;
+            can_handle->busoff_step = CAN_BUSOFF_STEP_IDLE;
+            CAN_SetErrorState(can_handle, CAN_FaultState(esr1), esr1);
+        }
+        else
+        {
+            /* DO NOTHING */
+        }
     }
     else
     {
         /* DO NOTHING */
     }
+}
 
-    /* Out freeze mode */
-    CANx->MCR &= ~CAN_MCR_FRZ_MASK;
-    CANx->MCR &= ~CAN_MCR_HALT_MASK;
-    while (((CANx->MCR & CAN_MCR_FRZACK_MASK) >> CAN_MCR_FRZACK_SHIFT))
+void CAN_GetErrorStatus(CAN_Handle_type* can_handle, CAN_ErrorStatus_type* status)
+{
+    CAN_Type* CAN_instance = can_handle->can_instance;
+    uint32_t esr1 = CAN_instance->ESR1;
+
+    /* Pending events are left to the ISR, only the silent way back from error passive is taken here */
+    if(0U == (esr1 & CAN_ESR1_EVENT_MASK))
     {
-        /* DO NOTHING */
+        CAN_SetErrorState(can_handle, CAN_FaultState(esr1), esr1);
+    }
+
+    uint32_t ecr = CAN_instance->ECR;
+    can_handle->error_status.tx_error_count = (uint8_t)((ecr & CAN_ECR_TXERRCNT_MASK) >> CAN_ECR_TXERRCNT_SHIFT);
+    can_handle->error_status.rx_error_count = (uint8_t)((ecr & CAN_ECR_RXERRCNT_MASK) >> CAN_ECR_RXERRCNT_SHIFT);
+    *status = can_handle->error_status;
+}
+
+
+Std_CAN_Status CAN_ConfigPretendedNetwork(CAN_Handle_type* can_handle, const CAN_PN_Config_type* pn_config)
+{
+    CAN_Type* CAN_instance = can_handle->can_instance;
+
+    if(!CAN_PnValid(CAN_instance, pn_config))
+    {
+        return CAN_E_NOT_OK;
     }
 
-    while ((CAN0->MCR && CAN_MCR_NOTRDY_MASK) >> CAN_MCR_NOTRDY_SHIFT)
+    CAN_EnterFreezeMode(can_handle);
+    CAN_PnWriteFilter(CAN_instance, pn_config);
+    CAN_ExitFreezeMode(can_handle);
+
+    return CAN_E_OK;
+}
+
+Std_CAN_Status CAN_EnterPretendedNetwork(CAN_Handle_type* can_handle)
+{
+    CAN_Type* CAN_instance = can_handle->can_instance;
+
+    /* Stop mode waits for the frame on the bus only, queued and loaded frames would be held until wake-up */
+    if((0U == (CAN_instance->MCR & CAN_MCR_PNET_EN_MASK)) || (0U != can_handle->tx_queue.count)
+    || (can_handle->tx_free_map != can_handle->tx_mb_mask))
     {
-    	/* DO NOTHING */
+        return CAN_E_NOT_OK;
     }
 
-    return status;
+    CAN_CLEAR_WU_MTC(CAN_instance, CAN_WU_MTC_WUMF_MASK | CAN_WU_MTC_WTOF_MASK);
+    can_handle->pn_wake_status = 0;
+
+    return CAN_E_OK;
 }
 
-void CAN_transmit_msg(CAN_Type* CAN_instance,uint32_t id, uint8_t* data_buff)
+void CAN_PnWakeUpIRQHandler(CAN_Handle_type* can_handle)
 {
-    uint8_t idx = 0;
-    while((idx < num_msg_buff) && (0x88000000 != CAN_instance->RAMn[idx*msg_buff_size]))
+    CAN_Type* CAN_instance = can_handle->can_instance;
+    CAN_RxRing_type* ring = &can_handle->rx_ring;
+    uint32_t wu_mtc = CAN_instance->WU_MTC;
+    uint8_t num_wmb = (uint8_t)((wu_mtc & CAN_WU_MTC_MCOUNTER_MASK) >> CAN_WU_MTC_MCOUNTER_SHIFT);
+
+    CAN_CLEAR_WU_MTC(CAN_instance, wu_mtc & (CAN_WU_MTC_WUMF_MASK | CAN_WU_MTC_WTOF_MASK));
+    can_handle->pn_wake_status = wu_mtc;
+    if(num_wmb > CAN_WMB_COUNT)
     {
-    	idx++;
+        num_wmb = CAN_WMB_COUNT;
     }
-    CAN_instance->IFLAG1 = (uint32_t)(1 << idx);
-    CAN_instance->RAMn[idx*msg_buff_size + 1] = (id << 18);
 
-    uint8_t num_words = msg_buff_size - 2;
-    for (uint8_t w_idx = 0; w_idx < num_words; w_idx++)
+    for(uint8_t idx = 0; idx < num_wmb; idx++)
     {
-        uint32_t data_word = 0;
-        for (uint8_t idx = 0; idx < 4; idx++)
+        uint16_t head = ring->head;
+        if((uint16_t)(head - ring->tail) < CAN_RX_RING_SIZE)
+        {
+            CAN_Frame_type* frame = &ring->frames[head & (CAN_RX_RING_SIZE - 1U)];
+            uint32_t cs = CAN_instance->WMB[idx].WMBn_CS;
+            if(cs & CAN_WMBn_CS_IDE_MASK)
+            {
+                frame->id = CAN_instance->WMB[idx].WMBn_ID & CAN_MB_ID_EXT_MASK;
+            }
+            else
+            {
+                frame->id = (CAN_instance->WMB[idx].WMBn_ID & CAN_MB_ID_STD_MASK) >> CAN_WMBn_CS_STD_ID_SHIFT;
+            }
+            frame->dlc = (uint8_t)((cs & CAN_WMBn_CS_DLC_MASK) >> CAN_WMBn_CS_DLC_SHIFT);
+            frame->timestamp = 0;
+            frame->flags = CAN_FrameFlags(cs);
+            CAN_ReadPayload(&CAN_instance->WMB[idx].WMBn_D03, frame->data, 2U);
+            CAN_STATS_RX(can_handle, 0U, frame->id, cs);
+            CAN_COMPILER_BARRIER();
+            ring->head = (uint16_t)(head + 1U);
+            can_handle->stats.rx_frames++;
+        }
+        else
         {
-            uint8_t data_idx = (w_idx * 4) + idx;
-            data_word |= (uint32_t)(data_buff[data_idx]) << (8 * (3 - idx));
+            can_handle->stats.rx_overflow++;
         }
-        CAN_instance->RAMn[idx * msg_buff_size + 2 + w_idx] = data_word;
     }
+}
+void CAN0_ORed_0_15_MB_IRQHandler(void)
+{
+    if(NULL != CAN_handle_arr[0])
+    {
+        CAN_IRQHandler(CAN_handle_arr[0]);
+    }
+}
 
-    CAN_instance->RAMn[idx*msg_buff_size] |= 0 << CAN_WMBn_CS_DLC_SHIFT;
-    CAN_instance->RAMn[idx*msg_buff_size] |= 13 << CAN_WMBn_CS_DLC_SHIFT;
-    CAN_instance->RAMn[idx*msg_buff_size] |= 1 << CAN_WMBn_CS_SRR_SHIFT;
-    CAN_instance->RAMn[idx*msg_buff_size] |= 0xC << 24;
-    CAN_instance->IFLAG1 = (1 << idx);
-    while((CAN_instance->IFLAG1 & (1 << idx)))
+void CAN0_ORed_16_31_MB_IRQHandler(void)
+{
+    if(NULL != CAN_handle_arr[0])
     {
-    	/* DO NOTHING */
+        CAN_IRQHandler(CAN_handle_arr[0]);
     }
 }
 
-void CAN_receive_msg(CAN_Type* CAN_instance, uint8_t *rx_buff, uint16_t length_buff)
+void CAN1_ORed_0_15_MB_IRQHandler(void)
 {
-    uint8_t idx_mb = 0;
-	while(!(CAN_instance->IFLAG1 & (1 << idx_mb)))
+    if(NULL != CAN_handle_arr[1])
     {
-        idx_mb++;
+        CAN_IRQHandler(CAN_handle_arr[1]);
     }
+}
 
-    uint8_t num_words = msg_buff_size - 2;
-    uint8_t rx_idx = 0;
-    for(uint8_t w_idx = 0; w_idx < num_words; w_idx++)
+void CAN2_ORed_0_15_MB_IRQHandler(void)
+{
+    if(NULL != CAN_handle_arr[2])
     {
-        for(uint8_t idx = 0; idx < 4; idx++)
-        {
-//            uint8_t b_idx = (w_idx * 4) + idx;
-            if(rx_idx < length_buff)
-            {
-                rx_buff[rx_idx] = (uint8_t)(CAN_instance->RAMn[idx_mb * msg_buff_size + 2 + w_idx] >> (8 * (3 - idx)));
-                rx_idx++;
-            }
-        }
+        CAN_IRQHandler(CAN_handle_arr[2]);
+    }
+}
+
+void CAN0_ORed_IRQHandler(void)
+{
+    if(NULL != CAN_handle_arr[0])
+    {
+        CAN_ErrorIRQHandler(CAN_handle_arr[0]);
+    }
+}
+
+void CAN0_Error_IRQHandler(void)
+{
+    if(NULL != CAN_handle_arr[0])
+    {
+        CAN_ErrorIRQHandler(CAN_handle_arr[0]);
+    }
+}
+
+void CAN1_ORed_IRQHandler(void)
+{
+    if(NULL != CAN_handle_arr[1])
+    {
+        CAN_ErrorIRQHandler(CAN_handle_arr[1]);
+    }
+}
+
+void CAN1_Error_IRQHandler(void)
+{
+    if(NULL != CAN_handle_arr[1])
+    {
+        CAN_ErrorIRQHandler(CAN_handle_arr[1]);
+    }
+}
+
+void CAN2_ORed_IRQHandler(void)
+{
+    if(NULL != CAN_handle_arr[2])
+    {
+        CAN_ErrorIRQHandler(CAN_handle_arr[2]);
+    }
+}
+
+void CAN2_Error_IRQHandler(void)
+{
+    if(NULL != CAN_handle_arr[2])
+    {
+        CAN_ErrorIRQHandler(CAN_handle_arr[2]);
     }
+}
 
-    CAN_instance->IFLAG1 = (1 << idx_mb);
+void CAN0_Wake_Up_IRQHandler(void)
+{
+    if(NULL != CAN_handle_arr[0])
+    {
+        CAN_PnWakeUpIRQHandler(CAN_handle_arr[0]);
+    }
 }
@@ -0,0 +1,475 @@
+/**
+ * @file s32k144_can_filter.c
+ * @brief Acceptance filter compiler for the FlexCAN Rx message buffers and Rx FIFO ID table.
+ *
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*******************************************************************************
+ * Inclusion
+ ******************************************************************************/
+
+#include "../src/Driver/CAN/Include/s32k144_can_filter.h"
+
+/*******************************************************************************
+ * Macro
+ ******************************************************************************/
+
+#define CAN_FILTER_STD_ID_MASK  (0x000007FFU)
+#define CAN_FILTER_EXT_ID_MASK  (0x1FFFFFFFU)
+#define CAN_FILTER_WORK_BLOCKS  (256U) /* Blocks held while splitting ranges */
+
+/* Aligned block of 2^k IDs starting at base */
+#define CAN_FILTER_BLOCK_SIZE(k) ((uint32_t)1U << (k))
+
+/*******************************************************************************
+* Variables
+******************************************************************************/
+
+typedef struct
+{
+    uint32_t base;
+    uint32_t false_ids; /* IDs of the block not covered by any range */
+    uint8_t k;
+} CAN_FilterBlock_type;
+
+/* Working storage of CAN_Filter_Compile, which is not reentrant */
+static CAN_FilterEntry_type CAN_filter_ranges[CAN_FILTER_MAX_ENTRIES];
+static uint8_t CAN_filter_num_ranges;
+static CAN_FilterBlock_type CAN_filter_blocks[CAN_FILTER_WORK_BLOCKS];
+static uint16_t CAN_filter_num_blocks;
+
+/*******************************************************************************
+* Code
+******************************************************************************/
+
+/* Number of requested IDs inside [base, base + size - 1] */
+static uint32_t CAN_Filter_WantedIds(uint32_t base, uint32_t size)
+{
+    uint32_t wanted = 0;
+    uint32_t end = base + (size - 1U);
+
+    for(uint8_t idx = 0; idx < CAN_filter_num_ranges; idx++)
+    {
+        uint32_t low = (CAN_filter_ranges[idx].id_low > base) ? CAN_filter_ranges[idx].id_low : base;
+        uint32_t high = (CAN_filter_ranges[idx].id_high < end) ? CAN_filter_ranges[idx].id_high : end;
+        if(low <= high)
+        {
+            wanted += (high - low) + 1U;
+        }
+    }
+
+    return wanted;
+}
+
+/* Sorts the requested ranges and joins overlapping or adjacent ones */
+static Std_CAN_Status CAN_Filter_NormaliseRanges(const CAN_FilterEntry_type* entries, uint8_t num_entries, uint32_t id_mask)
+{
+    Std_CAN_Status status = CAN_E_OK;
+    CAN_filter_num_ranges = 0;
+
+    for(uint8_t idx = 0; (CAN_E_OK == status) && (idx < num_entries); idx++)
+    {
+        CAN_FilterEntry_type entry = entries[idx];
+        if((entry.id_low > entry.id_high) || (entry.id_high > id_mask))
+        {
+            status = CAN_E_NOT_OK;
+        }
+        else
+        {
+            /* Insertion sort on id_low */
+            uint8_t pos = CAN_filter_num_ranges;
+            while((pos > 0U) && (CAN_filter_ranges[pos - 1U].id_low > entry.id_low))
+            {
+                CAN_filter_ranges[pos] = CAN_filter_ranges[pos - 1U];
+                pos--;
+            }
+            CAN_filter_ranges[pos] = entry;
+            CAN_filter_num_ranges++;
+        }
+    }
+
+    if(CAN_E_OK == status)
+    {
+        uint8_t out = 0;
+        for(uint8_t idx = 1; idx < CAN_filter_num_ranges; idx++)
+        {
+            if(CAN_filter_ranges[idx].id_low <= (CAN_filter_ranges[out].id_high + 1U))
+            {
+                if(CAN_filter_ranges[idx].id_high > CAN_filter_ranges[out].id_high)
+                {
+                    CAN_filter_ranges[out].id_high = CAN_filter_ranges[idx].id_high;
+                }
+            }
+            else
+            {
+                out++;
+                CAN_filter_ranges[out] = CAN_filter_ranges[idx];
+            }
+        }
+        CAN_filter_num_ranges = (uint8_t)(out + 1U);
+    }
+
+    return status;
+}
+
+/* Merges the two neighbouring blocks whose common aligned block adds the fewest unwanted IDs */
+static void CAN_Filter_MergeCheapest(void)
+{
+    uint16_t best_first = 0;
+    uint16_t best_last = 0;
+    uint32_t best_cost = 0xFFFFFFFFU;
+    CAN_FilterBlock_type best_block = {0, 0, 0};
+
+    for(uint16_t idx = 0; (idx + 1U) < CAN_filter_num_blocks; idx++)
+    {
+        CAN_FilterBlock_type* left = &CAN_filter_blocks[idx];
+        CAN_FilterBlock_type* right = &CAN_filter_blocks[idx + 1U];
+        uint32_t right_end = right->base + (CAN_FILTER_BLOCK_SIZE(right->k) - 1U);
+        uint8_t k = (left->k > right->k) ? left->k : right->k;
+        while((left->base >> k) != (right_end >> k))
+        {
+            k++;
+        }
+
+        CAN_FilterBlock_type merged;
+        merged.k = k;
+        merged.base = left->base & ~(CAN_FILTER_BLOCK_SIZE(k) - 1U);
+        merged.false_ids = CAN_FILTER_BLOCK_SIZE(k) - CAN_Filter_WantedIds(merged.base, CAN_FILTER_BLOCK_SIZE(k));
+
+        /* Aligned blocks are nested or disjoint, so every block starting inside merged is absorbed */
+        uint32_t merged_end = merged.base + (CAN_FILTER_BLOCK_SIZE(k) - 1U);
+        uint16_t first = idx;
+        uint16_t last = idx + 1U;
+        while((first > 0U) && (CAN_filter_blocks[first - 1U].base >= merged.base))
+        {
+            first--;
+        }
+        while(((last + 1U) < CAN_filter_num_blocks) && (CAN_filter_blocks[last + 1U].base <= merged_end))
+        {
+            last++;
+        }
+
+        uint32_t absorbed_false_ids = 0;
+        for(uint16_t b_idx = first; b_idx <= last; b_idx++)
+        {
+            absorbed_false_ids += CAN_filter_blocks[b_idx].false_ids;
+        }
+
+        uint32_t cost = merged.false_ids - absorbed_false_ids;
+        if((cost < best_cost) || ((cost == best_cost) && (k < best_block.k)))
+        {
+            best_cost = cost;
+            best_first = first;
+            best_last = last;
+            best_block = merged;
+        }
+    }
+
+    if(0xFFFFFFFFU != best_cost)
+    {
+        uint16_t removed = (uint16_t)(best_last - best_first);
+        CAN_filter_blocks[best_first] = best_block;
+        for(uint16_t idx = (uint16_t)(best_first + 1U); (idx + removed) < CAN_filter_num_blocks; idx++)
+        {
+            CAN_filter_blocks[idx] = CAN_filter_blocks[idx + removed];
+        }
+        CAN_filter_num_blocks = (uint16_t)(CAN_filter_num_blocks - removed);
+    }
+}
+
+/* Splits every range into the fewest aligned blocks, merging early if the work buffer fills up */
+static void CAN_Filter_SplitRanges(void)
+{
+    CAN_filter_num_blocks = 0;
+
+    for(uint8_t idx = 0; idx < CAN_filter_num_ranges; idx++)
+    {
+        uint32_t low = CAN_filter_ranges[idx].id_low;
+        uint32_t high = CAN_filter_ranges[idx].id_high;
+        uint8_t done = 0;
+        while(!done)
+        {
+            uint8_t k = 0;
+            while((k < 29U)
+               && (0U == (low & (CAN_FILTER_BLOCK_SIZE(k + 1U) - 1U)))
+               && ((low + (CAN_FILTER_BLOCK_SIZE(k + 1U) - 1U)) <= high))
+            {
+                k++;
+            }
+
+            if(CAN_filter_num_blocks >= CAN_FILTER_WORK_BLOCKS)
+            {
+                CAN_Filter_MergeCheapest();
+            }
+            CAN_filter_blocks[CAN_filter_num_blocks].base = low;
+            CAN_filter_blocks[CAN_filter_num_blocks].k = k;
+            CAN_filter_blocks[CAN_filter_num_blocks].false_ids = 0;
+            CAN_filter_num_blocks++;
+
+            uint32_t block_end = low + (CAN_FILTER_BLOCK_SIZE(k) - 1U);
+            if(block_end >= high)
+            {
+                done = 1;
+            }
+            else
+            {
+                low = block_end + 1U;
+            }
+        }
+    }
+}
+
+/* Unwanted IDs accepted by the union of the table blocks */
+static uint32_t CAN_Filter_CountFalseIds(const CAN_FilterTable_type* table, uint32_t id_mask)
+{
+    uint32_t false_ids = 0;
+
+    /* Reuse the work buffer: sort blocks by base, larger blocks first, and skip nested ones */
+    CAN_filter_num_blocks = 0;
+    for(uint8_t idx = 0; idx < table->num_slots; idx++)
+    {
+        uint32_t mask = (idx < table->num_individual) ? table->slots[idx].mask : table->global_mask;
+        CAN_FilterBlock_type block;
+        block.base = table->slots[idx].id;
+        block.k = 0;
+        while((block.k < 29U) && (0U == (mask & CAN_FILTER_BLOCK_SIZE(block.k))) && (0U != (id_mask & CAN_FILTER_BLOCK_SIZE(block.k))))
+        {
+            block.k++;
+        }
+        block.false_ids = 0;
+
+        uint16_t pos = CAN_filter_num_blocks;
+        while((pos > 0U)
+           && ((CAN_filter_blocks[pos - 1U].base > block.base)
+            || ((CAN_filter_blocks[pos - 1U].base == block.base) && (CAN_filter_blocks[pos - 1U].k < block.k))))
+        {
+            CAN_filter_blocks[pos] = CAN_filter_blocks[pos - 1U];
+            pos--;
+        }
+        CAN_filter_blocks[pos] = block;
+        CAN_filter_num_blocks++;
+    }
+
+    uint32_t covered_end = 0;
+    uint8_t has_covered = 0;
+    for(uint16_t idx = 0; idx < CAN_filter_num_blocks; idx++)
+    {
+        uint32_t size = CAN_FILTER_BLOCK_SIZE(CAN_filter_blocks[idx].k);
+        if((!has_covered) || (CAN_filter_blocks[idx].base > covered_end))
+        {
+            false_ids += size - CAN_Filter_WantedIds(CAN_filter_blocks[idx].base, size);
+            covered_end = CAN_filter_blocks[idx].base + (size - 1U);
+            has_covered = 1;
+        }
+    }
+
+    return false_ids;
+}
+
+void CAN_Filter_GetCapacity(const CAN_Handle_type* can_handle, uint8_t* num_individual, uint8_t* num_shared)
+{
+    if(ENABLE_RX_FIFO == can_handle->rx_fifo)
+    {
+        uint8_t num_filter = (uint8_t)(CAN_RX_FIFO_FILTER_PER_RFFN * (can_handle->rx_fifo_filter_num + 1U));
+        uint8_t individual = (uint8_t)(8U + (2U * can_handle->rx_fifo_filter_num));
+        if(individual > num_filter)
+        {
+            individual = num_filter;
+        }
+        *num_individual = individual;
+        *num_shared = (uint8_t)(num_filter - individual);
+    }
+    else
+    {
+        uint8_t count = 0;
+        for(uint32_t map = can_handle->rx_mb_mask; 0U != map; map &= (map - 1U))
+        {
+            count++;
+        }
+        *num_individual = count;
+        *num_shared = 0;
+    }
+}
+
+Std_CAN_Status CAN_Filter_Compile(const CAN_FilterEntry_type* entries, uint8_t num_entries, uint8_t id_type,
+                                  uint8_t num_individual, uint8_t num_shared, CAN_FilterTable_type* table)
+{
+    Std_CAN_Status status = CAN_E_OK;
+    uint32_t id_mask = (STARDADARD_ID == id_type) ? CAN_FILTER_STD_ID_MASK : CAN_FILTER_EXT_ID_MASK;
+    uint16_t budget = (uint16_t)num_individual + num_shared;
+
+    if((NULL == entries) || (NULL == table) || (0U == num_entries) || (num_entries > CAN_FILTER_MAX_ENTRIES)
+    || (0U == budget) || (budget > CAN_FILTER_MAX_SLOTS))
+    {
+        status = CAN_E_NOT_OK;
+    }
+    else
+    {
+        status = CAN_Filter_NormaliseRanges(entries, num_entries, id_mask);
+    }
+
+    if(CAN_E_OK == status)
+    {
+        CAN_Filter_SplitRanges();
+        while(CAN_filter_num_blocks > budget)
+        {
+            CAN_Filter_MergeCheapest();
+        }
+
+        /* Largest blocks get the individual masks so the shared mask stays as narrow as possible */
+        for(uint16_t idx = 1; idx < CAN_filter_num_blocks; idx++)
+        {
+            CAN_FilterBlock_type block = CAN_filter_blocks[idx];
+            uint16_t pos = idx;
+            while((pos > 0U) && (CAN_filter_blocks[pos - 1U].k < block.k))
+            {
+                CAN_filter_blocks[pos] = CAN_filter_blocks[pos - 1U];
+                pos--;
+            }
+            CAN_filter_blocks[pos] = block;
+        }
+
+        uint8_t shared_k = 0;
+        for(uint16_t idx = num_individual; idx < CAN_filter_num_blocks; idx++)
+        {
+            if(CAN_filter_blocks[idx].k > shared_k)
+            {
+                shared_k = CAN_filter_blocks[idx].k;
+            }
+        }
+
+        table->id_type = id_type;
+        table->global_mask = id_mask & ~(CAN_FILTER_BLOCK_SIZE(shared_k) - 1U);
+        table->num_individual = (CAN_filter_num_blocks < num_individual) ? (uint8_t)CAN_filter_num_blocks : num_individual;
+        table->num_slots = 0;
+        for(uint16_t idx = 0; idx < CAN_filter_num_blocks; idx++)
+        {
+            uint32_t base = CAN_filter_blocks[idx].base;
+            uint8_t duplicate = 0;
+            if(idx < num_individual)
+            {
+                table->slots[table->num_slots].mask = id_mask & ~(CAN_FILTER_BLOCK_SIZE(CAN_filter_blocks[idx].k) - 1U);
+            }
+            else
+            {
+                /* Widened to the shared mask, several blocks may collapse into one */
+                base &= table->global_mask;
+                table->slots[table->num_slots].mask = table->global_mask;
+                for(uint8_t s_idx = table->num_individual; s_idx < table->num_slots; s_idx++)
+                {
+                    if(base == table->slots[s_idx].id)
+                    {
+                        duplicate = 1;
+                    }
+                }
+            }
+
+            if(!duplicate)
+            {
+                table->slots[table->num_slots].id = base;
+                table->num_slots++;
+            }
+        }
+
+        table->false_positive_ids = CAN_Filter_CountFalseIds(table, id_mask);
+    }
+
+    return status;
+}
+
+Std_CAN_Status CAN_Filter_Apply(CAN_Handle_type* can_handle, const CAN_FilterTable_type* table)
+{
+    Std_CAN_Status status = CAN_E_OK;
+    CAN_Type* CANx = can_handle->can_instance;
+    uint8_t num_individual = 0;
+    uint8_t num_shared = 0;
+
+    CAN_Filter_GetCapacity(can_handle, &num_individual, &num_shared);
+    if((NULL == table) || (0U == table->num_slots) || (table->num_individual > num_individual)
+    || ((table->num_slots - table->num_individual) > num_shared))
+    {
+        status = CAN_E_NOT_OK;
+    }
+    else
+    {
+        uint8_t is_std = (STARDADARD_ID == table->id_type);
+
+        CAN_EnterFreezeMode(can_handle);
+        CANx->MCR |= CAN_MCR_IRMQ_MASK;
+
+        if(ENABLE_RX_FIFO == can_handle->rx_fifo)
+        {
+            /* Format A elements and masks, IDE is always compared */
+            uint8_t num_filter = (uint8_t)(num_individual + num_shared);
+            uint8_t last_shared = (table->num_slots > table->num_individual) ? (uint8_t)(table->num_slots - 1U) : 0U;
+            uint32_t ide = is_std ? 0U : CAN_RX_FIFO_ID_IDE_MASK;
+            uint8_t shift = is_std ? CAN_RX_FIFO_ID_STD_SHIFT : CAN_RX_FIFO_ID_EXT_SHIFT;
+            uint32_t field = is_std ? CAN_RX_FIFO_ID_STD_MASK : CAN_RX_FIFO_ID_EXT_MASK;
+
+            for(uint8_t idx = 0; idx < num_filter; idx++)
+            {
+                uint8_t slot;
+                uint32_t mask;
+                if(idx < num_individual)
+                {
+                    /* Unused individual elements repeat slot 0 with its own mask */
+                    slot = (idx < table->num_individual) ? idx : 0U;
+                    mask = table->slots[slot].mask;
+                    CANx->RXIMR[idx] = CAN_RX_FIFO_ID_IDE_MASK | ((mask << shift) & field);
+                }
+                else
+                {
+                    /* Unused shared elements repeat a slot already accepted under the shared mask */
+                    uint8_t shared_idx = (uint8_t)(table->num_individual + (idx - num_individual));
+                    slot = (shared_idx < table->num_slots) ? shared_idx : last_shared;
+                }
+                CANx->RAMn[(CAN_RX_FIFO_MB_COUNT * 4U) + idx] = ide | ((table->slots[slot].id << shift) & field);
+            }
+
+            if(table->num_slots > table->num_individual)
+            {
+                CANx->RXFGMASK = CAN_RX_FIFO_ID_IDE_MASK | ((table->global_mask << shift) & field);
+            }
+            else
+            {
+                CANx->RXFGMASK = CAN_RX_FIFO_ID_IDE_MASK | ((table->slots[0].mask << shift) & field);
+            }
+        }
+        else
+        {
+            uint8_t slot = 0;
+            uint8_t shift = is_std ? CAN_WMBn_CS_STD_ID_SHIFT : 0U;
+            for(uint32_t map = can_handle->rx_mb_mask; 0U != map; map &= (map - 1U))
+            {
+                uint8_t idx_mb = 0;
+                while(0U == (map & (1UL << idx_mb)))
+                {
+                    idx_mb++;
+                }
+
+                uint32_t base = can_handle->mb_map.mb_base[idx_mb];
+                if(slot < table->num_slots)
+                {
+                    CANx->RXIMR[idx_mb] = (table->slots[slot].mask << shift) & CAN_MB_ID_EXT_MASK;
+                    CANx->RAMn[base + 1] = (table->slots[slot].id << shift) & CAN_MB_ID_EXT_MASK;
+                    CANx->RAMn[base] = ((uint32_t)CAN_MB_CODE_RX_EMPTY << CAN_MB_CS_CODE_SHIFT) | (is_std ? 0U : CAN_MB_CS_IDE_MASK);
+                    slot++;
+                }
+                else
+                {
+                    /* Inactive Rx MB, never filled */
+                    CANx->RAMn[base] = 0;
+                }
+            }
+        }
+
+        CAN_ExitFreezeMode(can_handle);
+    }
+
+    return status;
+}
@@ -0,0 +1,171 @@
+/**
+ * @file s32k144_can_gateway.c
+ * @brief Frame routing between CAN0, CAN1 and CAN2 inside the receive interrupt.
+ *
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*******************************************************************************
+ * Inclusion
+ ******************************************************************************/
+
+#include "../src/Driver/CAN/Include/s32k144_can_gateway.h"
+#include <string.h>
+
+/*******************************************************************************
+ * Macro
+ ******************************************************************************/
+
+/* Tx done hook tag of a forwarded frame: route index + 1 above the Rx time */
+#define CAN_GATEWAY_TAG_ROUTE_SHIFT (24U)
+
+/*******************************************************************************
+* Code
+******************************************************************************/
+
+/* Rx hook: forwards a frame matching a route to its destination controllers */
+static Std_CAN_Status CAN_Gateway_RxHook(CAN_Handle_type* can_handle, const CAN_MsgView_type* view)
+{
+    CAN_Gateway_type* gateway = (CAN_Gateway_type*)can_handle->hook_context;
+    Std_CAN_Status status = CAN_E_NOT_OK;
+    uint8_t src_bus = 0;
+    uint8_t ide = (view->cs & CAN_MB_CS_IDE_MASK) ? CAN_FRAME_FLAG_IDE : 0U;
+
+    while(gateway->buses[src_bus] != can_handle)
+    {
+        src_bus++;
+    }
+
+    for(uint8_t idx = 0; idx < gateway->num_routes; idx++)
+    {
+        const CAN_GatewayRoute_type* route = &gateway->routes[idx];
+        if((route->src_bus == src_bus) && ((view->id & route->mask) == route->match)
+        && (0U == ((ide ^ route->flags) & CAN_FRAME_FLAG_IDE)))
+        {
+            CAN_GatewayRouteStats_type* stats = &gateway->stats[idx];
+            uint32_t now = (NULL != gateway->clock) ? gateway->clock() : 0U;
+            uint32_t tag = ((uint32_t)(idx + 1U) << CAN_GATEWAY_TAG_ROUTE_SHIFT) | (now & CAN_GATEWAY_CLOCK_MASK);
+            uint32_t id = (view->id & ~route->rewrite_mask) | (route->new_id & route->rewrite_mask);
+
+            stats->matched++;
+            for(uint8_t dst_bus = 0; dst_bus < CAN_INSTANCE_COUNT; dst_bus++)
+            {
+                if(route->dst_buses & (1U << dst_bus))
+                {
+                    if(CAN_E_OK == CAN_ForwardMsgBuff(gateway->buses[dst_bus], view, id, tag))
+                    {
+                        stats->forwarded++;
+                    }
+                    else
+                    {
+                        stats->dropped++;
+                    }
+                }
+            }
+            status = route->keep_local ? CAN_E_NOT_OK : CAN_E_OK;
+            break;
+        }
+    }
+
+    return status;
+}
+
+/* Tx done hook: a forwarded frame left its destination controller */
+static void CAN_Gateway_TxDoneHook(CAN_Handle_type* can_handle, uint32_t tag)
+{
+    CAN_Gateway_type* gateway = (CAN_Gateway_type*)can_handle->hook_context;
+    CAN_GatewayRouteStats_type* stats = &gateway->stats[(tag >> CAN_GATEWAY_TAG_ROUTE_SHIFT) - 1U];
+
+    stats->completed++;
+    if(NULL != gateway->clock)
+    {
+        uint32_t latency = (gateway->clock() - tag) & CAN_GATEWAY_CLOCK_MASK;
+        stats->latency_sum += latency;
+        if(latency < stats->latency_min)
+        {
+            stats->latency_min = latency;
+        }
+        if(latency > stats->latency_max)
+        {
+            stats->latency_max = latency;
+        }
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+}
+
+Std_CAN_Status CAN_Gateway_Init(CAN_Gateway_type* gateway, const CAN_Gateway_Config_type* config)
+{
+    if((config->num_routes > CAN_GATEWAY_MAX_ROUTES) || ((NULL == config->routes) && (0U != config->num_routes)))
+    {
+        return CAN_E_NOT_OK;
+    }
+    for(uint8_t idx = 0; idx < config->num_routes; idx++)
+    {
+        const CAN_GatewayRoute_type* route = &config->routes[idx];
+        if((route->src_bus >= CAN_INSTANCE_COUNT) || (NULL == config->buses[route->src_bus])
+        || (route->dst_buses & (1U << route->src_bus)) || (route->dst_buses >= (1U << CAN_INSTANCE_COUNT)))
+        {
+            return CAN_E_NOT_OK;
+        }
+        for(uint8_t dst_bus = 0; dst_bus < CAN_INSTANCE_COUNT; dst_bus++)
+        {
+            if((route->dst_buses & (1U << dst_bus)) && (NULL == config->buses[dst_bus]))
+            {
+                return CAN_E_NOT_OK;
+            }
+        }
+    }
+
+    memcpy(gateway->buses, config->buses, sizeof(gateway->buses));
+    gateway->routes = config->routes;
+    gateway->num_routes = config->num_routes;
+    gateway->clock = config->clock;
+    CAN_Gateway_ResetStats(gateway);
+
+    for(uint8_t bus = 0; bus < CAN_INSTANCE_COUNT; bus++)
+    {
+        if(NULL != gateway->buses[bus])
+        {
+            CAN_SetHooks(gateway->buses[bus], CAN_Gateway_RxHook, CAN_Gateway_TxDoneHook, gateway);
+        }
+    }
+
+    return CAN_E_OK;
+}
+
+void CAN_Gateway_DeInit(CAN_Gateway_type* gateway)
+{
+    for(uint8_t bus = 0; bus < CAN_INSTANCE_COUNT; bus++)
+    {
+        if(NULL != gateway->buses[bus])
+        {
+            CAN_SetHooks(gateway->buses[bus], NULL, NULL, NULL);
+        }
+    }
+}
+
+void CAN_Gateway_GetRouteStats(CAN_Gateway_type* gateway, uint8_t route, CAN_GatewayRouteStats_type* stats)
+{
+    /* Route statistics change in the Rx hooks and Tx done hooks of every gateway controller */
+    uint32_t primask = CAN_CRITICAL_ENTER();
+    *stats = gateway->stats[route];
+    CAN_CRITICAL_EXIT(primask);
+}
+
+void CAN_Gateway_ResetStats(CAN_Gateway_type* gateway)
+{
+    uint32_t primask = CAN_CRITICAL_ENTER();
+    memset(gateway->stats, 0, sizeof(gateway->stats));
+    for(uint8_t idx = 0; idx < CAN_GATEWAY_MAX_ROUTES; idx++)
+    {
+        gateway->stats[idx].latency_min = 0xFFFFFFFFU;
+    }
+    CAN_CRITICAL_EXIT(primask);
+}
@@ -0,0 +1,559 @@
+/**
+ * @file s32k144_can_isotp.c
+ * @brief ISO 15765-2 (ISO-TP) segmentation, reassembly and flow control on top of the CAN driver.
+ *
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*******************************************************************************
+ * Inclusion
+ ******************************************************************************/
+
+#include "../src/Driver/CAN/Include/s32k144_can_isotp.h"
+#include <string.h>
+
+/*******************************************************************************
+ * Macro
+ ******************************************************************************/
+
+/* Protocol control information, high nibble of byte 0 */
+#define CAN_ISOTP_PCI_SF        (0x0U)
+#define CAN_ISOTP_PCI_FF        (0x1U)
+#define CAN_ISOTP_PCI_CF        (0x2U)
+#define CAN_ISOTP_PCI_FC        (0x3U)
+
+/* Flow status of a flow control frame */
+#define CAN_ISOTP_FS_CTS        (0x0U)
+#define CAN_ISOTP_FS_WAIT       (0x1U)
+#define CAN_ISOTP_FS_OVFLW      (0x2U)
+#define CAN_ISOTP_FS_NONE       (0xFFU)
+
+#define CAN_ISOTP_FF_DL_12BIT   (0xFFFU)  /* Longest message announced by a 12 bit FF_DL */
+#define CAN_ISOTP_STMIN_MAX_US  (127000U) /* Reserved STmin values count as the longest one */
+
+/* Time t reached at now, both wrapping at 2^32 */
+#define CAN_ISOTP_REACHED(now, t) ((int32_t)((uint32_t)(now) - (uint32_t)(t)) >= 0)
+
+typedef enum
+{
+    CAN_ISOTP_TX_IDLE,
+    CAN_ISOTP_TX_FIRST,   /* SF or FF waits for room in the Tx queue */
+    CAN_ISOTP_TX_WAIT_FC,
+    CAN_ISOTP_TX_SEND_CF
+} CAN_ISOTP_TX_STATE_type;
+
+typedef enum
+{
+    CAN_ISOTP_RX_IDLE,
+    CAN_ISOTP_RX_RECEIVING
+} CAN_ISOTP_RX_STATE_type;
+
+/*******************************************************************************
+* Code
+******************************************************************************/
+
+/* Queues one frame, padded to 8 bytes or to the next CAN FD DLC size */
+static Std_CAN_Status CAN_IsoTp_SendFrame(CAN_IsoTp_type* isotp, uint32_t id, const uint8_t* data, uint8_t length)
+{
+    uint8_t frame[CAN_MAX_PAYLOAD_BYTES];
+    uint8_t padded = 8U;
+
+    if(length > 8U)
+    {
+        padded = CAN_DlcToLength(isotp->can_handle, CAN_LengthToDlc(length));
+    }
+    memcpy(frame, data, length);
+    memset(&frame[length], CAN_ISOTP_PADDING_BYTE, (size_t)(padded - length));
+
+    return CAN_Transmit(isotp->can_handle, id, frame, padded);
+}
+
+/* Microseconds of an STmin value */
+static uint32_t CAN_IsoTp_StMinUs(uint8_t st_min)
+{
+    uint32_t st_min_us = CAN_ISOTP_STMIN_MAX_US;
+
+    if(st_min <= 0x7FU)
+    {
+        st_min_us = (uint32_t)st_min * 1000U;
+    }
+    else if((st_min >= 0xF1U) && (st_min <= 0xF9U))
+    {
+        st_min_us = (uint32_t)(st_min - 0xF0U) * 100U;
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+
+    return st_min_us;
+}
+
+static void CAN_IsoTp_TxFinish(CAN_IsoTp_type* isotp, uint8_t channel, uint8_t result)
+{
+    CAN_IsoTp_Channel_type* ch = &isotp->channels[channel];
+
+    ch->tx_state = CAN_ISOTP_TX_IDLE;
+    ch->tx_result = result;
+    if(NULL != isotp->callback)
+    {
+        isotp->callback(isotp, channel, ISOTP_TX_DONE, result);
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+}
+
+static void CAN_IsoTp_RxFinish(CAN_IsoTp_type* isotp, uint8_t channel, uint8_t result)
+{
+    CAN_IsoTp_Channel_type* ch = &isotp->channels[channel];
+
+    ch->rx_state = CAN_ISOTP_RX_IDLE;
+    ch->rx_result = result;
+    if(NULL != isotp->callback)
+    {
+        isotp->callback(isotp, channel, ISOTP_RX_DONE, result);
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+}
+
+/* Sends a flow control frame with the channel's BS and STmin, or keeps it pending while the Tx queue is full */
+static void CAN_IsoTp_SendFlowControl(CAN_IsoTp_type* isotp, CAN_IsoTp_Channel_type* ch, uint8_t flow_status)
+{
+    uint8_t fc[3];
+
+    fc[0] = (uint8_t)((CAN_ISOTP_PCI_FC << 4) | flow_status);
+    fc[1] = ch->config->block_size;
+    fc[2] = ch->config->st_min;
+    ch->rx_fc_pending = (CAN_E_OK == CAN_IsoTp_SendFrame(isotp, ch->config->tx_id, fc, 3U)) ? CAN_ISOTP_FS_NONE : flow_status;
+}
+
+/* Queues the single frame or first frame of the current transmission */
+static void CAN_IsoTp_SendFirst(CAN_IsoTp_type* isotp, uint8_t channel)
+{
+    CAN_IsoTp_Channel_type* ch = &isotp->channels[channel];
+    uint8_t tx_dl = ch->config->tx_dl;
+    uint8_t frame[CAN_MAX_PAYLOAD_BYTES];
+    uint8_t pci_len;
+    uint8_t data_len;
+
+    /* Up to 7 bytes always fit the classic single frame, also on CAN FD channels,
+       where the receiver expects the escaped form only in frames longer than 8 bytes */
+    if(ch->tx_length <= 7U)
+    {
+        frame[0] = (uint8_t)((CAN_ISOTP_PCI_SF << 4) | ch->tx_length);
+        pci_len = 1U;
+        data_len = (uint8_t)ch->tx_length;
+    }
+    else if((8U < tx_dl) && (ch->tx_length <= (uint32_t)(tx_dl - 2U)))
+    {
+        /* CAN FD single frame: escape nibble 0, length in byte 1 */
+        frame[0] = (uint8_t)(CAN_ISOTP_PCI_SF << 4);
+        frame[1] = (uint8_t)ch->tx_length;
+        pci_len = 2U;
+        data_len = (uint8_t)ch->tx_length;
+    }
+    else if(ch->tx_length <= CAN_ISOTP_FF_DL_12BIT)
+    {
+        frame[0] = (uint8_t)((CAN_ISOTP_PCI_FF << 4) | (ch->tx_length >> 8));
+        frame[1] = (uint8_t)ch->tx_length;
+        pci_len = 2U;
+        data_len = (uint8_t)(tx_dl - 2U);
+    }
+    else
+    {
+        /* FF_DL escape: 12 bit length 0, 32 bit length in bytes 2-5 */
+        frame[0] = (uint8_t)(CAN_ISOTP_PCI_FF << 4);
+        frame[1] = 0U;
+        frame[2] = (uint8_t)(ch->tx_length >> 24);
+        frame[3] = (uint8_t)(ch->tx_length >> 16);
+        frame[4] = (uint8_t)(ch->tx_length >> 8);
+        frame[5] = (uint8_t)ch->tx_length;
+        pci_len = 6U;
+        data_len = (uint8_t)(tx_dl - 6U);
+    }
+    memcpy(&frame[pci_len], ch->tx_data, data_len);
+
+    if(CAN_E_OK == CAN_IsoTp_SendFrame(isotp, ch->config->tx_id, frame, (uint8_t)(pci_len + data_len)))
+    {
+        ch->tx_offset = data_len;
+        if(ch->tx_offset >= ch->tx_length)
+        {
+            CAN_IsoTp_TxFinish(isotp, channel, ISOTP_OK);
+        }
+        else
+        {
+            ch->tx_sn = 1U;
+            ch->tx_wait_count = 0U;
+            ch->tx_deadline_us = isotp->now_us + CAN_ISOTP_N_BS_US;
+            ch->tx_state = CAN_ISOTP_TX_WAIT_FC;
+        }
+    }
+    else
+    {
+        ch->tx_state = CAN_ISOTP_TX_FIRST;
+    }
+}
+
+/* Queues consecutive frames while STmin, the block size and the Tx queue allow */
+static void CAN_IsoTp_SendConsecutive(CAN_IsoTp_type* isotp, uint8_t channel)
+{
+    CAN_IsoTp_Channel_type* ch = &isotp->channels[channel];
+    uint8_t frame[CAN_MAX_PAYLOAD_BYTES];
+    uint8_t max_data = (uint8_t)(ch->config->tx_dl - 1U);
+
+    while((CAN_ISOTP_TX_SEND_CF == ch->tx_state) && CAN_ISOTP_REACHED(isotp->now_us, ch->tx_deadline_us))
+    {
+        uint32_t left = ch->tx_length - ch->tx_offset;
+        uint8_t data_len = (left < max_data) ? (uint8_t)left : max_data;
+
+        frame[0] = (uint8_t)((CAN_ISOTP_PCI_CF << 4) | ch->tx_sn);
+        memcpy(&frame[1], &ch->tx_data[ch->tx_offset], data_len);
+        if(CAN_E_OK != CAN_IsoTp_SendFrame(isotp, ch->config->tx_id, frame, (uint8_t)(1U + data_len)))
+        {
+            break;
+        }
+
+        ch->tx_offset += data_len;
+        ch->tx_sn = (uint8_t)((ch->tx_sn + 1U) & 0xFU);
+        ch->tx_deadline_us = isotp->now_us + ch->tx_stmin_us;
+        if(ch->tx_offset >= ch->tx_length)
+        {
+            CAN_IsoTp_TxFinish(isotp, channel, ISOTP_OK);
+        }
+        else if((0U != ch->tx_bs) && (0U == --ch->tx_bs_left))
+        {
+            ch->tx_wait_count = 0U;
+            ch->tx_deadline_us = isotp->now_us + CAN_ISOTP_N_BS_US;
+            ch->tx_state = CAN_ISOTP_TX_WAIT_FC;
+        }
+        else
+        {
+            /* DO NOTHING */
+        }
+    }
+}
+
+static void CAN_IsoTp_RxFlowControl(CAN_IsoTp_type* isotp, uint8_t channel, const uint8_t* data, uint8_t length)
+{
+    CAN_IsoTp_Channel_type* ch = &isotp->channels[channel];
+    uint8_t flow_status = data[0] & 0xFU;
+
+    if((CAN_ISOTP_TX_WAIT_FC != ch->tx_state) || (length < 3U))
+    {
+        return;
+    }
+
+    if(CAN_ISOTP_FS_CTS == flow_status)
+    {
+        ch->tx_bs = data[1];
+        ch->tx_bs_left = data[1];
+        ch->tx_stmin_us = CAN_IsoTp_StMinUs(data[2]);
+        ch->tx_deadline_us = isotp->now_us;
+        ch->tx_state = CAN_ISOTP_TX_SEND_CF;
+        CAN_IsoTp_SendConsecutive(isotp, channel);
+    }
+    else if(CAN_ISOTP_FS_WAIT == flow_status)
+    {
+        ch->tx_wait_count++;
+        if(ch->tx_wait_count > CAN_ISOTP_MAX_WFT)
+        {
+            CAN_IsoTp_TxFinish(isotp, channel, ISOTP_WFT_OVRN);
+        }
+        else
+        {
+            ch->tx_deadline_us = isotp->now_us + CAN_ISOTP_N_BS_US;
+        }
+    }
+    else if(CAN_ISOTP_FS_OVFLW == flow_status)
+    {
+        CAN_IsoTp_TxFinish(isotp, channel, ISOTP_BUFFER_OVFLW);
+    }
+    else
+    {
+        CAN_IsoTp_TxFinish(isotp, channel, ISOTP_INVALID_FS);
+    }
+}
+
+/* Starts a reception from a single frame or first frame; data_len bytes of the message follow the PCI */
+static void CAN_IsoTp_RxStart(CAN_IsoTp_type* isotp, uint8_t channel, uint32_t msg_len, const uint8_t* data, uint8_t data_len, uint8_t first_frame)
+{
+    CAN_IsoTp_Channel_type* ch = &isotp->channels[channel];
+
+    /* A new message ends the one in progress */
+    if(CAN_ISOTP_RX_RECEIVING == ch->rx_state)
+    {
+        CAN_IsoTp_RxFinish(isotp, channel, ISOTP_UNEXP_PDU);
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+
+    if(msg_len > ch->config->rx_buffer_size)
+    {
+        if(first_frame)
+        {
+            CAN_IsoTp_SendFlowControl(isotp, ch, CAN_ISOTP_FS_OVFLW);
+        }
+        else
+        {
+            /* DO NOTHING */
+        }
+        CAN_IsoTp_RxFinish(isotp, channel, ISOTP_BUFFER_OVFLW);
+        return;
+    }
+
+    if(data_len > msg_len)
+    {
+        data_len = (uint8_t)msg_len;
+    }
+    memcpy(ch->config->rx_buffer, data, data_len);
+    ch->rx_length = msg_len;
+    ch->rx_offset = data_len;
+
+    if(first_frame)
+    {
+        ch->rx_sn = 1U;
+        ch->rx_bs_left = ch->config->block_size;
+        ch->rx_deadline_us = isotp->now_us + CAN_ISOTP_N_CR_US;
+        ch->rx_state = CAN_ISOTP_RX_RECEIVING;
+        ch->rx_result = ISOTP_BUSY;
+        CAN_IsoTp_SendFlowControl(isotp, ch, CAN_ISOTP_FS_CTS);
+    }
+    else
+    {
+        CAN_IsoTp_RxFinish(isotp, channel, ISOTP_OK);
+    }
+}
+
+static void CAN_IsoTp_RxConsecutive(CAN_IsoTp_type* isotp, uint8_t channel, const uint8_t* data, uint8_t length)
+{
+    CAN_IsoTp_Channel_type* ch = &isotp->channels[channel];
+    uint32_t left = ch->rx_length - ch->rx_offset;
+    uint8_t data_len = (uint8_t)(length - 1U);
+
+    if(CAN_ISOTP_RX_RECEIVING != ch->rx_state)
+    {
+        return;
+    }
+    if((data[0] & 0xFU) != ch->rx_sn)
+    {
+        CAN_IsoTp_RxFinish(isotp, channel, ISOTP_WRONG_SN);
+        return;
+    }
+
+    if(data_len > left)
+    {
+        data_len = (uint8_t)left;
+    }
+    memcpy(&ch->config->rx_buffer[ch->rx_offset], &data[1], data_len);
+    ch->rx_offset += data_len;
+    ch->rx_sn = (uint8_t)((ch->rx_sn + 1U) & 0xFU);
+    ch->rx_deadline_us = isotp->now_us + CAN_ISOTP_N_CR_US;
+
+    if(ch->rx_offset >= ch->rx_length)
+    {
+        CAN_IsoTp_RxFinish(isotp, channel, ISOTP_OK);
+    }
+    else if((0U != ch->config->block_size) && (0U == --ch->rx_bs_left))
+    {
+        ch->rx_bs_left = ch->config->block_size;
+        CAN_IsoTp_SendFlowControl(isotp, ch, CAN_ISOTP_FS_CTS);
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+}
+
+Std_CAN_Status CAN_IsoTp_Init(CAN_IsoTp_type* isotp, const CAN_IsoTp_Config_type* config)
+{
+    CAN_Handle_type* can_handle = config->can_handle;
+    uint8_t max_length = 8U;
+
+    if(can_handle->tx_cs_flags & CAN_MB_CS_EDL_MASK)
+    {
+        max_length = (uint8_t)((can_handle->msg_buff_size - 2U) * 4U);
+    }
+    if((NULL == config->channels) || (config->num_channels > CAN_ISOTP_MAX_CHANNELS))
+    {
+        return CAN_E_NOT_OK;
+    }
+    for(uint8_t idx = 0; idx < config->num_channels; idx++)
+    {
+        const CAN_IsoTp_ChannelConfig_type* ch_config = &config->channels[idx];
+        uint8_t tx_dl = ch_config->tx_dl;
+        if((tx_dl < 8U) || (tx_dl > max_length) || (tx_dl != CAN_DlcToLength(can_handle, CAN_LengthToDlc(tx_dl)))
+        || (NULL == ch_config->rx_buffer) || (0U == ch_config->rx_buffer_size))
+        {
+            return CAN_E_NOT_OK;
+        }
+    }
+
+    memset(isotp, 0, sizeof(*isotp));
+    isotp->can_handle = can_handle;
+    isotp->num_channels = config->num_channels;
+    isotp->callback = config->callback;
+    for(uint8_t idx = 0; idx < config->num_channels; idx++)
+    {
+        isotp->channels[idx].config = &config->channels[idx];
+        isotp->channels[idx].tx_result = ISOTP_OK;
+        isotp->channels[idx].rx_result = ISOTP_OK;
+        isotp->channels[idx].rx_fc_pending = CAN_ISOTP_FS_NONE;
+    }
+
+    return CAN_E_OK;
+}
+
+Std_CAN_Status CAN_IsoTp_Send(CAN_IsoTp_type* isotp, uint8_t channel, const uint8_t* data, uint32_t length)
+{
+    CAN_IsoTp_Channel_type* ch;
+
+    if((channel >= isotp->num_channels) || (NULL == data) || (0U == length))
+    {
+        return CAN_E_NOT_OK;
+    }
+    ch = &isotp->channels[channel];
+    if(CAN_ISOTP_TX_IDLE != ch->tx_state)
+    {
+        return CAN_E_NOT_OK;
+    }
+
+    ch->tx_data = data;
+    ch->tx_length = length;
+    ch->tx_offset = 0U;
+    ch->tx_result = ISOTP_BUSY;
+    CAN_IsoTp_SendFirst(isotp, channel);
+
+    return CAN_E_OK;
+}
+
+Std_CAN_Status CAN_IsoTp_RxIndication(CAN_IsoTp_type* isotp, const CAN_Frame_type* frame)
+{
+    uint8_t length = CAN_DlcToLength(isotp->can_handle, frame->dlc);
+    const uint8_t* data = frame->data;
+
+    /* Remote frames carry no N_PDU, identifiers are in the format of the controller */
+    if((frame->flags & CAN_FRAME_FLAG_RTR)
+    || ((frame->flags & CAN_FRAME_FLAG_IDE) != isotp->can_handle->tx_id_flags))
+    {
+        return CAN_E_NOT_OK;
+    }
+
+    for(uint8_t channel = 0; channel < isotp->num_channels; channel++)
+    {
+        if(frame->id != isotp->channels[channel].config->rx_id)
+        {
+            continue;
+        }
+        if(0U == length)
+        {
+            return CAN_E_OK;
+        }
+
+        switch(data[0] >> 4)
+        {
+        case CAN_ISOTP_PCI_SF:
+            if((0U != (data[0] & 0xFU)) && (length <= 8U) && ((data[0] & 0xFU) < length))
+            {
+                CAN_IsoTp_RxStart(isotp, channel, data[0] & 0xFU, &data[1], (uint8_t)(data[0] & 0xFU), 0U);
+            }
+            else if((0U == (data[0] & 0xFU)) && (length > 8U) && (0U != data[1]) && (data[1] <= (uint8_t)(length - 2U)))
+            {
+                CAN_IsoTp_RxStart(isotp, channel, data[1], &data[2], data[1], 0U);
+            }
+            else
+            {
+                /* Malformed single frame */
+            }
+            break;
+        case CAN_ISOTP_PCI_FF:
+            if(length >= 8U)
+            {
+                uint32_t msg_len = ((uint32_t)(data[0] & 0xFU) << 8) | data[1];
+                uint8_t pci_len = 2U;
+                if(0U == msg_len)
+                {
+                    msg_len = ((uint32_t)data[2] << 24) | ((uint32_t)data[3] << 16) | ((uint32_t)data[4] << 8) | data[5];
+                    pci_len = 6U;
+                }
+                /* A first frame always announces more than it carries */
+                if(msg_len > (uint32_t)(length - pci_len))
+                {
+                    CAN_IsoTp_RxStart(isotp, channel, msg_len, &data[pci_len], (uint8_t)(length - pci_len), 1U);
+                }
+            }
+            break;
+        case CAN_ISOTP_PCI_CF:
+            CAN_IsoTp_RxConsecutive(isotp, channel, data, length);
+            break;
+        case CAN_ISOTP_PCI_FC:
+            CAN_IsoTp_RxFlowControl(isotp, channel, data, length);
+            break;
+        default:
+            /* Reserved PCI types are ignored */
+            break;
+        }
+
+        return CAN_E_OK;
+    }
+
+    isotp->unmatched_frames++;
+
+    return CAN_E_NOT_OK;
+}
+
+void CAN_IsoTp_MainFunction(CAN_IsoTp_type* isotp, uint32_t now_us)
+{
+    isotp->now_us = now_us;
+
+    for(uint8_t channel = 0; channel < isotp->num_channels; channel++)
+    {
+        CAN_IsoTp_Channel_type* ch = &isotp->channels[channel];
+
+        /* Reception */
+        if(CAN_ISOTP_FS_NONE != ch->rx_fc_pending)
+        {
+            CAN_IsoTp_SendFlowControl(isotp, ch, ch->rx_fc_pending);
+        }
+        else
+        {
+            /* DO NOTHING */
+        }
+        if((CAN_ISOTP_RX_RECEIVING == ch->rx_state) && CAN_ISOTP_REACHED(now_us, ch->rx_deadline_us))
+        {
+            CAN_IsoTp_RxFinish(isotp, channel, ISOTP_TIMEOUT_CR);
+        }
+        else
+        {
+            /* DO NOTHING */
+        }
+
+        /* Transmission */
+        if(CAN_ISOTP_TX_FIRST == ch->tx_state)
+        {
+            CAN_IsoTp_SendFirst(isotp, channel);
+        }
+        else if((CAN_ISOTP_TX_WAIT_FC == ch->tx_state) && CAN_ISOTP_REACHED(now_us, ch->tx_deadline_us))
+        {
+            CAN_IsoTp_TxFinish(isotp, channel, ISOTP_TIMEOUT_BS);
+        }
+        else if(CAN_ISOTP_TX_SEND_CF == ch->tx_state)
+        {
+            CAN_IsoTp_SendConsecutive(isotp, channel);
+        }
+        else
+        {
+            /* DO NOTHING */
+        }
+    }
+}
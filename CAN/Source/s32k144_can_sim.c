@@ -0,0 +1,1716 @@
+/**
+ * @file s32k144_can_sim.c
+ * @brief Host-side register model of FlexCAN controllers sharing one virtual CAN bus.
+ *
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*******************************************************************************
+ * Inclusion
+ ******************************************************************************/
+
+#include "../src/Driver/CAN/Include/s32k144_can_sim.h"
+
+#ifdef CAN_SIM
+
+#include <string.h>
+#include <time.h>
+
+/*******************************************************************************
+ * Macro
+ ******************************************************************************/
+
+#define CAN_SIM_MCR_RESET        (0xD890000FU)
+#define CAN_SIM_FIFO_DEPTH       (6U)   /* Frames held by the legacy Rx FIFO */
+#define CAN_SIM_FIFO_WARNING     (5U)   /* BUF6I is set when this many frames are stored */
+#define CAN_SIM_FIFO_FILTER_BASE (24U)  /* RAMn word of the first ID filter element */
+#define CAN_SIM_RXIMR_COUNT      (32U)
+#define CAN_SIM_RAM_WORDS        (128U)
+#define CAN_SIM_FRAME_TAIL_BITS  (13U)  /* CRC delimiter, ACK slot and delimiter, EOF, intermission */
+#define CAN_SIM_PS_PER_S         (1000000000000ULL)
+
+#define CAN_SIM_MB_CODE_RX_FULL    (0x2U)
+#define CAN_SIM_MB_CODE_RX_OVERRUN (0x6U)
+#define CAN_SIM_MB_CODE_RANSWER    (0xAU)
+#define CAN_SIM_MB_CODE_TANSWER    (0xEU)
+
+/* CS bits copied from the transmitted frame into the receiving message buffer */
+#define CAN_SIM_ESR1_BUS_OFF  (0x20U) /* ESR1[FLTCONF] = 1x */
+#define CAN_SIM_BUS_OFF_BITS  (128U * 11U) /* Recessive bits the automatic bus off recovery waits for */
+
+#define CAN_SIM_CS_FRAME_MASK (CAN_MB_CS_EDL_MASK | CAN_MB_CS_BRS_MASK | CAN_WMBn_CS_SRR_MASK \
+                             | CAN_MB_CS_IDE_MASK | CAN_WMBn_CS_RTR_MASK | CAN_MB_CS_DLC_MASK)
+
+/*******************************************************************************
+* Variables
+******************************************************************************/
+
+/* Frame on the wire, in message buffer layout */
+typedef struct
+{
+    uint32_t cs;        /* EDL, BRS, SRR, IDE, RTR and DLC bits */
+    uint32_t id;        /* Message buffer ID word */
+    uint32_t data[16];  /* Payload words, byte 0 in bits 31-24 */
+} CAN_SimFrame_type;
+
+typedef struct
+{
+    CAN_Handle_type* can_handle;
+    uint32_t fifo[CAN_SIM_FIFO_DEPTH][4]; /* CS, ID and two payload words per stored frame */
+    uint16_t fifo_idhit[CAN_SIM_FIFO_DEPTH];
+    uint8_t fifo_count;
+    uint32_t tx_seen_map;                 /* Tx MBs whose request time is recorded */
+    uint64_t tx_since_ps[32];
+    uint64_t busoff_until_ps;             /* End of the automatic bus off recovery, 0 when not bus off */
+    uint8_t dma_irq;                      /* Rx FIFO eDMA channel reached half or end of its major loop */
+    uint8_t pn_stop;                      /* Stop mode with Pretended Networking: only the PN filter listens */
+} CAN_SimNode_type;
+
+/* Bit stream writer counting stuff bits */
+typedef struct
+{
+    uint8_t last;
+    uint8_t run;
+    uint32_t bits;
+    uint16_t crc;
+} CAN_SimBits_type;
+
+CAN_Type CAN_Sim_regs[CAN_INSTANCE_COUNT];
+DMA_Type CAN_Sim_dma;
+DMAMUX_Type CAN_Sim_dmamux;
+
+static CAN_SimNode_type CAN_sim_nodes[CAN_SIM_MAX_NODES];
+static uint8_t CAN_sim_num_nodes = 0;
+static uint64_t CAN_sim_time_ps = 0;
+static uint64_t CAN_sim_busy_ps = 0;
+static CAN_Sim_Stats_type CAN_sim_stats;
+static uint8_t CAN_sim_in_step = 0; /* Interrupt handlers must not recurse into the bus */
+static uint32_t CAN_sim_irq_lock = 0; /* Nesting depth of CAN_CRITICAL_ENTER, no interrupt handler runs while set */
+
+static CAN_Sim_ModelHook_type CAN_sim_model_hook = NULL;
+
+static const uint8_t CAN_sim_dlc_length_arr[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64};
+
+/*******************************************************************************
+* Code
+******************************************************************************/
+
+static CAN_SimNode_type* CAN_Sim_FindNode(const CAN_Type* can_instance)
+{
+    CAN_SimNode_type* node = NULL;
+    for(uint8_t idx = 0; (idx < CAN_sim_num_nodes) && (NULL == node); idx++)
+    {
+        if(can_instance == CAN_sim_nodes[idx].can_handle->can_instance)
+        {
+            node = &CAN_sim_nodes[idx];
+        }
+    }
+
+    return node;
+}
+
+/* MCR acknowledge bits follow the request bits at once */
+static void CAN_Sim_Acknowledge(CAN_Type* CANx)
+{
+    uint32_t mcr = CANx->MCR & ~(CAN_MCR_LPMACK_MASK | CAN_MCR_FRZACK_MASK | CAN_MCR_NOTRDY_MASK | CAN_MCR_SOFTRST_MASK);
+
+    if(mcr & CAN_MCR_MDIS_MASK)
+    {
+        mcr |= CAN_MCR_LPMACK_MASK | CAN_MCR_NOTRDY_MASK;
+    }
+    else if((mcr & CAN_MCR_FRZ_MASK) && (mcr & CAN_MCR_HALT_MASK))
+    {
+        mcr |= CAN_MCR_FRZACK_MASK | CAN_MCR_NOTRDY_MASK;
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+    CANx->MCR = mcr;
+
+    /* TXERRCNT cleared while bus off (freeze mode write): back to error active */
+    if((CANx->ESR1 & CAN_SIM_ESR1_BUS_OFF) && (0U == (CANx->ECR & CAN_ECR_TXERRCNT_MASK)))
+    {
+        CAN_SimNode_type* node = CAN_Sim_FindNode(CANx);
+        CANx->ESR1 &= ~CAN_ESR1_FLTCONF_MASK;
+        if(NULL != node)
+        {
+            node->busoff_until_ps = 0;
+        }
+    }
+}
+
+static uint8_t CAN_Sim_OnBus(const CAN_Type* CANx)
+{
+    return (0U == (CANx->MCR & (CAN_MCR_MDIS_MASK | CAN_MCR_FRZACK_MASK | CAN_MCR_NOTRDY_MASK)))
+        && (0U == (CANx->ESR1 & CAN_SIM_ESR1_BUS_OFF));
+}
+
+static uint32_t CAN_Sim_RamWords(const CAN_Type* CANx)
+{
+    return ((CAN1 == CANx) || (CAN2 == CANx)) ? (CAN1_MB_COUNT * 4U) : CAN_SIM_RAM_WORDS;
+}
+
+/* Words of message buffer idx_mb and its first RAMn word, 0 words past the end of the MB RAM */
+static uint8_t CAN_Sim_MsgBuffLayout(const CAN_Type* CANx, uint8_t idx_mb, uint32_t* base)
+{
+    static const uint8_t words_arr[4] = {4U, 6U, 10U, 18U};
+    uint32_t ram_words = CAN_Sim_RamWords(CANx);
+    uint32_t first_mb = 0;
+
+    for(uint32_t region = 0; (region < CAN_MB_REGION_COUNT) && ((region * CAN_MB_REGION_WORDS) < ram_words); region++)
+    {
+        uint32_t region_base = region * CAN_MB_REGION_WORDS;
+        uint32_t region_words = ram_words - region_base;
+        uint32_t mbdsr = (CANx->FDCTRL & CAN_FDCTRL_MBDSR0_MASK) >> CAN_FDCTRL_MBDSR0_SHIFT;
+#ifdef CAN_FDCTRL_MBDSR1_MASK
+        if(1U == region)
+        {
+            mbdsr = (CANx->FDCTRL & CAN_FDCTRL_MBDSR1_MASK) >> CAN_FDCTRL_MBDSR1_SHIFT;
+        }
+#endif
+        uint8_t words = (CANx->MCR & CAN_MCR_FDEN_MASK) ? words_arr[mbdsr] : 4U;
+        if(region_words > CAN_MB_REGION_WORDS)
+        {
+            region_words = CAN_MB_REGION_WORDS;
+        }
+        if(idx_mb < (first_mb + (region_words / words)))
+        {
+            *base = region_base + ((idx_mb - first_mb) * words);
+            return words;
+        }
+        first_mb += region_words / words;
+    }
+
+    return 0;
+}
+
+static uint8_t CAN_Sim_NumMsgBuff(const CAN_Type* CANx)
+{
+    uint32_t base;
+    uint8_t num_msg_buff = (uint8_t)(((CANx->MCR & CAN_MCR_MAXMB_MASK) >> CAN_MCR_MAXMB_SHIFT) + 1U);
+
+    if(num_msg_buff > CAN_MAX_MSG_BUFF)
+    {
+        num_msg_buff = CAN_MAX_MSG_BUFF;
+    }
+    while((num_msg_buff > 0U) && (0U == CAN_Sim_MsgBuffLayout(CANx, (uint8_t)(num_msg_buff - 1U), &base)))
+    {
+        num_msg_buff--;
+    }
+
+    return num_msg_buff;
+}
+
+/* First message buffer not taken by the Rx FIFO engine and its ID filter table */
+static uint8_t CAN_Sim_FirstMsgBuff(const CAN_Type* CANx)
+{
+    uint8_t first = 0;
+    if(CANx->MCR & CAN_MCR_RFEN_MASK)
+    {
+        uint32_t rffn = (CANx->CTRL2 & CAN_CTRL2_RFFN_MASK) >> CAN_CTRL2_RFFN_SHIFT;
+        first = (uint8_t)(CAN_RX_FIFO_MB_COUNT + (2U * (rffn + 1U)));
+    }
+
+    return first;
+}
+
+static uint8_t CAN_Sim_FrameLength(const CAN_SimFrame_type* frame)
+{
+    uint8_t length = CAN_sim_dlc_length_arr[(frame->cs & CAN_MB_CS_DLC_MASK) >> CAN_MB_CS_DLC_SHIFT];
+    if((0U == (frame->cs & CAN_MB_CS_EDL_MASK)) && (length > 8U))
+    {
+        length = 8U;
+    }
+
+    return length;
+}
+
+/* Time of one nominal (data_phase = 0) or data phase bit in picoseconds */
+static uint64_t CAN_Sim_BitTimePs(const CAN_Type* CANx, uint8_t data_phase)
+{
+    uint64_t clock_hz = (CANx->CTRL1 & CAN_CTRL1_CLKSRC_MASK) ? CANCLK : fCANCLK;
+    uint32_t cbt = CANx->CBT;
+    uint32_t ctrl1 = CANx->CTRL1;
+    uint32_t fdcbt = CANx->FDCBT;
+    uint64_t prescaler;
+    uint64_t num_tq;
+
+    if(data_phase)
+    {
+        prescaler = ((fdcbt & CAN_FDCBT_FPRESDIV_MASK) >> CAN_FDCBT_FPRESDIV_SHIFT) + 1U;
+        num_tq = 1U + ((fdcbt & CAN_FDCBT_FPROPSEG_MASK) >> CAN_FDCBT_FPROPSEG_SHIFT)
+               + ((fdcbt & CAN_FDCBT_FPSEG1_MASK) >> CAN_FDCBT_FPSEG1_SHIFT) + 1U
+               + ((fdcbt & CAN_FDCBT_FPSEG2_MASK) >> CAN_FDCBT_FPSEG2_SHIFT) + 1U;
+    }
+    else if(cbt & CAN_CBT_BTF_MASK)
+    {
+        prescaler = ((cbt & CAN_CBT_EPRESDIV_MASK) >> CAN_CBT_EPRESDIV_SHIFT) + 1U;
+        num_tq = 1U + ((cbt & CAN_CBT_EPROPSEG_MASK) >> CAN_CBT_EPROPSEG_SHIFT) + 1U
+               + ((cbt & CAN_CBT_EPSEG1_MASK) >> CAN_CBT_EPSEG1_SHIFT) + 1U
+               + ((cbt & CAN_CBT_EPSEG2_MASK) >> CAN_CBT_EPSEG2_SHIFT) + 1U;
+    }
+    else
+    {
+        prescaler = ((ctrl1 & CAN_CTRL1_PRESDIV_MASK) >> CAN_CTRL1_PRESDIV_SHIFT) + 1U;
+        num_tq = 1U + ((ctrl1 & CAN_CTRL1_PROPSEG_MASK) >> CAN_CTRL1_PROPSEG_SHIFT) + 1U
+               + ((ctrl1 & CAN_CTRL1_PSEG1_MASK) >> CAN_CTRL1_PSEG1_SHIFT) + 1U
+               + ((ctrl1 & CAN_CTRL1_PSEG2_MASK) >> CAN_CTRL1_PSEG2_SHIFT) + 1U;
+    }
+
+    return (prescaler * num_tq * CAN_SIM_PS_PER_S) / clock_hz;
+}
+
+/* Appends num_bits of value MSB first, inserting a complement bit after 5 equal bits */
+static void CAN_Sim_PutBits(CAN_SimBits_type* stream, uint32_t value, uint8_t num_bits, uint8_t update_crc)
+{
+    while(num_bits > 0U)
+    {
+        num_bits--;
+        uint8_t bit = (uint8_t)((value >> num_bits) & 1U);
+        if(update_crc)
+        {
+            /* CAN 2.0 CRC-15, x^15 + x^14 + x^10 + x^8 + x^7 + x^4 + x^3 + 1 */
+            uint8_t crc_next = (uint8_t)(bit ^ ((stream->crc >> 14) & 1U));
+            stream->crc = (uint16_t)((stream->crc << 1) & 0x7FFFU);
+            if(crc_next)
+            {
+                stream->crc ^= 0x4599U;
+            }
+        }
+        stream->bits++;
+        if(bit == stream->last)
+        {
+            stream->run++;
+        }
+        else
+        {
+            stream->last = bit;
+            stream->run = 1;
+        }
+        if(5U == stream->run)
+        {
+            stream->bits++;
+            stream->last = (uint8_t)(bit ^ 1U);
+            stream->run = 1;
+        }
+    }
+}
+
+/* Duration of frame on the bus of the transmitter CANx, stuff bits included */
+static uint64_t CAN_Sim_FrameTimePs(const CAN_Type* CANx, const CAN_SimFrame_type* frame)
+{
+    CAN_SimBits_type stream = {1U, 0U, 0U, 0U};
+    uint8_t is_ext = (0U != (frame->cs & CAN_MB_CS_IDE_MASK));
+    uint8_t is_fd = (0U != (frame->cs & CAN_MB_CS_EDL_MASK));
+    uint8_t brs = (0U != (frame->cs & CAN_MB_CS_BRS_MASK));
+    uint8_t rtr = (0U != (frame->cs & CAN_WMBn_CS_RTR_MASK));
+    uint8_t length = CAN_Sim_FrameLength(frame);
+    uint32_t nominal_bits;
+    uint32_t data_bits = 0;
+
+    CAN_Sim_PutBits(&stream, 0U, 1U, 1U);
+    CAN_Sim_PutBits(&stream, (frame->id >> CAN_WMBn_CS_STD_ID_SHIFT) & 0x7FFU, 11U, 1U);
+    if(is_ext)
+    {
+        CAN_Sim_PutBits(&stream, 3U, 2U, 1U); /* SRR, IDE */
+        CAN_Sim_PutBits(&stream, frame->id & 0x3FFFFU, 18U, 1U);
+    }
+
+    if(!is_fd)
+    {
+        /* RTR, then IDE and r0 (standard) or r1 and r0 (extended) */
+        CAN_Sim_PutBits(&stream, rtr, 1U, 1U);
+        CAN_Sim_PutBits(&stream, 0U, 2U, 1U);
+        CAN_Sim_PutBits(&stream, (frame->cs & CAN_MB_CS_DLC_MASK) >> CAN_MB_CS_DLC_SHIFT, 4U, 1U);
+        for(uint8_t idx = 0; (0U == rtr) && (idx < length); idx++)
+        {
+            CAN_Sim_PutBits(&stream, (frame->data[idx / 4U] >> (24U - (8U * (idx % 4U)))) & 0xFFU, 8U, 1U);
+        }
+        CAN_Sim_PutBits(&stream, stream.crc, 15U, 0U);
+        nominal_bits = stream.bits + CAN_SIM_FRAME_TAIL_BITS;
+    }
+    else
+    {
+        /* RRS (and IDE = 0 for standard frames), FDF, res, BRS */
+        CAN_Sim_PutBits(&stream, 0U, is_ext ? 1U : 2U, 0U);
+        CAN_Sim_PutBits(&stream, 4U | brs, 3U, 0U);
+        uint32_t arbitration_bits = stream.bits;
+
+        /* ESI, DLC and payload are stuffed dynamically; stuff count and CRC use fixed stuff bits */
+        CAN_Sim_PutBits(&stream, 0U, 1U, 0U);
+        CAN_Sim_PutBits(&stream, (frame->cs & CAN_MB_CS_DLC_MASK) >> CAN_MB_CS_DLC_SHIFT, 4U, 0U);
+        for(uint8_t idx = 0; idx < length; idx++)
+        {
+            CAN_Sim_PutBits(&stream, (frame->data[idx / 4U] >> (24U - (8U * (idx % 4U)))) & 0xFFU, 8U, 0U);
+        }
+        uint32_t crc_bits = (length > 16U) ? 21U : 17U;
+        uint32_t fixed_bits = 4U + crc_bits + 1U + ((4U + crc_bits + 3U) / 4U);
+
+        if(brs)
+        {
+            nominal_bits = arbitration_bits + CAN_SIM_FRAME_TAIL_BITS;
+            data_bits = (stream.bits - arbitration_bits) + fixed_bits;
+        }
+        else
+        {
+            nominal_bits = stream.bits + fixed_bits + CAN_SIM_FRAME_TAIL_BITS;
+        }
+    }
+
+    return ((uint64_t)nominal_bits * CAN_Sim_BitTimePs(CANx, 0U)) + ((uint64_t)data_bits * CAN_Sim_BitTimePs(CANx, 1U));
+}
+
+/* Lowest value wins: base ID, then RTR/SRR, IDE, extended ID bits and RTR as sent on the wire */
+static uint64_t CAN_Sim_ArbitrationKey(const CAN_SimFrame_type* frame)
+{
+    uint64_t base_id = (frame->id >> CAN_WMBn_CS_STD_ID_SHIFT) & 0x7FFU;
+    uint64_t rtr = (frame->cs & CAN_WMBn_CS_RTR_MASK) ? 1U : 0U;
+    uint64_t key;
+
+    if(frame->cs & CAN_MB_CS_IDE_MASK)
+    {
+        key = (base_id << 21) | (1ULL << 20) | (1ULL << 19) | ((uint64_t)(frame->id & 0x3FFFFU) << 1) | rtr;
+    }
+    else
+    {
+        key = (base_id << 21) | (rtr << 20);
+    }
+
+    return key;
+}
+
+static void CAN_Sim_ReadTxMsgBuff(const CAN_Type* CANx, uint8_t idx_mb, CAN_SimFrame_type* frame)
+{
+    uint32_t base = 0;
+    uint8_t words = CAN_Sim_MsgBuffLayout(CANx, idx_mb, &base);
+
+    frame->cs = CANx->RAMn[base] & CAN_SIM_CS_FRAME_MASK;
+    frame->id = CANx->RAMn[base + 1U] & CAN_MB_ID_EXT_MASK;
+    memset(frame->data, 0, sizeof(frame->data));
+    for(uint8_t idx = 0; idx < (uint8_t)(words - 2U); idx++)
+    {
+        frame->data[idx] = CANx->RAMn[base + 2U + idx];
+    }
+}
+
+/* With CTRL2[RRS] clear a remote request arms the first remote answer MB with its identifier. Returns 0 on no match */
+static uint8_t CAN_Sim_RemoteAnswer(CAN_Type* CANx, const CAN_SimFrame_type* frame)
+{
+    uint8_t num_msg_buff = CAN_Sim_NumMsgBuff(CANx);
+
+    for(uint8_t idx_mb = CAN_Sim_FirstMsgBuff(CANx); idx_mb < num_msg_buff; idx_mb++)
+    {
+        uint32_t base = 0;
+        (void)CAN_Sim_MsgBuffLayout(CANx, idx_mb, &base);
+        uint32_t cs = CANx->RAMn[base];
+
+        if((CAN_SIM_MB_CODE_RANSWER == ((cs & CAN_MB_CS_CODE_MASK) >> CAN_MB_CS_CODE_SHIFT))
+        && (0U == ((cs ^ frame->cs) & CAN_MB_CS_IDE_MASK))
+        && (0U == ((CANx->RAMn[base + 1U] ^ frame->id) & CAN_MB_ID_EXT_MASK)))
+        {
+            CANx->RAMn[base] = (cs & ~CAN_MB_CS_CODE_MASK) | ((uint32_t)CAN_SIM_MB_CODE_TANSWER << CAN_MB_CS_CODE_SHIFT);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/* Stores frame in the first empty matching Rx MB, or overwrites the last full one. Returns 0 on no match */
+static uint8_t CAN_Sim_StoreMsgBuff(CAN_Type* CANx, const CAN_SimFrame_type* frame, uint16_t timestamp)
+{
+    uint8_t num_msg_buff = CAN_Sim_NumMsgBuff(CANx);
+    uint32_t hit_base = 0;
+    uint8_t hit_words = 0;
+    uint32_t full_base = 0;
+    uint8_t full_words = 0;
+    int16_t hit = -1;
+    int16_t last_full = -1;
+    uint32_t code = CAN_MB_CODE_RX_EMPTY;
+
+    for(uint8_t idx_mb = CAN_Sim_FirstMsgBuff(CANx); (idx_mb < num_msg_buff) && (hit < 0); idx_mb++)
+    {
+        uint32_t base = 0;
+        uint8_t words = CAN_Sim_MsgBuffLayout(CANx, idx_mb, &base);
+        uint32_t cs = CANx->RAMn[base];
+        uint32_t mb_code = (cs & CAN_MB_CS_CODE_MASK) >> CAN_MB_CS_CODE_SHIFT;
+        uint32_t mask;
+
+        if((CAN_MB_CODE_RX_EMPTY != mb_code) && (CAN_SIM_MB_CODE_RX_FULL != mb_code) && (CAN_SIM_MB_CODE_RX_OVERRUN != mb_code))
+        {
+            continue;
+        }
+        if(CANx->MCR & CAN_MCR_IRMQ_MASK)
+        {
+            mask = CANx->RXIMR[idx_mb];
+        }
+        else if(14U == idx_mb)
+        {
+            mask = CANx->RX14MASK;
+        }
+        else if(15U == idx_mb)
+        {
+            mask = CANx->RX15MASK;
+        }
+        else
+        {
+            mask = CANx->RXMGMASK;
+        }
+        /* IDE is always compared, with CTRL2[EACEN] only under the mask bits above the identifier */
+        if(((cs ^ frame->cs) & CAN_MB_CS_IDE_MASK)
+        && ((0U == (CANx->CTRL2 & CAN_CTRL2_EACEN_MASK)) || (0U != (mask & ~CAN_MB_ID_EXT_MASK))))
+        {
+            continue;
+        }
+        if(0U != ((CANx->RAMn[base + 1U] ^ frame->id) & mask & CAN_MB_ID_EXT_MASK))
+        {
+            continue;
+        }
+
+        if(CAN_MB_CODE_RX_EMPTY == mb_code)
+        {
+            hit = (int16_t)idx_mb;
+            hit_base = base;
+            hit_words = words;
+            code = CAN_SIM_MB_CODE_RX_FULL;
+        }
+        else
+        {
+            last_full = (int16_t)idx_mb;
+            full_base = base;
+            full_words = words;
+        }
+    }
+
+    if((hit < 0) && (last_full >= 0))
+    {
+        hit = last_full;
+        hit_base = full_base;
+        hit_words = full_words;
+        code = CAN_SIM_MB_CODE_RX_OVERRUN;
+    }
+
+    if(hit >= 0)
+    {
+        for(uint8_t idx = 0; idx < (uint8_t)(hit_words - 2U); idx++)
+        {
+            CANx->RAMn[hit_base + 2U + idx] = frame->data[idx];
+        }
+        CANx->RAMn[hit_base + 1U] = frame->id;
+        CANx->RAMn[hit_base] = (code << CAN_MB_CS_CODE_SHIFT) | frame->cs | timestamp;
+        CANx->IFLAG1 |= (uint32_t)(1UL << hit);
+    }
+
+    return (hit < 0) ? 0U : ((CAN_SIM_MB_CODE_RX_FULL == code) ? 1U : 2U);
+}
+
+/* Moves the oldest stored frame into the MB0 output area and raises BUF5I */
+static void CAN_Sim_LoadFifoOutput(CAN_SimNode_type* node, CAN_Type* CANx)
+{
+    CANx->RAMn[0] = node->fifo[0][0];
+    CANx->RAMn[1] = node->fifo[0][1];
+    CANx->RAMn[2] = node->fifo[0][2];
+    CANx->RAMn[3] = node->fifo[0][3];
+    *(volatile uint32_t*)&CANx->RXFIR = node->fifo_idhit[0];
+    CANx->IFLAG1 |= CAN_IFLAG1_BUF5I_MASK;
+}
+
+/* Reads one 32 bit word at a bus address inside the register block of CANx */
+static uint32_t CAN_Sim_DmaRead(const CAN_Type* CANx, uint32_t address)
+{
+    uint32_t offset = address - (uint32_t)(uintptr_t)CANx;
+
+    return (offset <= (sizeof(CAN_Type) - 4U)) ? *(const volatile uint32_t*)((const uint8_t*)CANx + offset) : 0xDEADBEEFU;
+}
+
+/* With MCR[DMA] BUF5I requests the eDMA channel routed to this controller, which runs one minor loop
+   along its TCD (SOFF/DOFF, minor loop offset with CR[EMLM], SLAST/DLASTSGA) and pops the FIFO */
+static void CAN_Sim_ServiceDma(CAN_SimNode_type* node, CAN_Type* CANx)
+{
+    uint8_t request = (uint8_t)(CAN0_DMA_REQUEST + (uint8_t)(CANx - CAN_Sim_regs));
+    int16_t ch = -1;
+
+    for(uint8_t idx = 0; (idx < CAN_DMA_CHANNEL_COUNT) && (ch < 0); idx++)
+    {
+        if((DMAMUX_CHCFG_ENBL_MASK | DMAMUX_CHCFG_SOURCE(request)) == CAN_Sim_dmamux.CHCFG[idx])
+        {
+            ch = (int16_t)idx;
+        }
+    }
+
+    while((ch >= 0) && (CANx->IFLAG1 & CAN_IFLAG1_BUF5I_MASK))
+    {
+        uint32_t buffer = (uint32_t)(uintptr_t)node->can_handle->rx_dma_buffer;
+        uint32_t buffer_bytes = (uint32_t)node->can_handle->rx_dma_frames * sizeof(CAN_DmaFrame_type);
+        uint32_t nbytes = CAN_Sim_dma.TCD[ch].NBYTES.MLNO;
+        uint32_t saddr = CAN_Sim_dma.TCD[ch].SADDR;
+        uint32_t daddr = CAN_Sim_dma.TCD[ch].DADDR;
+        uint32_t mloff = 0;
+        uint8_t smloe = 0;
+        uint8_t dmloe = 0;
+        uint16_t citer = (uint16_t)(CAN_Sim_dma.TCD[ch].CITER.ELINKNO - 1U);
+        uint16_t biter = CAN_Sim_dma.TCD[ch].BITER.ELINKNO;
+        uint16_t csr = CAN_Sim_dma.TCD[ch].CSR;
+
+        if(CAN_Sim_dma.CR & DMA_CR_EMLM_MASK)
+        {
+            smloe = (nbytes & DMA_TCD_NBYTES_MLOFFYES_SMLOE_MASK) ? 1U : 0U;
+            dmloe = (nbytes & DMA_TCD_NBYTES_MLOFFYES_DMLOE_MASK) ? 1U : 0U;
+            if(smloe || dmloe)
+            {
+                /* 20 bit signed offset */
+                mloff = (nbytes & DMA_TCD_NBYTES_MLOFFYES_MLOFF_MASK) >> DMA_TCD_NBYTES_MLOFFYES_MLOFF_SHIFT;
+                mloff |= (mloff & 0x80000U) ? 0xFFF00000U : 0U;
+                nbytes &= DMA_TCD_NBYTES_MLOFFYES_NBYTES_MASK;
+            }
+            else
+            {
+                nbytes &= DMA_TCD_NBYTES_MLOFFNO_NBYTES_MASK;
+            }
+        }
+
+        /* 32 bit transfers as set in ATTR */
+        for(uint32_t byte = 0; byte < nbytes; byte += 4U)
+        {
+            uint32_t word = CAN_Sim_DmaRead(CANx, saddr);
+            if((daddr - buffer) <= (buffer_bytes - 4U))
+            {
+                *(uint32_t*)((uint8_t*)node->can_handle->rx_dma_buffer + (daddr - buffer)) = word;
+            }
+            saddr += (uint32_t)(int32_t)(int16_t)CAN_Sim_dma.TCD[ch].SOFF;
+            daddr += (uint32_t)(int32_t)(int16_t)CAN_Sim_dma.TCD[ch].DOFF;
+        }
+        saddr += smloe ? mloff : 0U;
+        daddr += dmloe ? mloff : 0U;
+
+        if(0U == citer)
+        {
+            citer = biter;
+            saddr += CAN_Sim_dma.TCD[ch].SLAST;
+            daddr += CAN_Sim_dma.TCD[ch].DLASTSGA;
+            node->dma_irq |= (csr & DMA_TCD_CSR_INTMAJOR_MASK) ? 1U : 0U;
+        }
+        else if((biter / 2U) == citer)
+        {
+            node->dma_irq |= (csr & DMA_TCD_CSR_INTHALF_MASK) ? 1U : 0U;
+        }
+        else
+        {
+            /* DO NOTHING */
+        }
+        CAN_Sim_dma.TCD[ch].SADDR = saddr;
+        CAN_Sim_dma.TCD[ch].DADDR = daddr;
+        CAN_Sim_dma.TCD[ch].CITER.ELINKNO = citer;
+        CAN_Sim_ClearFlags(CANx, CAN_IFLAG1_BUF5I_MASK);
+    }
+}
+
+/* Matches frame against the format A ID filter table. Returns 0 on no match, 2 on FIFO overflow */
+static uint8_t CAN_Sim_StoreRxFifo(CAN_SimNode_type* node, CAN_Type* CANx, const CAN_SimFrame_type* frame, uint16_t timestamp)
+{
+    uint32_t rffn = (CANx->CTRL2 & CAN_CTRL2_RFFN_MASK) >> CAN_CTRL2_RFFN_SHIFT;
+    uint32_t num_filter = CAN_RX_FIFO_FILTER_PER_RFFN * (rffn + 1U);
+    uint32_t num_individual = 8U + (2U * rffn);
+    uint32_t element;
+    int16_t hit = -1;
+    uint8_t result = 0;
+
+    if(num_individual > CAN_SIM_RXIMR_COUNT)
+    {
+        num_individual = CAN_SIM_RXIMR_COUNT;
+    }
+    if(frame->cs & CAN_MB_CS_IDE_MASK)
+    {
+        element = CAN_RX_FIFO_ID_IDE_MASK | ((frame->id << CAN_RX_FIFO_ID_EXT_SHIFT) & CAN_RX_FIFO_ID_EXT_MASK);
+    }
+    else
+    {
+        element = ((frame->id >> CAN_WMBn_CS_STD_ID_SHIFT) << CAN_RX_FIFO_ID_STD_SHIFT) & CAN_RX_FIFO_ID_STD_MASK;
+    }
+    if(frame->cs & CAN_WMBn_CS_RTR_MASK)
+    {
+        element |= 0x80000000U;
+    }
+
+    for(uint32_t idx = 0; (idx < num_filter) && (hit < 0); idx++)
+    {
+        uint32_t mask = (idx < num_individual) ? CANx->RXIMR[idx] : CANx->RXFGMASK;
+        if(0U == ((CANx->RAMn[CAN_SIM_FIFO_FILTER_BASE + idx] ^ element) & mask))
+        {
+            hit = (int16_t)idx;
+        }
+    }
+
+    if(hit >= 0)
+    {
+        if(CAN_SIM_FIFO_DEPTH == node->fifo_count)
+        {
+            CANx->IFLAG1 |= CAN_IFLAG1_BUF7I_MASK;
+            result = 2;
+        }
+        else
+        {
+            uint8_t slot = node->fifo_count;
+            node->fifo[slot][0] = frame->cs | timestamp;
+            node->fifo[slot][1] = frame->id;
+            node->fifo[slot][2] = frame->data[0];
+            node->fifo[slot][3] = frame->data[1];
+            node->fifo_idhit[slot] = (uint16_t)hit;
+            node->fifo_count++;
+            if(node->fifo_count >= CAN_SIM_FIFO_WARNING)
+            {
+                CANx->IFLAG1 |= CAN_IFLAG1_BUF6I_MASK;
+            }
+            if(0U == (CANx->IFLAG1 & CAN_IFLAG1_BUF5I_MASK))
+            {
+                CAN_Sim_LoadFifoOutput(node, CANx);
+            }
+            if(CANx->MCR & CAN_MCR_DMA_MASK)
+            {
+                CAN_Sim_ServiceDma(node, CANx);
+            }
+            result = 1;
+        }
+    }
+
+    return result;
+}
+
+/* One PN comparison (CTRL1_PN[IDFS] / [PLFS] coding) */
+static uint8_t CAN_Sim_PnCompare(uint64_t value, uint64_t value1, uint64_t value2, uint32_t mode)
+{
+    uint8_t match;
+
+    switch(mode)
+    {
+    case PN_MATCH_EXACT:
+        match = (0U == ((value ^ value1) & value2));
+        break;
+    case PN_MATCH_GREATER_EQUAL:
+        match = (value >= value1);
+        break;
+    case PN_MATCH_SMALLER_EQUAL:
+        match = (value <= value1);
+        break;
+    default:
+        match = (value >= value1) && (value <= value2);
+        break;
+    }
+
+    return match;
+}
+
+/* Stop mode with MCR[PNET_EN]: frames only go through the wake-up filter into the WMBs */
+static void CAN_Sim_PnFilter(CAN_SimNode_type* node, CAN_Type* CANx, const CAN_SimFrame_type* frame)
+{
+    uint32_t ctrl1_pn = CANx->CTRL1_PN;
+    uint32_t fcs = (ctrl1_pn & CAN_CTRL1_PN_FCS_MASK) >> CAN_CTRL1_PN_FCS_SHIFT;
+    uint32_t id_mode = (ctrl1_pn & CAN_CTRL1_PN_IDFS_MASK) >> CAN_CTRL1_PN_IDFS_SHIFT;
+    uint32_t flt_id1 = CANx->FLT_ID1;
+    uint32_t flt_id2 = CANx->FLT_ID2_IDMASK;
+    uint8_t ide = (0U != (frame->cs & CAN_MB_CS_IDE_MASK));
+    uint8_t rtr = (0U != (frame->cs & CAN_WMBn_CS_RTR_MASK));
+    uint8_t match;
+
+    if(PN_MATCH_EXACT == id_mode)
+    {
+        match = CAN_Sim_PnCompare(frame->id & CAN_FLT_ID1_FLT_ID1_MASK, flt_id1 & CAN_FLT_ID1_FLT_ID1_MASK,
+                                  flt_id2 & CAN_FLT_ID2_IDMASK_FLT_ID2_IDMASK_MASK, id_mode)
+             && (!(flt_id2 & CAN_FLT_ID2_IDMASK_IDE_MSK_MASK) || (ide == (0U != (flt_id1 & CAN_FLT_ID1_FLT_IDE_MASK))))
+             && (!(flt_id2 & CAN_FLT_ID2_IDMASK_RTR_MSK_MASK) || (rtr == (0U != (flt_id1 & CAN_FLT_ID1_FLT_RTR_MASK))));
+    }
+    else
+    {
+        match = CAN_Sim_PnCompare(frame->id & CAN_FLT_ID1_FLT_ID1_MASK, flt_id1 & CAN_FLT_ID1_FLT_ID1_MASK,
+                                  flt_id2 & CAN_FLT_ID2_IDMASK_FLT_ID2_IDMASK_MASK, id_mode)
+             && (ide == (0U != (flt_id1 & CAN_FLT_ID1_FLT_IDE_MASK))) && (rtr == (0U != (flt_id1 & CAN_FLT_ID1_FLT_RTR_MASK)));
+    }
+
+    if(match && ((PN_ID_AND_PAYLOAD == fcs) || (PN_ID_AND_PAYLOAD_NMATCH == fcs)))
+    {
+        uint32_t dlc = (frame->cs & CAN_MB_CS_DLC_MASK) >> CAN_MB_CS_DLC_SHIFT;
+        uint64_t payload = ((uint64_t)frame->data[0] << 32) | frame->data[1];
+        uint64_t payload1 = ((uint64_t)CANx->PL1_LO << 32) | CANx->PL1_HI;
+        uint64_t payload2 = ((uint64_t)CANx->PL2_PLMASK_LO << 32) | CANx->PL2_PLMASK_HI;
+        match = (dlc >= ((CANx->FLT_DLC & CAN_FLT_DLC_FLT_DLC_LO_MASK) >> CAN_FLT_DLC_FLT_DLC_LO_SHIFT))
+             && (dlc <= ((CANx->FLT_DLC & CAN_FLT_DLC_FLT_DLC_HI_MASK) >> CAN_FLT_DLC_FLT_DLC_HI_SHIFT))
+             && CAN_Sim_PnCompare(payload, payload1, payload2, (ctrl1_pn & CAN_CTRL1_PN_PLFS_MASK) >> CAN_CTRL1_PN_PLFS_SHIFT);
+    }
+
+    if(match)
+    {
+        uint32_t count = (CANx->WU_MTC & CAN_WU_MTC_MCOUNTER_MASK) >> CAN_WU_MTC_MCOUNTER_SHIFT;
+        if(count < CAN_WMB_COUNT)
+        {
+            volatile uint32_t* wmb = (volatile uint32_t*)&CANx->WMB[count];
+            wmb[0] = frame->cs & CAN_SIM_CS_FRAME_MASK;
+            wmb[1] = frame->id & CAN_WMBn_ID_ID_MASK;
+            wmb[2] = frame->data[0];
+            wmb[3] = frame->data[1];
+        }
+        if(count < 0xFFU)
+        {
+            count++;
+        }
+        CANx->WU_MTC = (CANx->WU_MTC & ~CAN_WU_MTC_MCOUNTER_MASK) | CAN_WU_MTC_MCOUNTER(count);
+        if((fcs < PN_ID_ONLY_NMATCH) || (count >= ((ctrl1_pn & CAN_CTRL1_PN_NMATCH_MASK) >> CAN_CTRL1_PN_NMATCH_SHIFT)))
+        {
+            /* Wake-up: the MCU leaves Stop mode and the controller rejoins the bus */
+            CANx->WU_MTC |= CAN_WU_MTC_WUMF_MASK;
+            node->pn_stop = 0;
+        }
+    }
+}
+
+/* Advances the bus time by one frame and hands the frame to every receiver on the bus */
+static void CAN_Sim_Transfer(const CAN_SimFrame_type* frame, uint64_t duration_ps, const CAN_SimNode_type* sender)
+{
+    uint8_t sender_loopback = (NULL != sender) && (sender->can_handle->can_instance->CTRL1 & CAN_CTRL1_LPB_MASK);
+
+    CAN_sim_time_ps += duration_ps;
+    CAN_sim_busy_ps += duration_ps;
+    CAN_sim_stats.frames++;
+
+    for(uint8_t idx = 0; idx < CAN_sim_num_nodes; idx++)
+    {
+        CAN_SimNode_type* node = &CAN_sim_nodes[idx];
+        CAN_Type* CANx = node->can_handle->can_instance;
+        uint8_t loopback = (0U != (CANx->CTRL1 & CAN_CTRL1_LPB_MASK));
+        uint8_t receives;
+
+        if(node->pn_stop)
+        {
+            CAN_Sim_PnFilter(node, CANx, frame);
+            continue;
+        }
+        if(!CAN_Sim_OnBus(CANx))
+        {
+            continue;
+        }
+
+        /* Free-running timer counts nominal bits */
+        uint64_t bit_ps = CAN_Sim_BitTimePs(CANx, 0U);
+        CANx->TIMER = (uint32_t)((CANx->TIMER + ((0U != bit_ps) ? (duration_ps / bit_ps) : 0U)) & 0xFFFFU);
+
+        if(node == sender)
+        {
+            receives = (0U == (CANx->MCR & CAN_MCR_SRXDIS_MASK));
+        }
+        else
+        {
+            /* Loop back mode nodes are cut off the bus in both directions */
+            receives = !loopback && !sender_loopback;
+        }
+        if(receives && (frame->cs & CAN_MB_CS_EDL_MASK) && (0U == (CANx->MCR & CAN_MCR_FDEN_MASK)))
+        {
+            /* A CAN 2.0 node flags FD frames as form errors */
+            receives = 0;
+        }
+
+        if(receives && (node != sender) && (frame->cs & CAN_WMBn_CS_RTR_MASK)
+        && (0U == (CANx->CTRL2 & CAN_CTRL2_RRS_MASK)))
+        {
+            /* Remote request handled by the remote answer MBs, never stored */
+            (void)CAN_Sim_RemoteAnswer(CANx, frame);
+            receives = 0;
+        }
+
+        if(receives)
+        {
+            uint8_t stored;
+            if(CANx->MCR & CAN_MCR_RFEN_MASK)
+            {
+                stored = CAN_Sim_StoreRxFifo(node, CANx, frame, (uint16_t)CANx->TIMER);
+                if(0U == stored)
+                {
+                    /* Frames missing the FIFO filter still reach the MBs behind the table */
+                    stored = CAN_Sim_StoreMsgBuff(CANx, frame, (uint16_t)CANx->TIMER);
+                }
+            }
+            else
+            {
+                stored = CAN_Sim_StoreMsgBuff(CANx, frame, (uint16_t)CANx->TIMER);
+            }
+
+            if(1U == stored)
+            {
+                CAN_sim_stats.rx_stored++;
+            }
+            else if(2U == stored)
+            {
+                CAN_sim_stats.rx_lost++;
+            }
+            else
+            {
+                /* DO NOTHING */
+            }
+        }
+    }
+}
+
+/* The model works on the registers inside a driver call, the hardware would see accesses of it */
+static void CAN_Sim_ModelEnter(uint32_t accesses)
+{
+    if(NULL != CAN_sim_model_hook)
+    {
+        CAN_sim_model_hook(1U, accesses);
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+}
+
+static void CAN_Sim_ModelExit(void)
+{
+    if(NULL != CAN_sim_model_hook)
+    {
+        CAN_sim_model_hook(0U, 0U);
+    }
+    else
+    {
+        /* DO NOTHING */
+    }
+}
+
+/* Calls the interrupt handlers of every node with an enabled flag set. Inside a critical section the
+   flags stay pending until a later step */
+static void CAN_Sim_RaiseIrqs(void)
+{
+    if(0U != CAN_sim_irq_lock)
+    {
+        return;
+    }
+
+    for(uint8_t idx = 0; idx < CAN_sim_num_nodes; idx++)
+    {
+        CAN_Type* CANx = CAN_sim_nodes[idx].can_handle->can_instance;
+        uint32_t esr1_enabled = ((CANx->CTRL1 & CAN_CTRL1_BOFFMSK_MASK) ? CAN_ESR1_BOFFINT_MASK : 0U)
+                              | ((CANx->CTRL1 & CAN_CTRL1_ERRMSK_MASK) ? CAN_ESR1_ERRINT_MASK : 0U)
+                              | ((CANx->CTRL2 & CAN_CTRL2_BOFFDONEMSK_MASK) ? CAN_ESR1_BOFFDONEINT_MASK : 0U);
+        if(CANx->ESR1 & esr1_enabled)
+        {
+            CAN_ErrorIRQHandler(CAN_sim_nodes[idx].can_handle);
+        }
+        if(CANx->IFLAG1 & CANx->IMASK1)
+        {
+            CAN_IRQHandler(CAN_sim_nodes[idx].can_handle);
+        }
+        if((CANx->WU_MTC & CAN_WU_MTC_WUMF_MASK) && (CANx->CTRL1_PN & CAN_CTRL1_PN_WUMF_MSK_MASK))
+        {
+            CAN_PnWakeUpIRQHandler(CAN_sim_nodes[idx].can_handle);
+        }
+        if(CAN_sim_nodes[idx].dma_irq)
+        {
+            CAN_sim_nodes[idx].dma_irq = 0;
+            CAN_DmaIRQHandler(CAN_sim_nodes[idx].can_handle);
+        }
+    }
+}
+
+/* Ends the automatic bus off recoveries due by now, returns 1 if one ended. The protocol engine is halted in
+   freeze mode, so a frozen controller does not end its recovery */
+static uint8_t CAN_Sim_RecoverBusOff(void)
+{
+    uint8_t recovered = 0;
+
+    for(uint8_t idx = 0; idx < CAN_sim_num_nodes; idx++)
+    {
+        CAN_SimNode_type* node = &CAN_sim_nodes[idx];
+        CAN_Type* CANx = node->can_handle->can_instance;
+        if((0U != node->busoff_until_ps) && (node->busoff_until_ps <= CAN_sim_time_ps)
+        && (0U == (CANx->MCR & CAN_MCR_FRZACK_MASK)))
+        {
+            node->busoff_until_ps = 0;
+            CANx->ECR = 0;
+            CANx->ESR1 = (CANx->ESR1 & ~CAN_ESR1_FLTCONF_MASK) | CAN_ESR1_BOFFDONEINT_MASK;
+            recovered = 1;
+        }
+    }
+
+    return recovered;
+}
+
+void CAN_Sim_ResetRegs(CAN_Type* can_instance)
+{
+    CAN_SimNode_type* node = CAN_Sim_FindNode(can_instance);
+
+    memset((void*)can_instance, 0, sizeof(CAN_Type));
+    can_instance->MCR = CAN_SIM_MCR_RESET;
+    can_instance->RXMGMASK = 0xFFFFFFFFU;
+    can_instance->RX14MASK = 0xFFFFFFFFU;
+    can_instance->RX15MASK = 0xFFFFFFFFU;
+    can_instance->RXFGMASK = 0xFFFFFFFFU;
+    if(NULL != node)
+    {
+        node->fifo_count = 0;
+        node->tx_seen_map = 0;
+        node->busoff_until_ps = 0;
+        node->dma_irq = 0;
+        node->pn_stop = 0;
+    }
+}
+
+void CAN_Sim_Reset(void)
+{
+    CAN_sim_num_nodes = 0;
+    for(uint8_t idx = 0; idx < CAN_INSTANCE_COUNT; idx++)
+    {
+        CAN_Sim_ResetRegs(&CAN_Sim_regs[idx]);
+    }
+    memset(&CAN_Sim_dma, 0, sizeof(CAN_Sim_dma));
+    memset(&CAN_Sim_dmamux, 0, sizeof(CAN_Sim_dmamux));
+    CAN_sim_time_ps = 0;
+    CAN_sim_busy_ps = 0;
+    memset(&CAN_sim_stats, 0, sizeof(CAN_sim_stats));
+}
+
+Std_CAN_Status CAN_Sim_Attach(CAN_Handle_type* can_handle)
+{
+    Std_CAN_Status status = CAN_E_OK;
+
+    if((NULL == can_handle) || (CAN_sim_num_nodes >= CAN_SIM_MAX_NODES))
+    {
+        status = CAN_E_NOT_OK;
+    }
+    else if(NULL == CAN_Sim_FindNode(can_handle->can_instance))
+    {
+        CAN_SimNode_type* node = &CAN_sim_nodes[CAN_sim_num_nodes];
+        memset(node, 0, sizeof(*node));
+        node->can_handle = can_handle;
+        CAN_sim_num_nodes++;
+    }
+    else
+    {
+        /* Already attached */
+    }
+
+    return status;
+}
+
+void CAN_Sim_Poll(CAN_Type* can_instance)
+{
+    /* The hardware works on its own meanwhile, none of it is a driver access */
+    CAN_Sim_ModelEnter(0U);
+    CAN_Sim_Acknowledge(can_instance);
+    (void)CAN_Sim_Step();
+    CAN_Sim_ModelExit();
+}
+
+void CAN_Sim_ClearFlags(CAN_Type* can_instance, uint32_t mask)
+{
+    /* One IFLAG1 write on the hardware, however the model carries it out */
+    CAN_Sim_ModelEnter(1U);
+    CAN_SimNode_type* node = CAN_Sim_FindNode(can_instance);
+    uint32_t popped = can_instance->IFLAG1 & mask & CAN_IFLAG1_BUF5I_MASK;
+
+    can_instance->IFLAG1 &= ~mask;
+
+    /* Acknowledging BUF5I pops the output frame and shows the next one */
+    if((NULL != node) && (0U != popped) && (can_instance->MCR & CAN_MCR_RFEN_MASK) && (node->fifo_count > 0U))
+    {
+        for(uint8_t idx = 1; idx < node->fifo_count; idx++)
+        {
+            memcpy(node->fifo[idx - 1U], node->fifo[idx], sizeof(node->fifo[0]));
+            node->fifo_idhit[idx - 1U] = node->fifo_idhit[idx];
+        }
+        node->fifo_count--;
+        if(node->fifo_count > 0U)
+        {
+            CAN_Sim_LoadFifoOutput(node, can_instance);
+        }
+    }
+    CAN_Sim_ModelExit();
+}
+
+void CAN_Sim_SetModelHook(CAN_Sim_ModelHook_type hook)
+{
+    CAN_sim_model_hook = hook;
+}
+
+uint32_t CAN_Sim_CriticalEnter(void)
+{
+    return CAN_sim_irq_lock++;
+}
+
+void CAN_Sim_CriticalExit(uint32_t primask)
+{
+    CAN_sim_irq_lock = primask;
+}
+
+uint8_t CAN_Sim_Step(void)
+{
+    uint8_t progress = 0;
+    CAN_SimNode_type* winner = NULL;
+    uint8_t winner_mb = 0;
+    uint64_t winner_key = 0;
+
+    if(CAN_sim_in_step)
+    {
+        return 0;
+    }
+    CAN_sim_in_step = 1;
+
+    if(CAN_Sim_RecoverBusOff())
+    {
+        CAN_Sim_RaiseIrqs();
+    }
+
+    /* Aborts requested while the bus was idle complete at once: CODE stays ABORT and the IFLAG is set */
+    uint8_t aborted = 0;
+    for(uint8_t idx = 0; idx < CAN_sim_num_nodes; idx++)
+    {
+        CAN_Type* CANx = CAN_sim_nodes[idx].can_handle->can_instance;
+        uint8_t num_msg_buff = CAN_Sim_NumMsgBuff(CANx);
+        if(0U == (CANx->MCR & CAN_MCR_AEN_MASK))
+        {
+            continue;
+        }
+        for(uint8_t idx_mb = CAN_Sim_FirstMsgBuff(CANx); idx_mb < num_msg_buff; idx_mb++)
+        {
+            uint32_t base = 0;
+            uint32_t mb_mask = (uint32_t)(1UL << idx_mb);
+            (void)CAN_Sim_MsgBuffLayout(CANx, idx_mb, &base);
+            if((CAN_MB_CODE_TX_ABORT == ((CANx->RAMn[base] & CAN_MB_CS_CODE_MASK) >> CAN_MB_CS_CODE_SHIFT))
+            && (0U == (CANx->IFLAG1 & mb_mask)))
+            {
+                CANx->IFLAG1 |= mb_mask;
+                CAN_sim_nodes[idx].tx_seen_map &= ~mb_mask;
+                aborted = 1;
+            }
+        }
+    }
+    if(aborted)
+    {
+        CAN_Sim_RaiseIrqs();
+    }
+
+    for(uint8_t idx = 0; idx < CAN_sim_num_nodes; idx++)
+    {
+        CAN_SimNode_type* node = &CAN_sim_nodes[idx];
+        CAN_Type* CANx = node->can_handle->can_instance;
+        uint8_t num_msg_buff;
+        uint8_t lowest_buff_first;
+        uint8_t local_prio;
+
+        CAN_Sim_Acknowledge(CANx);
+        if(node->pn_stop || !CAN_Sim_OnBus(CANx) || (CANx->CTRL1 & CAN_CTRL1_LOM_MASK))
+        {
+            continue;
+        }
+        num_msg_buff = CAN_Sim_NumMsgBuff(CANx);
+        lowest_buff_first = (0U != (CANx->CTRL1 & CAN_CTRL1_LBUF_MASK));
+        local_prio = (0U != (CANx->MCR & CAN_MCR_LPRIOEN_MASK));
+
+        /* Internal arbitration: lowest PRIO (MCR[LPRIO_EN]) and ID, or lowest MB number with CTRL1[LBUF] */
+        CAN_SimNode_type* node_winner = NULL;
+        uint8_t node_mb = 0;
+        uint64_t node_key = 0;
+        uint64_t node_local_key = 0;
+        for(uint8_t idx_mb = CAN_Sim_FirstMsgBuff(CANx); idx_mb < num_msg_buff; idx_mb++)
+        {
+            uint32_t base = 0;
+            (void)CAN_Sim_MsgBuffLayout(CANx, idx_mb, &base);
+            uint32_t cs = CANx->RAMn[base];
+            uint32_t mb_mask = (uint32_t)(1UL << idx_mb);
+            CAN_SimFrame_type frame;
+
+            if((CAN_MB_CODE_TX_DATA != ((cs & CAN_MB_CS_CODE_MASK) >> CAN_MB_CS_CODE_SHIFT))
+            && (CAN_SIM_MB_CODE_TANSWER != ((cs & CAN_MB_CS_CODE_MASK) >> CAN_MB_CS_CODE_SHIFT)))
+            {
+                node->tx_seen_map &= ~mb_mask;
+                continue;
+            }
+            if(0U == (node->tx_seen_map & mb_mask))
+            {
+                node->tx_seen_map |= mb_mask;
+                node->tx_since_ps[idx_mb] = CAN_sim_time_ps;
+            }
+            frame.cs = cs & CAN_SIM_CS_FRAME_MASK;
+            frame.id = CANx->RAMn[base + 1U];
+            uint64_t key = CAN_Sim_ArbitrationKey(&frame);
+            uint64_t local_key = key;
+            if(local_prio)
+            {
+                local_key |= (uint64_t)(frame.id >> CAN_MB_ID_PRIO_SHIFT) << 32;
+            }
+            if((NULL == node_winner) || (!lowest_buff_first && (local_key < node_local_key)))
+            {
+                node_winner = node;
+                node_mb = idx_mb;
+                node_key = key;
+                node_local_key = local_key;
+            }
+        }
+
+        if((NULL != node_winner) && ((NULL == winner) || (node_key < winner_key)))
+        {
+            winner = node_winner;
+            winner_mb = node_mb;
+            winner_key = node_key;
+        }
+    }
+
+    if(NULL != winner)
+    {
+        CAN_Type* CANx = winner->can_handle->can_instance;
+        uint32_t base = 0;
+        CAN_SimFrame_type frame;
+
+        (void)CAN_Sim_MsgBuffLayout(CANx, winner_mb, &base);
+
+        CAN_Sim_ReadTxMsgBuff(CANx, winner_mb, &frame);
+        CAN_Sim_Transfer(&frame, CAN_Sim_FrameTimePs(CANx, &frame), winner);
+
+        /* Tx complete: MB goes inactive with the frame timestamp, a remote answer waits for the next request */
+        uint32_t done_code = (CAN_SIM_MB_CODE_TANSWER == ((CANx->RAMn[base] & CAN_MB_CS_CODE_MASK) >> CAN_MB_CS_CODE_SHIFT))
+                           ? CAN_SIM_MB_CODE_RANSWER : CAN_MB_CODE_TX_INACTIVE;
+        CANx->RAMn[base] = (CANx->RAMn[base] & ~(CAN_MB_CS_CODE_MASK | CAN_MB_CS_TIMESTAMP_MASK))
+                         | (done_code << CAN_MB_CS_CODE_SHIFT)
+                         | (CANx->TIMER & CAN_MB_CS_TIMESTAMP_MASK);
+        CANx->IFLAG1 |= (uint32_t)(1UL << winner_mb);
+        winner->tx_seen_map &= ~(uint32_t)(1UL << winner_mb);
+
+        uint64_t latency_ns = (CAN_sim_time_ps - winner->tx_since_ps[winner_mb]) / 1000U;
+        CAN_sim_stats.tx_completed++;
+        CAN_sim_stats.latency_sum_ns += latency_ns;
+        if(latency_ns > CAN_sim_stats.latency_max_ns)
+        {
+            CAN_sim_stats.latency_max_ns = latency_ns;
+        }
+
+        CAN_Sim_RaiseIrqs();
+    }
+    else
+    {
+        /* Idle bus: let the earliest bus off recovery run to its end */
+        uint64_t until_ps = 0;
+        for(uint8_t idx = 0; idx < CAN_sim_num_nodes; idx++)
+        {
+            uint64_t node_until_ps = CAN_sim_nodes[idx].busoff_until_ps;
+            uint8_t frozen = (0U != (CAN_sim_nodes[idx].can_handle->can_instance->MCR & CAN_MCR_FRZACK_MASK));
+            if((0U != node_until_ps) && !frozen && ((0U == until_ps) || (node_until_ps < until_ps)))
+            {
+                until_ps = node_until_ps;
+            }
+        }
+        if(0U != until_ps)
+        {
+            CAN_sim_time_ps = until_ps;
+            (void)CAN_Sim_RecoverBusOff();
+            CAN_Sim_RaiseIrqs();
+            progress = 1;
+        }
+    }
+
+    CAN_sim_in_step = 0;
+    return (NULL != winner) || progress;
+}
+
+uint32_t CAN_Sim_Run(uint32_t max_frames)
+{
+    uint32_t num_frames = 0;
+    while((num_frames < max_frames) && CAN_Sim_Step())
+    {
+        num_frames++;
+    }
+
+    return num_frames;
+}
+
+Std_CAN_Status CAN_Sim_Inject(const CAN_Frame_type* frame, uint32_t cs_flags)
+{
+    Std_CAN_Status status = CAN_E_NOT_OK;
+    CAN_SimFrame_type sim_frame;
+    uint8_t length = CAN_sim_dlc_length_arr[frame->dlc & 0xFU];
+
+    sim_frame.cs = (cs_flags & (CAN_MB_CS_EDL_MASK | CAN_MB_CS_BRS_MASK | CAN_MB_CS_IDE_MASK))
+                 | ((uint32_t)(frame->dlc & 0xFU) << CAN_MB_CS_DLC_SHIFT);
+    if(cs_flags & CAN_MB_CS_IDE_MASK)
+    {
+        sim_frame.cs |= CAN_WMBn_CS_SRR_MASK;
+        sim_frame.id = frame->id & CAN_MB_ID_EXT_MASK;
+    }
+    else
+    {
+        sim_frame.id = (frame->id << CAN_WMBn_CS_STD_ID_SHIFT) & CAN_MB_ID_STD_MASK;
+    }
+    memset(sim_frame.data, 0, sizeof(sim_frame.data));
+    for(uint8_t idx = 0; idx < length; idx++)
+    {
+        sim_frame.data[idx / 4U] |= (uint32_t)frame->data[idx] << (24U - (8U * (idx % 4U)));
+    }
+
+    /* The external node uses the bit timing of the first controller on the bus */
+    for(uint8_t idx = 0; (idx < CAN_sim_num_nodes) && (CAN_E_OK != status); idx++)
+    {
+        CAN_Type* CANx = CAN_sim_nodes[idx].can_handle->can_instance;
+        CAN_Sim_Acknowledge(CANx);
+        if(CAN_Sim_OnBus(CANx) && !CAN_sim_in_step)
+        {
+            CAN_sim_in_step = 1;
+            CAN_Sim_Transfer(&sim_frame, CAN_Sim_FrameTimePs(CANx, &sim_frame), NULL);
+            CAN_Sim_RaiseIrqs();
+            CAN_sim_in_step = 0;
+            status = CAN_E_OK;
+        }
+    }
+
+    return status;
+}
+
+Std_CAN_Status CAN_Sim_EnterStop(CAN_Type* can_instance)
+{
+    Std_CAN_Status status = CAN_E_NOT_OK;
+    CAN_SimNode_type* node = CAN_Sim_FindNode(can_instance);
+
+    if((NULL != node) && (can_instance->MCR & CAN_MCR_PNET_EN_MASK))
+    {
+        can_instance->WU_MTC &= ~CAN_WU_MTC_MCOUNTER_MASK;
+        node->pn_stop = 1;
+        status = CAN_E_OK;
+    }
+
+    return status;
+}
+
+Std_CAN_Status CAN_Sim_BusOff(CAN_Type* can_instance)
+{
+    Std_CAN_Status status = CAN_E_NOT_OK;
+    CAN_SimNode_type* node = CAN_Sim_FindNode(can_instance);
+
+    if(NULL != node)
+    {
+        /* TXERRCNT passed 255: bus off until 128 x 11 recessive bits were seen */
+        can_instance->ECR = (can_instance->ECR & ~CAN_ECR_TXERRCNT_MASK) | CAN_ECR_TXERRCNT(0xFFU);
+        can_instance->ESR1 = (can_instance->ESR1 & ~CAN_ESR1_FLTCONF_MASK) | CAN_SIM_ESR1_BUS_OFF
+                           | CAN_ESR1_BOFFINT_MASK | CAN_ESR1_ERRINT_MASK | CAN_ESR1_BIT0ERR_MASK;
+        node->busoff_until_ps = CAN_sim_time_ps + (CAN_SIM_BUS_OFF_BITS * CAN_Sim_BitTimePs(can_instance, 0U));
+        if(0U == CAN_sim_in_step)
+        {
+            CAN_sim_in_step = 1;
+            CAN_Sim_RaiseIrqs();
+            CAN_sim_in_step = 0;
+        }
+        status = CAN_E_OK;
+    }
+
+    return status;
+}
+
+void CAN_Sim_GetStats(CAN_Sim_Stats_type* stats)
+{
+    *stats = CAN_sim_stats;
+    stats->time_ns = CAN_sim_time_ps / 1000U;
+    stats->busy_ns = CAN_sim_busy_ps / 1000U;
+}
+
+Std_CAN_Status CAN_Sim_Benchmark(CAN_Handle_type* tx_handle, CAN_Handle_type* rx_handle, uint32_t id,
+                                 uint8_t length, uint32_t num_frames, CAN_Sim_Bench_type* result)
+{
+    static CAN_Frame_type rx_frames[CAN_RX_RING_SIZE];
+    uint8_t data[CAN_MAX_PAYLOAD_BYTES] = {0};
+    CAN_Sim_Stats_type before;
+    CAN_Sim_Stats_type after;
+    uint32_t sent = 0;
+    uint32_t received = 0;
+    uint8_t progress = 1;
+    clock_t start;
+    clock_t end;
+
+    CAN_Sim_GetStats(&before);
+    start = clock();
+    while(progress && (received < num_frames))
+    {
+        progress = 0;
+        while(sent < num_frames)
+        {
+            data[0] = (uint8_t)sent;
+            data[1] = (uint8_t)(sent >> 8);
+            if(CAN_E_OK != CAN_Transmit(tx_handle, id, data, length))
+            {
+                break;
+            }
+            sent++;
+            progress = 1;
+        }
+        if(CAN_Sim_Step())
+        {
+            progress = 1;
+        }
+        received += CAN_ReceiveBatch(rx_handle, rx_frames, CAN_RX_RING_SIZE);
+    }
+    end = clock();
+    CAN_Sim_GetStats(&after);
+
+    uint32_t completed = after.tx_completed - before.tx_completed;
+    result->frames_sent = sent;
+    result->frames_received = received;
+    result->bus_time_ns = after.time_ns - before.time_ns;
+    result->frames_per_second = (0U != result->bus_time_ns)
+                              ? (uint32_t)(((uint64_t)(after.frames - before.frames) * 1000000000U) / result->bus_time_ns) : 0U;
+    result->avg_latency_ns = (0U != completed) ? ((after.latency_sum_ns - before.latency_sum_ns) / completed) : 0U;
+    result->max_latency_ns = after.latency_max_ns;
+    result->host_ns_per_frame = (0U != received)
+                              ? (uint64_t)(((double)(end - start) * 1e9) / ((double)CLOCKS_PER_SEC * received)) : 0U;
+
+    return (received == num_frames) ? CAN_E_OK : CAN_E_NOT_OK;
+}
+
+Std_CAN_Status CAN_Sim_IsoTpBenchmark(CAN_IsoTp_type* isotp, uint8_t tx_channel, uint8_t rx_channel,
+                                      const uint8_t* data, uint32_t length, CAN_Sim_IsoTpBench_type* result)
+{
+    static CAN_Frame_type rx_frames[CAN_RX_RING_SIZE];
+    CAN_IsoTp_Channel_type* rx = &isotp->channels[rx_channel];
+    CAN_IsoTp_Channel_type* tx = &isotp->channels[tx_channel];
+    CAN_Sim_Stats_type before;
+    CAN_Sim_Stats_type after;
+    uint8_t progress = 1;
+    clock_t start;
+    clock_t end;
+
+    CAN_Sim_GetStats(&before);
+    start = clock();
+    CAN_IsoTp_MainFunction(isotp, (uint32_t)(before.time_ns / 1000U));
+    rx->rx_result = ISOTP_BUSY;
+    if(CAN_E_OK != CAN_IsoTp_Send(isotp, tx_channel, data, length))
+    {
+        return CAN_E_NOT_OK;
+    }
+    while(progress && ((ISOTP_BUSY == tx->tx_result) || (ISOTP_BUSY == rx->rx_result)))
+    {
+        uint16_t num_rx;
+        progress = CAN_Sim_Step();
+        num_rx = CAN_ReceiveBatch(isotp->can_handle, rx_frames, CAN_RX_RING_SIZE);
+        for(uint16_t idx = 0; idx < num_rx; idx++)
+        {
+            (void)CAN_IsoTp_RxIndication(isotp, &rx_frames[idx]);
+        }
+        CAN_IsoTp_MainFunction(isotp, (uint32_t)(CAN_sim_time_ps / 1000000U));
+        if(0U != num_rx)
+        {
+            progress = 1;
+        }
+        else if(!progress && (ISOTP_BUSY == tx->tx_result))
+        {
+            /* Idle bus while the sender waits for STmin or flow control: skip to its deadline */
+            int32_t wait_us = (int32_t)(tx->tx_deadline_us - (uint32_t)(CAN_sim_time_ps / 1000000U));
+            if(wait_us > 0)
+            {
+                CAN_sim_time_ps += (uint64_t)wait_us * 1000000U;
+                CAN_IsoTp_MainFunction(isotp, tx->tx_deadline_us);
+                progress = 1;
+            }
+        }
+        else
+        {
+            /* DO NOTHING */
+        }
+    }
+    end = clock();
+    CAN_Sim_GetStats(&after);
+
+    result->bytes = (ISOTP_OK == rx->rx_result) ? rx->rx_length : 0U;
+    result->frames = after.frames - before.frames;
+    result->bus_time_ns = after.time_ns - before.time_ns;
+    result->bytes_per_second = (0U != result->bus_time_ns)
+                             ? (uint32_t)(((uint64_t)result->bytes * 1000000000U) / result->bus_time_ns) : 0U;
+    result->host_ns_per_frame = (0U != result->frames)
+                              ? (uint64_t)(((double)(end - start) * 1e9) / ((double)CLOCKS_PER_SEC * result->frames)) : 0U;
+
+    return ((ISOTP_OK == rx->rx_result) && (length == rx->rx_length) && (0 == memcmp(rx->config->rx_buffer, data, length)))
+         ? CAN_E_OK : CAN_E_NOT_OK;
+}
+
+/* Reference decoder: gathers a signal bit by bit from the payload bytes, the way hand written code does */
+static uint32_t CAN_Sim_DecodeBitwise(const CAN_SignalDesc_type* desc, const uint8_t* data)
+{
+    uint32_t value = 0;
+    uint16_t bit = desc->start_bit;
+
+    for(uint8_t idx = 0; idx < desc->length; idx++)
+    {
+        uint32_t bit_value = (data[bit / 8U] >> (bit % 8U)) & 1U;
+        if(CAN_SIGNAL_INTEL == desc->byte_order)
+        {
+            value |= bit_value << idx;
+            bit++;
+        }
+        else
+        {
+            /* Motorola: MSB first, moving to bit 7 of the next byte after bit 0 */
+            value = (value << 1) | bit_value;
+            bit = (0U == (bit % 8U)) ? (uint16_t)(bit + 15U) : (uint16_t)(bit - 1U);
+        }
+    }
+    if(desc->is_signed && (desc->length < 32U))
+    {
+        uint8_t sign_shift = (uint8_t)(32U - desc->length);
+        value = (uint32_t)((int32_t)(value << sign_shift) >> sign_shift);
+    }
+
+    return value;
+}
+
+Std_CAN_Status CAN_Sim_CodecBenchmark(const CAN_MessageDesc_type* message, uint32_t num_frames,
+                                      CAN_Sim_CodecBench_type* result)
+{
+    static CAN_CodecPlan_type plan;
+    static uint8_t payloads[64][CAN_MAX_PAYLOAD_BYTES];
+    uint32_t reference[CAN_CODEC_MAX_SIGNALS];
+    uint32_t raw[CAN_CODEC_MAX_SIGNALS];
+    uint32_t words[CAN_CODEC_MAX_WORDS];
+    volatile uint32_t sink = 0;
+    uint32_t seed = 0x12345678U;
+    clock_t start;
+
+    memset(result, 0, sizeof(*result));
+    if(CAN_E_OK != CAN_Codec_Compile(message, &plan))
+    {
+        return CAN_E_NOT_OK;
+    }
+    for(uint8_t frame = 0; frame < 64U; frame++)
+    {
+        for(uint8_t byte = 0; byte < CAN_MAX_PAYLOAD_BYTES; byte++)
+        {
+            seed = (seed * 1103515245U) + 12345U;
+            payloads[frame][byte] = (uint8_t)(seed >> 16);
+        }
+    }
+
+    start = clock();
+    for(uint32_t frame = 0; frame < num_frames; frame++)
+    {
+        for(uint8_t idx = 0; idx < message->num_signals; idx++)
+        {
+            sink += CAN_Sim_DecodeBitwise(&message->signals[idx], payloads[frame % 64U]);
+        }
+    }
+    result->bitwise_ns = (uint64_t)(((double)(clock() - start) * 1e9) / ((double)CLOCKS_PER_SEC * num_frames));
+
+    start = clock();
+    for(uint32_t frame = 0; frame < num_frames; frame++)
+    {
+        CAN_Codec_LoadWords(payloads[frame % 64U], message->length, words);
+        CAN_Codec_UnpackRaw(&plan, words, raw);
+        sink += raw[frame % message->num_signals];
+    }
+    result->compiled_ns = (uint64_t)(((double)(clock() - start) * 1e9) / ((double)CLOCKS_PER_SEC * num_frames));
+    result->frames = num_frames;
+
+    for(uint8_t frame = 0; frame < 64U; frame++)
+    {
+        CAN_Codec_LoadWords(payloads[frame], message->length, words);
+        CAN_Codec_UnpackRaw(&plan, words, raw);
+        for(uint8_t idx = 0; idx < message->num_signals; idx++)
+        {
+            reference[idx] = CAN_Sim_DecodeBitwise(&message->signals[idx], payloads[frame]);
+            if(reference[idx] != raw[idx])
+            {
+                result->mismatches++;
+            }
+        }
+    }
+    (void)sink;
+
+    return (0U == result->mismatches) ? CAN_E_OK : CAN_E_NOT_OK;
+}
+
+/* Time stamp counter of the host, 0 where there is none */
+static uint64_t CAN_Sim_Cycles(void)
+{
+#if defined(__x86_64__) && defined(__GNUC__)
+    uint32_t low;
+    uint32_t high;
+    __asm volatile ("rdtsc" : "=a" (low), "=d" (high));
+    return ((uint64_t)high << 32) | low;
+#else
+    return 0;
+#endif
+}
+
+/* Reference copies: each MB word assembled from four shifted bytes, and read again for every byte */
+static void CAN_Sim_WriteBytewise(volatile uint32_t* mb_data, const uint8_t* data, uint8_t length)
+{
+    for(uint8_t w_idx = 0; w_idx < (uint8_t)(length / 4U); w_idx++)
+    {
+        uint32_t data_word = 0;
+        for(uint8_t b_idx = 0; b_idx < 4U; b_idx++)
+        {
+            data_word |= (uint32_t)data[(w_idx * 4U) + b_idx] << (8U * (3U - b_idx));
+        }
+        mb_data[w_idx] = data_word;
+    }
+}
+
+static void CAN_Sim_ReadBytewise(const volatile uint32_t* mb_data, uint8_t* data, uint8_t length)
+{
+    for(uint8_t idx = 0; idx < length; idx++)
+    {
+        data[idx] = (uint8_t)(mb_data[idx / 4U] >> (8U * (3U - (idx % 4U))));
+    }
+}
+
+Std_CAN_Status CAN_Sim_CopyBenchmark(uint8_t length, uint32_t num_frames, CAN_Sim_CopyBench_type* result)
+{
+    static uint8_t payloads[64][CAN_MAX_PAYLOAD_BYTES];
+    volatile uint32_t mb_data[CAN_MAX_PAYLOAD_BYTES / 4U];
+    uint8_t data[CAN_MAX_PAYLOAD_BYTES];
+    uint8_t num_words = (uint8_t)(length / 4U);
+    volatile uint32_t sink = 0;
+    uint32_t seed = 0x12345678U;
+    uint64_t cycles;
+    clock_t start;
+
+    memset(result, 0, sizeof(*result));
+    if((0U == length) || (length > CAN_MAX_PAYLOAD_BYTES) || (0U != (length % 4U)) || (0U == num_frames))
+    {
+        return CAN_E_NOT_OK;
+    }
+    for(uint8_t frame = 0; frame < 64U; frame++)
+    {
+        for(uint8_t byte = 0; byte < CAN_MAX_PAYLOAD_BYTES; byte++)
+        {
+            seed = (seed * 1103515245U) + 12345U;
+            payloads[frame][byte] = (uint8_t)(seed >> 16);
+        }
+    }
+
+    start = clock();
+    cycles = CAN_Sim_Cycles();
+    for(uint32_t frame = 0; frame < num_frames; frame++)
+    {
+        CAN_Sim_WriteBytewise(mb_data, payloads[frame % 64U], length);
+        CAN_Sim_ReadBytewise(mb_data, data, length);
+        sink += data[frame % length];
+    }
+    result->bytewise_cycles = (CAN_Sim_Cycles() - cycles) / num_frames;
+    result->bytewise_ns = (uint64_t)(((double)(clock() - start) * 1e9) / ((double)CLOCKS_PER_SEC * num_frames));
+
+    start = clock();
+    cycles = CAN_Sim_Cycles();
+    for(uint32_t frame = 0; frame < num_frames; frame++)
+    {
+        CAN_Sim_WritePayload(mb_data, payloads[frame % 64U], num_words);
+        CAN_Sim_ReadPayload(mb_data, data, num_words);
+        sink += data[frame % length];
+    }
+    result->wordwise_cycles = (CAN_Sim_Cycles() - cycles) / num_frames;
+    result->wordwise_ns = (uint64_t)(((double)(clock() - start) * 1e9) / ((double)CLOCKS_PER_SEC * num_frames));
+    result->frames = num_frames;
+
+    /* Each kernel reads back what the other one wrote */
+    for(uint8_t frame = 0; frame < 64U; frame++)
+    {
+        CAN_Sim_WritePayload(mb_data, payloads[frame], num_words);
+        CAN_Sim_ReadBytewise(mb_data, data, length);
+        result->mismatches += (0 != memcmp(data, payloads[frame], length)) ? 1U : 0U;
+        CAN_Sim_WriteBytewise(mb_data, payloads[frame], length);
+        CAN_Sim_ReadPayload(mb_data, data, num_words);
+        result->mismatches += (0 != memcmp(data, payloads[frame], length)) ? 1U : 0U;
+    }
+    (void)sink;
+
+    return (0U == result->mismatches) ? CAN_E_OK : CAN_E_NOT_OK;
+}
+
+Std_CAN_Status CAN_Sim_CyclicBenchmark(CAN_Cyclic_type* cyclic, CAN_Handle_type* rx_handle, uint32_t duration_us,
+                                       uint32_t call_period_us, uint32_t window_us, CAN_Sim_CyclicBench_type* result)
+{
+    static CAN_Frame_type rx_frames[CAN_RX_RING_SIZE];
+    uint64_t last_rx_ps[CAN_CYCLIC_MAX_MESSAGES] = {0};
+    uint64_t start_ps = CAN_sim_time_ps;
+    uint64_t end_ps = start_ps + ((uint64_t)duration_us * 1000000U);
+    uint64_t next_call_ps = start_ps;
+    uint64_t window_ps = (uint64_t)window_us * 1000000U;
+    uint64_t window_start_ps = start_ps;
+    uint64_t window_busy_ps = 0;
+    uint64_t peak_busy_ps = 0;
+    uint64_t busy_start_ps = CAN_sim_busy_ps;
+
+    memset(result, 0, sizeof(*result));
+    while(CAN_sim_time_ps < end_ps)
+    {
+        uint64_t busy_before_ps = CAN_sim_busy_ps;
+
+        if(CAN_sim_time_ps >= next_call_ps)
+        {
+            CAN_Cyclic_MainFunction(cyclic, (uint32_t)(CAN_sim_time_ps / 1000000U));
+            next_call_ps += (uint64_t)call_period_us * 1000000U;
+        }
+        if(!CAN_Sim_Step())
+        {
+            /* Idle bus until the next scheduler call */
+            if(next_call_ps > CAN_sim_time_ps)
+            {
+                CAN_sim_time_ps = next_call_ps;
+            }
+            continue;
+        }
+
+        /* Bus load per window, a frame crossing a window end is split */
+        uint64_t frame_start_ps = CAN_sim_time_ps - (CAN_sim_busy_ps - busy_before_ps);
+        while(frame_start_ps < CAN_sim_time_ps)
+        {
+            if(frame_start_ps >= (window_start_ps + window_ps))
+            {
+                if(window_busy_ps > peak_busy_ps)
+                {
+                    peak_busy_ps = window_busy_ps;
+                }
+                window_busy_ps = 0;
+                window_start_ps += window_ps;
+                continue;
+            }
+            uint64_t part_end_ps = (CAN_sim_time_ps < (window_start_ps + window_ps)) ? CAN_sim_time_ps : (window_start_ps + window_ps);
+            window_busy_ps += part_end_ps - frame_start_ps;
+            frame_start_ps = part_end_ps;
+        }
+
+        uint16_t num_rx = CAN_ReceiveBatch(rx_handle, rx_frames, CAN_RX_RING_SIZE);
+        for(uint16_t frame = 0; frame < num_rx; frame++)
+        {
+            for(uint8_t idx = 0; idx < cyclic->num_messages; idx++)
+            {
+                const CAN_CyclicMsgConfig_type* config = cyclic->messages[idx].config;
+                if(config->id == rx_frames[frame].id)
+                {
+                    if(0U != last_rx_ps[idx])
+                    {
+                        uint64_t interval_ps = CAN_sim_time_ps - last_rx_ps[idx];
+                        uint64_t period_ps = (uint64_t)config->period_us * 1000000U;
+                        uint32_t jitter_us = (uint32_t)(((interval_ps > period_ps) ? (interval_ps - period_ps)
+                                                                                   : (period_ps - interval_ps)) / 1000000U);
+                        if(jitter_us > result->max_jitter_us[idx])
+                        {
+                            result->max_jitter_us[idx] = jitter_us;
+                        }
+                        if(jitter_us > result->max_jitter_all_us)
+                        {
+                            result->max_jitter_all_us = jitter_us;
+                        }
+                    }
+                    last_rx_ps[idx] = CAN_sim_time_ps;
+                    result->frames++;
+                    break;
+                }
+            }
+        }
+    }
+    if(window_busy_ps > peak_busy_ps)
+    {
+        peak_busy_ps = window_busy_ps;
+    }
+
+    result->peak_load_permille = (uint16_t)((0U != window_ps) ? ((peak_busy_ps * 1000U) / window_ps) : 0U);
+    result->avg_load_permille = (uint16_t)(((CAN_sim_busy_ps - busy_start_ps) * 1000U) / (CAN_sim_time_ps - start_ps));
+
+    return (0U != result->frames) ? CAN_E_OK : CAN_E_NOT_OK;
+}
+
+#endif /* CAN_SIM */
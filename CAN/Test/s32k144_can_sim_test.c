@@ -0,0 +1,577 @@
+/**
+ * @file s32k144_can_sim_test.c
+ * @brief Host test and benchmark runner of the CAN driver on the FlexCAN register model.
+ *
+ * Every test builds its controllers on a fresh virtual bus (CAN_Sim_Reset), checks the driver through
+ * its public API and the registers of the model, and counts failed checks. The benchmarks then print
+ * their measurements and check only their own consistency. Built and run by the Makefile next to it.
+ *
+ * Register accesses are counted on an x86-64 Linux host: the registers of a RAM image controller sit
+ * alone on mapped pages, which are protected, and every instruction touching them is single stepped.
+ *
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*******************************************************************************
+ * Inclusion
+ ******************************************************************************/
+
+#if defined(__linux__) && defined(__x86_64__)
+#define _GNU_SOURCE /* REG_EFL of ucontext_t */
+#define CAN_TEST_ACCESS_TRAP (1)
+#else
+#define CAN_TEST_ACCESS_TRAP (0)
+#endif
+
+#include "../src/Driver/CAN/Include/s32k144_can_sim.h"
+#include "../src/Driver/CAN/Include/s32k144_can_capture.h"
+#include "../src/Driver/CAN/Include/s32k144_can_filter.h"
+#include "../src/Driver/CAN/Include/s32k144_can_gateway.h"
+#include <stdio.h>
+#include <string.h>
+#if CAN_TEST_ACCESS_TRAP
+#include <signal.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+#endif
+
+/*******************************************************************************
+ * Macro
+ ******************************************************************************/
+
+/* Counts a failed check and reports it, the test goes on */
+#define CAN_TEST_CHECK(cond)                                                   \
+    do                                                                         \
+    {                                                                          \
+        CAN_test_checks++;                                                     \
+        if(!(cond))                                                            \
+        {                                                                      \
+            CAN_test_failures++;                                               \
+            printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);           \
+        }                                                                      \
+    } while(0)
+
+#define CAN_TEST_IDLE_STEP (5000U) /* Bit times the idle bus advances TIMER between two main function calls */
+#define CAN_TEST_EFLAGS_TF (0x100)  /* x86 trap flag: a debug exception after the next instruction */
+
+typedef struct
+{
+    uint32_t scan_send;   /* Register accesses of a send searching the CS words for a free Tx MB, as before the free map */
+    uint32_t idle_send;   /* Register accesses of CAN_Transmit loading a free Tx MB */
+    uint32_t queued_send; /* Register accesses of CAN_Transmit queueing behind busy Tx MBs */
+    uint32_t tx_done_irq; /* Register accesses of CAN_IRQHandler for one Tx completion loading the next queued frame */
+} CAN_Test_AccessBench_type;
+
+/*******************************************************************************
+* Variables
+******************************************************************************/
+
+static uint32_t CAN_test_checks;
+static uint32_t CAN_test_failures;
+
+static CAN_Handle_type CAN_test_handles[CAN_INSTANCE_COUNT];
+static CAN_Bit_Timing_type CAN_test_bit_rate = {500000U, 2000000U, 0U, 0U, 0U, NULL};
+
+#if CAN_TEST_ACCESS_TRAP
+static uint8_t* CAN_test_trap_start = NULL; /* Register pages, protected while accesses are counted */
+static size_t CAN_test_trap_size = 0;
+static uint8_t CAN_test_trap_active = 0;
+static volatile uint32_t CAN_test_trap_count = 0;
+static struct sigaction CAN_test_trap_old_segv;
+static struct sigaction CAN_test_trap_old_trap;
+#endif
+
+/*******************************************************************************
+* Code
+******************************************************************************/
+
+/* Initialises and attaches a CAN 2.0 controller at 500 kbit/s, the lower half of its MBs receiving rx_id */
+static void CAN_Test_OpenInstance(CAN_Handle_type* can_handle, CAN_Type* can_instance, uint8_t operate_mode,
+                                  uint8_t id_type, uint32_t rx_id)
+{
+    CAN_Config_type config;
+
+    memset(&config, 0, sizeof(config));
+    config.can_instance = can_instance;
+    config.operate_mode = operate_mode;
+    config.bit_rate_config = &CAN_test_bit_rate;
+    config.can_mode = CAN20;
+    config.clock_source = BUS_CLOCK;
+    config.bit_rate_sw = DISBALE_BRS;
+    config.rx_identifier = rx_id;
+    config.payload = PAYLOAD_8_BYTES;
+    config.id_type = id_type;
+    CAN_TEST_CHECK(CAN_E_OK == CAN_Init(can_handle, &config));
+    CAN_TEST_CHECK(CAN_E_OK == CAN_Sim_Attach(can_handle));
+}
+
+static void CAN_Test_Open(uint8_t idx, uint8_t operate_mode, uint8_t id_type, uint32_t rx_id)
+{
+    static CAN_Type* const instances[CAN_INSTANCE_COUNT] = {CAN0, CAN1, CAN2};
+
+    CAN_Test_OpenInstance(&CAN_test_handles[idx], instances[idx], operate_mode, id_type, rx_id);
+}
+
+/* Accepts the identifiers lo to hi of one format */
+static void CAN_Test_Filter(uint8_t idx, uint32_t lo, uint32_t hi, uint8_t id_type)
+{
+    CAN_FilterEntry_type entry[1] = {CAN_FILTER_RANGE(lo, hi)};
+    CAN_FilterTable_type table;
+    uint8_t num_individual;
+    uint8_t num_shared;
+
+    CAN_Filter_GetCapacity(&CAN_test_handles[idx], &num_individual, &num_shared);
+    CAN_TEST_CHECK(CAN_E_OK == CAN_Filter_Compile(entry, 1U, id_type, num_individual, num_shared, &table));
+    CAN_TEST_CHECK(CAN_E_OK == CAN_Filter_Apply(&CAN_test_handles[idx], &table));
+}
+
+/* Idle bus time on CAN0: the model advances TIMER only with frames */
+static void CAN_Test_IdleCan0(uint32_t bits, void (*main_function)(void* context), void* context)
+{
+    for(uint32_t elapsed = 0; elapsed < bits; elapsed += CAN_TEST_IDLE_STEP)
+    {
+        CAN0->TIMER = (CAN0->TIMER + CAN_TEST_IDLE_STEP) & CAN_TIMER_TIMER_MASK;
+        if(NULL != main_function)
+        {
+            main_function(context);
+        }
+    }
+}
+
+static void CAN_Test_TxLimitMain(void* context)
+{
+    CAN_TxLimitMainFunction((CAN_Handle_type*)context);
+}
+
+static void CAN_Test_CaptureMain(void* context)
+{
+    CAN_Capture_MainFunction((CAN_Capture_type*)context);
+}
+
+static void CAN_Test_Transfer(void)
+{
+    CAN_Sim_Bench_type result;
+
+    CAN_Sim_Reset();
+    CAN_Test_Open(0U, NORMAL_MODE, STARDADARD_ID, 0x123U);
+    CAN_Test_Open(1U, NORMAL_MODE, STARDADARD_ID, 0x100U);
+    CAN_TEST_CHECK(CAN_E_OK == CAN_Sim_Benchmark(&CAN_test_handles[0], &CAN_test_handles[1], 0x100U, 8U, 1000U, &result));
+    CAN_TEST_CHECK(result.frames_received == result.frames_sent);
+    printf("  1000 frames of 8 bytes: %u frames/s, latency avg %llu ns max %llu ns, host %llu ns/frame\n",
+           (unsigned)result.frames_per_second, (unsigned long long)result.avg_latency_ns,
+           (unsigned long long)result.max_latency_ns, (unsigned long long)result.host_ns_per_frame);
+}
+
+/* An idle gap over a TIMER wrap refills the buckets only through CAN_TxLimitMainFunction */
+static void CAN_Test_TxLimitWrap(void)
+{
+    CAN_TxLimit_type limit = {0x100U, 0x7FFU, 0U, TX_LIMIT_DROP, 10U, 111U};
+    CAN_TxLimitStats_type stats;
+    uint8_t data[8] = {0};
+
+    CAN_Sim_Reset();
+    CAN_Test_Open(0U, NORMAL_MODE, STARDADARD_ID, 0x123U);
+    CAN_Test_Open(1U, NORMAL_MODE, STARDADARD_ID, 0x100U);
+    CAN_TEST_CHECK(CAN_E_OK == CAN_SetTxLimits(&CAN_test_handles[0], &limit, 1U));
+
+    /* 1 % of 70000 bit times refills the burst of one 111 bit frame */
+    CAN_TEST_CHECK(CAN_E_OK == CAN_Transmit(&CAN_test_handles[0], 0x100U, data, 8U));
+    (void)CAN_Sim_Run(10U);
+    CAN_Test_IdleCan0(70000U, CAN_Test_TxLimitMain, &CAN_test_handles[0]);
+    (void)CAN_Transmit(&CAN_test_handles[0], 0x100U, data, 8U);
+    (void)CAN_Sim_Run(10U);
+    CAN_TEST_CHECK(CAN_E_OK == CAN_GetTxLimitStats(&CAN_test_handles[0], 0U, &stats));
+    CAN_TEST_CHECK((2U == stats.passed) && (0U == stats.dropped));
+
+    /* Without it the wrap is lost and the frame dropped */
+    CAN_Test_IdleCan0(70000U, NULL, NULL);
+    (void)CAN_Transmit(&CAN_test_handles[0], 0x100U, data, 8U);
+    (void)CAN_Sim_Run(10U);
+    CAN_TEST_CHECK(CAN_E_OK == CAN_GetTxLimitStats(&CAN_test_handles[0], 0U, &stats));
+    CAN_TEST_CHECK((2U == stats.passed) && (1U == stats.dropped));
+}
+
+/* A controller initialised again leaves no mode bit or mask of its last mode, CAN_Reconfigure follows */
+static void CAN_Test_OperateMode(void)
+{
+    CAN_Reconfig_type listen_only = {LISTEN_ONLY_MODE, NULL, DISBALE_BRS};
+    CAN_Reconfig_type normal = {NORMAL_MODE, NULL, DISBALE_BRS};
+    CAN_Frame_type frame;
+    uint8_t data[8] = {0};
+    uint8_t num_rx = 0;
+
+    CAN_Sim_Reset();
+    CAN_Test_Open(0U, LISTEN_ONLY_MODE, STARDADARD_ID, 0x123U);
+    CAN_TEST_CHECK((0U != (CAN0->CTRL1 & CAN_CTRL1_LOM_MASK)) && (0U != (CAN0->CTRL2 & CAN_CTRL2_EACEN_MASK)));
+    CAN_TEST_CHECK((0U == CAN0->RXMGMASK) && (0U == CAN0->RXIMR[0]));
+
+    CAN_Test_Open(0U, NORMAL_MODE, STARDADARD_ID, 0x123U);
+    CAN_Test_Open(1U, NORMAL_MODE, STARDADARD_ID, 0x100U);
+    CAN_TEST_CHECK(0U == (CAN0->CTRL1 & (CAN_CTRL1_LOM_MASK | CAN_CTRL1_LPB_MASK)));
+    CAN_TEST_CHECK(0U == (CAN0->CTRL2 & CAN_CTRL2_EACEN_MASK));
+    CAN_TEST_CHECK((0xFFFFFFFFU == CAN0->RXMGMASK) && (0xFFFFFFFFU == CAN0->RX14MASK) && (0xFFFFFFFFU == CAN0->RX15MASK)
+                && (0xFFFFFFFFU == CAN0->RXFGMASK) && (0xFFFFFFFFU == CAN0->RXIMR[CAN0_MB_COUNT - 1U]));
+    (void)CAN_Transmit(&CAN_test_handles[1], 0x123U, data, 8U);
+    (void)CAN_Transmit(&CAN_test_handles[1], 0x124U, data, 8U);
+    (void)CAN_Sim_Run(10U);
+    while(CAN_E_OK == CAN_TryReceive(&CAN_test_handles[0], &frame))
+    {
+        num_rx++;
+    }
+    CAN_TEST_CHECK(1U == num_rx);
+
+    CAN_TEST_CHECK(CAN_E_OK == CAN_Reconfigure(&CAN_test_handles[0], &listen_only));
+    CAN_TEST_CHECK((0U != (CAN0->CTRL2 & CAN_CTRL2_EACEN_MASK)) && (0U == CAN0->RXIMR[0]));
+    CAN_TEST_CHECK(CAN_E_OK == CAN_Reconfigure(&CAN_test_handles[0], &normal));
+    CAN_TEST_CHECK((0U == (CAN0->CTRL2 & CAN_CTRL2_EACEN_MASK)) && (0xFFFFFFFFU == CAN0->RXIMR[0]));
+}
+
+/* Wraps over an idle bus reach the capture stream through CAN_Capture_MainFunction */
+static void CAN_Test_CaptureWrap(void)
+{
+    static uint32_t buffer[256];
+    static uint8_t stream[1024];
+    CAN_Capture_type capture;
+    CAN_CaptureDecoder_type decoder = {0U, 0U};
+    CAN_CaptureFrame_type frame;
+    uint32_t timestamps[2] = {0U, 0U};
+    uint32_t offset = 0;
+    uint32_t size;
+    uint8_t num_frames = 0;
+    uint8_t data[8] = {0};
+
+    CAN_Sim_Reset();
+    CAN_Test_Open(0U, LISTEN_ONLY_MODE, STARDADARD_ID, 0x7FFU);
+    CAN_Test_Open(1U, NORMAL_MODE, STARDADARD_ID, 0x7FFU);
+    CAN_TEST_CHECK(CAN_E_OK == CAN_Capture_Init(&capture, &CAN_test_handles[0], buffer, 256U));
+
+    (void)CAN_Transmit(&CAN_test_handles[1], 0x100U, data, 8U);
+    (void)CAN_Sim_Run(10U);
+    CAN_Test_IdleCan0(200000U, CAN_Test_CaptureMain, &capture);
+    (void)CAN_Transmit(&CAN_test_handles[1], 0x101U, data, 8U);
+    (void)CAN_Sim_Run(10U);
+
+    size = CAN_Capture_Read(&capture, stream, sizeof(stream));
+    while((num_frames < 2U) && (CAN_E_OK == CAN_Capture_Decode(&decoder, stream, size, &offset, &frame)))
+    {
+        timestamps[num_frames++] = frame.timestamp;
+    }
+    CAN_TEST_CHECK(2U == num_frames);
+    /* The idle time plus one frame of at most 135 bits */
+    CAN_TEST_CHECK(((timestamps[1] - timestamps[0]) >= 200000U) && ((timestamps[1] - timestamps[0]) <= 200135U));
+    CAN_Capture_DeInit(&capture);
+}
+
+/* Extended frames take the routes of their own format only */
+static void CAN_Test_GatewayExtended(void)
+{
+    static CAN_Gateway_type gateway;
+    const CAN_GatewayRoute_type routes[2] =
+    {
+        {0U, 0x2U, 0U, 0x000U, 0x000U, 0U, 0U, 0U},
+        {0U, 0x2U, 0U, 0x1ABC000U, 0x1FFFF000U, 0x1FFFF000U, 0x0DEF000U, CAN_FRAME_FLAG_IDE},
+    };
+    CAN_Gateway_Config_type config = {{&CAN_test_handles[0], &CAN_test_handles[1], &CAN_test_handles[2]}, routes, 2U, NULL};
+    CAN_GatewayRouteStats_type stats;
+    CAN_Frame_type frame;
+    uint8_t num_rx = 0;
+
+    CAN_Sim_Reset();
+    CAN_Test_Open(0U, NORMAL_MODE, EXTENDED_ID, 0U);
+    CAN_Test_Open(1U, NORMAL_MODE, EXTENDED_ID, 0U);
+    CAN_Test_Open(2U, NORMAL_MODE, EXTENDED_ID, 0U);
+    CAN_Test_Filter(0U, 0x1ABC000U, 0x1ABCFFFU, EXTENDED_ID);
+    CAN_Test_Filter(1U, 0x7F0U, 0x7FFU, STARDADARD_ID);
+    CAN_Test_Filter(2U, 0x0DEF000U, 0x0DEFFFFU, EXTENDED_ID);
+    CAN_TEST_CHECK(CAN_E_OK == CAN_Gateway_Init(&gateway, &config));
+
+    memset(&frame, 0, sizeof(frame));
+    frame.dlc = 8U;
+    frame.flags = CAN_FRAME_FLAG_IDE;
+    for(uint8_t idx = 0; idx < 5U; idx++)
+    {
+        frame.id = 0x1ABC000U + idx;
+        CAN_TEST_CHECK(CAN_E_OK == CAN_Sim_Inject(&frame, CAN_MB_CS_IDE_MASK));
+    }
+    (void)CAN_Sim_Run(100U);
+    while(CAN_E_OK == CAN_TryReceive(&CAN_test_handles[2], &frame))
+    {
+        CAN_TEST_CHECK((0x0DEF000U == (frame.id & 0x1FFFF000U)) && (0U != (frame.flags & CAN_FRAME_FLAG_IDE)));
+        num_rx++;
+    }
+    CAN_TEST_CHECK(5U == num_rx);
+    CAN_Gateway_GetRouteStats(&gateway, 0U, &stats);
+    CAN_TEST_CHECK(0U == stats.matched);
+    CAN_Gateway_GetRouteStats(&gateway, 1U, &stats);
+    CAN_TEST_CHECK((5U == stats.matched) && (5U == stats.completed));
+    CAN_Gateway_DeInit(&gateway);
+}
+
+#ifdef CAN_STATS_ENABLE
+static void CAN_Test_StatsMain(void* context)
+{
+    CAN_StatsMainFunction((CAN_Handle_type*)context);
+}
+
+/* The bus load window spans idle gaps over TIMER wraps through CAN_StatsMainFunction */
+static void CAN_Test_StatsWrap(void)
+{
+    CAN_StatsSnapshot_type snapshot;
+    uint8_t data[8] = {0};
+
+    CAN_Sim_Reset();
+    CAN_Test_Open(0U, NORMAL_MODE, STARDADARD_ID, 0x123U);
+    CAN_Test_Open(1U, NORMAL_MODE, STARDADARD_ID, 0x100U);
+    CAN_ResetStats(&CAN_test_handles[0]);
+    (void)CAN_Transmit(&CAN_test_handles[0], 0x100U, data, 8U);
+    (void)CAN_Sim_Run(10U);
+    CAN_Test_IdleCan0(200000U, CAN_Test_StatsMain, &CAN_test_handles[0]);
+    CAN_GetStatsSnapshot(&CAN_test_handles[0], &snapshot);
+    CAN_TEST_CHECK(snapshot.bus_ticks >= 200000U);
+    CAN_TEST_CHECK(snapshot.bus_load_permille <= 1U);
+}
+#endif
+
+#if CAN_TEST_ACCESS_TRAP
+/* First access of an instruction to a protected page: counted, the pages open up for this one instruction */
+static void CAN_Test_TrapFault(int sig, siginfo_t* info, void* context)
+{
+    ucontext_t* uc = (ucontext_t*)context;
+    uint8_t* address = (uint8_t*)info->si_addr;
+
+    (void)sig;
+    if((address < CAN_test_trap_start) || (address >= (CAN_test_trap_start + CAN_test_trap_size)))
+    {
+        /* Not a register access: fault again with the previous action */
+        (void)sigaction(SIGSEGV, &CAN_test_trap_old_segv, NULL);
+        return;
+    }
+    CAN_test_trap_count++;
+    (void)mprotect(CAN_test_trap_start, CAN_test_trap_size, PROT_READ | PROT_WRITE);
+    uc->uc_mcontext.gregs[REG_EFL] |= CAN_TEST_EFLAGS_TF;
+}
+
+/* The instruction is done: protect the pages again */
+static void CAN_Test_TrapStep(int sig, siginfo_t* info, void* context)
+{
+    ucontext_t* uc = (ucontext_t*)context;
+
+    (void)sig;
+    (void)info;
+    (void)mprotect(CAN_test_trap_start, CAN_test_trap_size, PROT_NONE);
+    uc->uc_mcontext.gregs[REG_EFL] &= ~(greg_t)CAN_TEST_EFLAGS_TF;
+}
+
+/* The model touches the registers uncounted, the accesses are what the hardware sees instead */
+static void CAN_Test_TrapModelHook(uint8_t active, uint32_t accesses)
+{
+    if(CAN_test_trap_active)
+    {
+        CAN_test_trap_count += accesses;
+        (void)mprotect(CAN_test_trap_start, CAN_test_trap_size, active ? (PROT_READ | PROT_WRITE) : PROT_NONE);
+    }
+}
+
+/* Starts counting the accesses to the register pages */
+static void CAN_Test_TrapBegin(void)
+{
+    struct sigaction action;
+
+    memset(&action, 0, sizeof(action));
+    action.sa_flags = SA_SIGINFO;
+    action.sa_sigaction = CAN_Test_TrapFault;
+    (void)sigaction(SIGSEGV, &action, &CAN_test_trap_old_segv);
+    action.sa_sigaction = CAN_Test_TrapStep;
+    (void)sigaction(SIGTRAP, &action, &CAN_test_trap_old_trap);
+    CAN_test_trap_count = 0;
+    CAN_test_trap_active = 1;
+    CAN_Sim_SetModelHook(CAN_Test_TrapModelHook);
+    (void)mprotect(CAN_test_trap_start, CAN_test_trap_size, PROT_NONE);
+}
+
+/* Stops counting, returns the accesses since CAN_Test_TrapBegin */
+static uint32_t CAN_Test_TrapEnd(void)
+{
+    (void)mprotect(CAN_test_trap_start, CAN_test_trap_size, PROT_READ | PROT_WRITE);
+    CAN_Sim_SetModelHook(NULL);
+    CAN_test_trap_active = 0;
+    (void)sigaction(SIGSEGV, &CAN_test_trap_old_segv, NULL);
+    (void)sigaction(SIGTRAP, &CAN_test_trap_old_trap, NULL);
+    return CAN_test_trap_count;
+}
+
+/* Reference send: searches the CS words for an inactive Tx MB and loads it with byte shifts and one
+   read-modify-write per CS field between two IFLAG1 writes, the way the first driver version did */
+static uint8_t CAN_Test_ScanSend(const CAN_Handle_type* can_handle, uint32_t id, const uint8_t* data, uint8_t length)
+{
+    CAN_Type* CANx = can_handle->can_instance;
+    uint8_t idx_mb = 0;
+
+    while((idx_mb < can_handle->num_msg_buff)
+       && (CAN_MB_CODE_TX_INACTIVE != ((CANx->RAMn[can_handle->mb_map.mb_base[idx_mb]] & CAN_MB_CS_CODE_MASK) >> CAN_MB_CS_CODE_SHIFT)))
+    {
+        idx_mb++;
+    }
+    if(idx_mb >= can_handle->num_msg_buff)
+    {
+        return 0;
+    }
+
+    uint32_t base = can_handle->mb_map.mb_base[idx_mb];
+    CANx->IFLAG1 = (uint32_t)(1UL << idx_mb);
+    CANx->RAMn[base + 1U] = id << CAN_WMBn_CS_STD_ID_SHIFT;
+    for(uint8_t w_idx = 0; w_idx < (uint8_t)((length + 3U) / 4U); w_idx++)
+    {
+        uint32_t data_word = 0;
+        for(uint8_t b_idx = 0; b_idx < 4U; b_idx++)
+        {
+            uint8_t data_idx = (uint8_t)((w_idx * 4U) + b_idx);
+            data_word |= (uint32_t)((data_idx < length) ? data[data_idx] : 0U) << (8U * (3U - b_idx));
+        }
+        CANx->RAMn[base + 2U + w_idx] = data_word;
+    }
+    CANx->RAMn[base] |= (uint32_t)length << CAN_MB_CS_DLC_SHIFT;
+    CANx->RAMn[base] |= CAN_MB_CS_SRR_MASK;
+    CANx->RAMn[base] |= (uint32_t)CAN_MB_CODE_TX_DATA << CAN_MB_CS_CODE_SHIFT;
+    CANx->IFLAG1 = (uint32_t)(1UL << idx_mb);
+
+    return 1;
+}
+
+/* Counts the register and MB RAM accesses of one send before and after the free Tx MB map, a load and a
+   store of a read-modify-write separately; IFLAG1 writes count as one. tx_handle runs on the trapped pages */
+static uint8_t CAN_Test_CountAccesses(CAN_Handle_type* tx_handle, uint32_t id, uint8_t length, CAN_Test_AccessBench_type* result)
+{
+    static uint8_t saved[sizeof(CAN_Type)];
+    CAN_Type* CANx = tx_handle->can_instance;
+    uint8_t data[8] = {0x11U, 0x22U, 0x33U, 0x44U, 0x55U, 0x66U, 0x77U, 0x88U};
+    uint32_t next_id = id + 1U;
+    uint8_t sent = 0;
+
+    /* The reference loads an MB behind the back of the driver, the registers are restored afterwards */
+    memcpy(saved, (const void*)CANx, sizeof(saved));
+    CAN_Test_TrapBegin();
+    sent = CAN_Test_ScanSend(tx_handle, id, data, length);
+    result->scan_send = CAN_Test_TrapEnd();
+    memcpy((void*)CANx, saved, sizeof(saved));
+
+    CAN_Test_TrapBegin();
+    sent &= (CAN_E_OK == CAN_Transmit(tx_handle, id, data, length));
+    result->idle_send = CAN_Test_TrapEnd();
+
+    /* Every Tx MB busy and a frame waiting in the queue. Identifiers count up: equal ones would wait for
+       each other and a higher ranked one would abort a loaded frame */
+    for(uint8_t idx = 0; sent && (0U == tx_handle->tx_queue.count) && (idx < CAN_MAX_MSG_BUFF); idx++)
+    {
+        sent = (CAN_E_OK == CAN_Transmit(tx_handle, next_id++, data, length));
+    }
+    CAN_Test_TrapBegin();
+    sent &= (CAN_E_OK == CAN_Transmit(tx_handle, next_id++, data, length));
+    result->queued_send = CAN_Test_TrapEnd();
+
+    /* One frame completes with the interrupt held back, its handler then runs counted. A frame received
+       meanwhile, e.g. by self reception, waits for the next step */
+    uint32_t primask = CAN_CRITICAL_ENTER();
+    while((0U == (CANx->IFLAG1 & tx_handle->tx_mb_mask)) && CAN_Sim_Step())
+    {
+        /* DO NOTHING */
+    }
+    uint32_t imask = CANx->IMASK1;
+    CANx->IMASK1 = imask & tx_handle->tx_mb_mask;
+    CAN_CRITICAL_EXIT(primask);
+    CAN_Test_TrapBegin();
+    CAN_IRQHandler(tx_handle);
+    result->tx_done_irq = CAN_Test_TrapEnd();
+    CANx->IMASK1 = imask;
+
+    while(((0U != tx_handle->tx_queue.count) || (tx_handle->tx_free_map != tx_handle->tx_mb_mask)) && CAN_Sim_Step())
+    {
+        /* DO NOTHING */
+    }
+
+    return sent && (tx_handle->tx_free_map == tx_handle->tx_mb_mask);
+}
+
+static void CAN_Test_AccessBench(void)
+{
+    static CAN_Handle_type image_handle;
+    CAN_Test_AccessBench_type result;
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t size = (sizeof(CAN_Type) + page - 1U) & ~(page - 1U);
+    /* Pages holding nothing but the registers of one RAM image controller */
+    void* pages = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    CAN_TEST_CHECK(MAP_FAILED != pages);
+    if(MAP_FAILED == pages)
+    {
+        return;
+    }
+    CAN_test_trap_start = (uint8_t*)pages;
+    CAN_test_trap_size = size;
+
+    CAN_Sim_Reset();
+    CAN_Sim_ResetRegs((CAN_Type*)pages);
+    CAN_Test_OpenInstance(&image_handle, (CAN_Type*)pages, NORMAL_MODE, STARDADARD_ID, 0x123U);
+    CAN_Test_Open(1U, NORMAL_MODE, STARDADARD_ID, 0x100U);
+    memset(&result, 0, sizeof(result));
+    CAN_TEST_CHECK(CAN_Test_CountAccesses(&image_handle, 0x100U, 8U, &result));
+    CAN_TEST_CHECK((0U != result.idle_send) && (result.idle_send < result.scan_send));
+    printf("  register accesses per send: scan %u, free map %u, queued %u, Tx done IRQ %u\n",
+           (unsigned)result.scan_send, (unsigned)result.idle_send, (unsigned)result.queued_send,
+           (unsigned)result.tx_done_irq);
+
+    CAN_Sim_Reset();
+    (void)munmap(pages, size);
+}
+#else
+static void CAN_Test_AccessBench(void)
+{
+    printf("  register access counting needs an x86-64 Linux host\n");
+}
+#endif
+
+static void CAN_Test_CopyBench(void)
+{
+    static const uint8_t lengths[4] = {8U, 16U, 32U, 64U};
+    CAN_Sim_CopyBench_type result;
+
+    for(uint8_t idx = 0; idx < 4U; idx++)
+    {
+        CAN_TEST_CHECK(CAN_E_OK == CAN_Sim_CopyBenchmark(lengths[idx], 200000U, &result));
+        CAN_TEST_CHECK(0U == result.mismatches);
+        printf("  payload copy %2u bytes: byte loops %llu ns, word kernels %llu ns per frame\n", (unsigned)lengths[idx],
+               (unsigned long long)result.bytewise_ns, (unsigned long long)result.wordwise_ns);
+    }
+}
+
+static void CAN_Test_Run(const char* name, void (*test)(void))
+{
+    uint32_t failures = CAN_test_failures;
+
+    printf("%s\n", name);
+    test();
+    printf("  %s\n", (failures == CAN_test_failures) ? "ok" : "FAILED");
+}
+
+int main(void)
+{
+    CAN_Test_Run("transfer", CAN_Test_Transfer);
+    CAN_Test_Run("tx limit over a TIMER wrap", CAN_Test_TxLimitWrap);
+    CAN_Test_Run("operate mode bits and masks", CAN_Test_OperateMode);
+    CAN_Test_Run("capture over a TIMER wrap", CAN_Test_CaptureWrap);
+    CAN_Test_Run("gateway extended routes", CAN_Test_GatewayExtended);
+#ifdef CAN_STATS_ENABLE
+    CAN_Test_Run("stats over a TIMER wrap", CAN_Test_StatsWrap);
+#endif
+    CAN_Test_Run("register access benchmark", CAN_Test_AccessBench);
+    CAN_Test_Run("payload copy benchmark", CAN_Test_CopyBench);
+
+    printf("%u checks, %u failed\n", (unsigned)CAN_test_checks, (unsigned)CAN_test_failures);
+
+    return (0U == CAN_test_failures) ? 0 : 1;
+}